@@ -10,6 +10,8 @@ public class SlashTarget : TargetRules
 		Type = TargetType.Game;
 		DefaultBuildSettings = BuildSettingsVersion.V2;
 
+		bWithPushModel = true;
+
 		ExtraModuleNames.AddRange( new string[] { "Slash" } );
 	}
 }
@@ -5,6 +5,12 @@
 #include "GeometryCollection/GeometryCollectionComponent.h"
 #include "Items/Treasure.h"
 #include "Components/CapsuleComponent.h"
+#include "World/StreamingDormancySubsystem.h"
+#include "World/SlashSaveSubsystem.h"
+#include "World/CombatAssetSubsystem.h"
+#include "World/AreaDamageSubsystem.h"
+#include "World/SlashRandomSubsystem.h"
+#include "Slash/SlashStats.h"
 
 // Sets default values
 ABreakableActor::ABreakableActor()
@@ -12,6 +18,10 @@ ABreakableActor::ABreakableActor()
 
 	PrimaryActorTick.bCanEverTick = false;
 
+	// placed in the level and never moves; only a break or a streamed-in destroy needs sending
+	bReplicates = true;
+	NetDormancy = DORM_Initial;
+
 	GeometryCollection = CreateDefaultSubobject<UGeometryCollectionComponent >( TEXT( "GeometryCollection" ) );
 	SetRootComponent( GeometryCollection );
 	GeometryCollection->SetGenerateOverlapEvents( true );
@@ -27,7 +37,67 @@ ABreakableActor::ABreakableActor()
 void ABreakableActor::BeginPlay()
 {
 	Super::BeginPlay();
-} 
+
+	// already smashed the last time this cell was loaded
+	USlashSaveSubsystem* Save = USlashSaveSubsystem::Get( this );
+	if ( Save && Save->WasRemoved( this ) )
+	{
+		Destroy( );
+		return;
+	}
+
+	Dormancy = GetWorld( )->GetSubsystem<UStreamingDormancySubsystem>( );
+	if ( Dormancy )
+	{
+		Dormancy->RegisterBreakable( this );
+	}
+
+	if ( UCombatAssetSubsystem* CombatAssets = GetWorld( )->GetSubsystem<UCombatAssetSubsystem>( ) )
+	{
+		CombatAssets->AcquireBundle( this );
+	}
+
+	if ( UAreaDamageSubsystem* AreaDamage = GetWorld( )->GetSubsystem<UAreaDamageSubsystem>( ) )
+	{
+		AreaDamage->RegisterTarget( this );
+	}
+}
+
+void ABreakableActor::EndPlay( const EEndPlayReason::Type EndPlayReason )
+{
+	if ( Dormancy )
+	{
+		Dormancy->UnregisterBreakable( this );
+	}
+	if ( UCombatAssetSubsystem* CombatAssets = GetWorld( )->GetSubsystem<UCombatAssetSubsystem>( ) )
+	{
+		CombatAssets->ReleaseBundle( this );
+	}
+	if ( UAreaDamageSubsystem* AreaDamage = GetWorld( )->GetSubsystem<UAreaDamageSubsystem>( ) )
+	{
+		AreaDamage->UnregisterTarget( this );
+	}
+
+	Super::EndPlay( EndPlayReason );
+}
+
+void ABreakableActor::SetDormant( bool bDormant )
+{
+	// once broken the pieces belong to the physics solver, leave them alone
+	if ( bBroken && bDormant ) return;
+
+	bIsDormant = bDormant;
+	GeometryCollection->SetGenerateOverlapEvents( !bDormant );
+	GeometryCollection->SetComponentTickEnabled( !bDormant );
+}
+
+void ABreakableActor::GatherCombatAssets( TArray<FSoftObjectPath>& OutAssets ) const
+{
+	for ( const TSubclassOf<ATreasure>& TreasureClass : TreasureClasses )
+	{
+		AddCombatAssetsOf( OutAssets, TreasureClass );
+	}
+}
 
 void ABreakableActor::Tick(float DeltaTime)
 {
@@ -36,17 +106,24 @@ void ABreakableActor::Tick(float DeltaTime)
 
 void ABreakableActor::GetHit_Implementation( const FVector& ImpactPoint )
 {
+	SLASH_SCOPE_CYCLE_COUNTER( STAT_SlashBreakableGetHit );
 	if ( bBroken ) return;
 	bBroken = true;
 
+	if ( USlashSaveSubsystem* Save = USlashSaveSubsystem::Get( this ) )
+	{
+		Save->RecordRemoved( this );
+	}
+
 	UWorld* World = GetWorld( );
 	if ( World && TreasureClasses.Num() > 0)
 	{
 		FVector Location = GetActorLocation( );
 		Location.Z += 75.f;
 
-		int32 selection = FMath::RandRange( 0, TreasureClasses.Num( ) - 1 );
+		int32 selection = USlashRandomSubsystem::GetStream( this, ESlashRandomStream::ESRS_Loot ).RandRange( 0, TreasureClasses.Num( ) - 1 );
 		World->SpawnActor<ATreasure>( TreasureClasses[selection], Location, GetActorRotation( ) );
+		INC_DWORD_STAT( STAT_SlashTreasuresSpawned );
 	}
 }
 
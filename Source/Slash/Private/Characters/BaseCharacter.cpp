@@ -5,7 +5,16 @@
 #include "Components/BoxComponent.h"
 #include "Items/Weapons/Weapon.h"
 #include "Components/AttributeComponent.h"
+#include "Characters/HitDirection.h"
 #include <Kismet/GameplayStatics.h>
+#include "World/CombatAssetSubsystem.h"
+#include "World/AreaDamageSubsystem.h"
+#include "World/FootPlacementSubsystem.h"
+#include "Animation/AnimMontage.h"
+#include "Sound/SoundBase.h"
+#include "Particles/ParticleSystem.h"
+#include "Net/UnrealNetwork.h"
+#include "Slash/SlashStats.h"
 
 ABaseCharacter::ABaseCharacter()
 { 
@@ -17,75 +26,110 @@ ABaseCharacter::ABaseCharacter()
 void ABaseCharacter::BeginPlay()
 {
 	Super::BeginPlay();
-	
+
+	if ( UCombatAssetSubsystem* CombatAssets = GetWorld( )->GetSubsystem<UCombatAssetSubsystem>( ) )
+	{
+		CombatAssets->AcquireBundle( this );
+	}
+
+	RegisterWithSubsystems( );
 }
 
-void ABaseCharacter::Attack( )
+void ABaseCharacter::EndPlay( const EEndPlayReason::Type EndPlayReason )
 {
+	if ( UCombatAssetSubsystem* CombatAssets = GetWorld( )->GetSubsystem<UCombatAssetSubsystem>( ) )
+	{
+		CombatAssets->ReleaseBundle( this );
+	}
+	UnregisterFromSubsystems( );
 
+	Super::EndPlay( EndPlayReason );
 }
 
-void ABaseCharacter::Die( )
+void ABaseCharacter::RegisterWithSubsystems( )
 {
+	if ( UAreaDamageSubsystem* AreaDamage = GetWorld( )->GetSubsystem<UAreaDamageSubsystem>( ) )
+	{
+		AreaDamage->RegisterTarget( this );
+	}
 
+	UFootPlacementSubsystem* FootPlacement = GetWorld( )->GetSubsystem<UFootPlacementSubsystem>( );
+	if ( FootPlacement && bFootPlacement )
+	{
+		FootPlacement->RegisterCharacter( this, LeftFootSocket, RightFootSocket );
+	}
 }
 
-void ABaseCharacter::PlayHitReactMontage( const FName SectionName )
+void ABaseCharacter::UnregisterFromSubsystems( )
 {
-	UAnimInstance* AnimInstance = GetMesh( )->GetAnimInstance( );
-	if ( AnimInstance && HitReactMontage )
+	if ( UAreaDamageSubsystem* AreaDamage = GetWorld( )->GetSubsystem<UAreaDamageSubsystem>( ) )
+	{
+		AreaDamage->UnregisterTarget( this );
+	}
+	if ( UFootPlacementSubsystem* FootPlacement = GetWorld( )->GetSubsystem<UFootPlacementSubsystem>( ) )
 	{
-		AnimInstance->Montage_Play( HitReactMontage );
-		AnimInstance->Montage_JumpToSection( SectionName, HitReactMontage );
+		FootPlacement->UnregisterCharacter( this );
 	}
 }
 
-void ABaseCharacter::DirectionalHitReact( const FVector& ImpactPoint )
+void ABaseCharacter::GatherCombatAssets( TArray<FSoftObjectPath>& OutAssets ) const
 {
-	const FVector Forward = GetActorForwardVector( );
-	// lower impact point to the enemy's ActorLocation.Z
-	const FVector ImpactLowered( ImpactPoint.X, ImpactPoint.Y, GetActorLocation( ).Z );
-	const FVector ToHit = (ImpactLowered - GetActorLocation( )).GetSafeNormal( ); // normalized 
+	AddCombatAsset( OutAssets, AttackMontage.ToSoftObjectPath( ) );
+	AddCombatAsset( OutAssets, HitReactMontage.ToSoftObjectPath( ) );
+	AddCombatAsset( OutAssets, DeathMontage.ToSoftObjectPath( ) );
+	AddCombatAsset( OutAssets, HitSound.ToSoftObjectPath( ) );
+	AddCombatAsset( OutAssets, HitParticles.ToSoftObjectPath( ) );
+}
 
-	//Forward * ToHit = |Forward||ToHit|*cos(theta)
-	// |Forward| = 1, |ToHit| = 1, so Forward * ToHit = cos(theta)
-	const double CosTheta = FVector::DotProduct( Forward, ToHit );
-	// take the inverse cosine (arc-cosine) of cos(theta) to get theta
-	double Theta = FMath::Acos( CosTheta );
-	// convert from radians to degrees
-	Theta = FMath::RadiansToDegrees( Theta );
+void ABaseCharacter::GetLifetimeReplicatedProps( TArray<FLifetimeProperty>& OutLifetimeProps ) const
+{
+	Super::GetLifetimeReplicatedProps( OutLifetimeProps );
 
-	// if cross product points down, theta should be negative
-	const FVector CrossProduct = FVector::CrossProduct( Forward, ToHit );
-	if ( CrossProduct.Z < 0 )
-	{
-		Theta *= -1.f;
-	}
-	FName Section( "FromBack" );
+	DOREPLIFETIME( ABaseCharacter, EquippedWeapon );
+}
 
-	if ( Theta >= -45.f && Theta < 45.f )
-	{
-		Section = ("FromFront");
-	}
-	else if ( Theta >= -135.f && Theta < -45.f )
+void ABaseCharacter::OnRep_EquippedWeapon( )
+{
+	if ( EquippedWeapon )
 	{
-		Section = ("FromLeft");
+		EquippedWeapon->Equip( GetMesh( ), FName( "RightHandSocket" ), this, this );
 	}
-	else if ( Theta >= 45.f && Theta < 135.f )
+}
+
+void ABaseCharacter::Attack( )
+{
+
+}
+
+void ABaseCharacter::Die( )
+{
+
+}
+
+void ABaseCharacter::PlayHitReactMontage( const FName SectionName )
+{
+	UAnimInstance* AnimInstance = GetMesh( )->GetAnimInstance( );
+	UAnimMontage* Montage = HitReactMontage.Get( );
+	if ( AnimInstance && Montage )
 	{
-		Section = ("FromRight");
+		AnimInstance->Montage_Play( Montage );
+		AnimInstance->Montage_JumpToSection( SectionName, Montage );
 	}
+}
 
-	PlayHitReactMontage( Section );
+void ABaseCharacter::DirectionalHitReact( EHitDirection Direction )
+{
+	SLASH_SCOPE_CYCLE_COUNTER( STAT_SlashDirectionalHitReact );
+	PlayHitReactMontage( HitDirection::GetSectionName( Direction ) );
 }
 
 void ABaseCharacter::PlayHitSound( const FVector& ImpactPoint )
 {
-	if ( HitSound )
+	if ( USoundBase* Sound = HitSound.Get( ) )
 	{
 		UGameplayStatics::PlaySoundAtLocation(
 			this,
-			HitSound,
+			Sound,
 			ImpactPoint
 		);
 	}
@@ -93,11 +137,12 @@ void ABaseCharacter::PlayHitSound( const FVector& ImpactPoint )
 
 void ABaseCharacter::SpawnJHitParticles( const FVector& ImpactPoint )
 {
-	if ( HitParticles )
+	SLASH_SCOPE_CYCLE_COUNTER( STAT_SlashSpawnHitParticles );
+	if ( UParticleSystem* Particles = HitParticles.Get( ) )
 	{
 		UGameplayStatics::SpawnEmitterAtLocation(
 			GetWorld( ),
-			HitParticles,
+			Particles,
 			ImpactPoint
 		);
 	}
@@ -123,7 +168,7 @@ bool ABaseCharacter::CanAttack( )
 
 bool ABaseCharacter::IsAlive( )
 {
-	return Attributes && Attributes->IsAlive( ) 
+	return Attributes && Attributes->IsAlive( );
 }
 
 void ABaseCharacter::AttackEnd( )
@@ -0,0 +1,26 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Characters/ComboWindowNotifyState.h"
+#include "Characters/SlashCharacter.h"
+#include "Components/SkeletalMeshComponent.h"
+
+void UComboWindowNotifyState::NotifyBegin( USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, float TotalDuration, const FAnimNotifyEventReference& EventReference )
+{
+	Super::NotifyBegin( MeshComp, Animation, TotalDuration, EventReference );
+
+	if ( ASlashCharacter* Character = MeshComp ? Cast<ASlashCharacter>( MeshComp->GetOwner( ) ) : nullptr )
+	{
+		Character->SetComboWindowOpen( true );
+	}
+}
+
+void UComboWindowNotifyState::NotifyEnd( USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, const FAnimNotifyEventReference& EventReference )
+{
+	if ( ASlashCharacter* Character = MeshComp ? Cast<ASlashCharacter>( MeshComp->GetOwner( ) ) : nullptr )
+	{
+		Character->SetComboWindowOpen( false );
+	}
+
+	Super::NotifyEnd( MeshComp, Animation, EventReference );
+}
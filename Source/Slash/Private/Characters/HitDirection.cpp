@@ -0,0 +1,39 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Characters/HitDirection.h"
+#include "Async/ParallelFor.h"
+
+namespace HitDirection
+{
+	static constexpr int32 HitsPerTask = 256;
+
+	void Classify( TConstArrayView<FVector> Forwards, TConstArrayView<FVector> Locations, TConstArrayView<FVector> ImpactPoints, TArrayView<EHitDirection> OutDirections )
+	{
+		const int32 NumHits = OutDirections.Num( );
+		check( Forwards.Num( ) == NumHits && Locations.Num( ) == NumHits && ImpactPoints.Num( ) == NumHits );
+
+		const int32 NumTasks = FMath::DivideAndRoundUp( NumHits, HitsPerTask );
+		ParallelFor( NumTasks, [&]( int32 TaskIndex )
+		{
+			const int32 First = TaskIndex * HitsPerTask;
+			const int32 Last = FMath::Min( First + HitsPerTask, NumHits );
+			for ( int32 Index = First; Index < Last; ++Index )
+			{
+				OutDirections[Index] = Classify( Forwards[Index], Locations[Index], ImpactPoints[Index] );
+			}
+		}, NumTasks > 1 ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread );
+	}
+
+	const FName& GetSectionName( EHitDirection Direction )
+	{
+		static const FName SectionNames[] =
+		{
+			FName( "FromFront" ),
+			FName( "FromLeft" ),
+			FName( "FromRight" ),
+			FName( "FromBack" )
+		};
+		return SectionNames[static_cast<uint8>( Direction )];
+	}
+}
@@ -0,0 +1,27 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Characters/InvulnerabilityNotifyState.h"
+#include "Characters/BaseCharacter.h"
+#include "Components/SkeletalMeshComponent.h"
+
+void UInvulnerabilityNotifyState::NotifyBegin( USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, float TotalDuration, const FAnimNotifyEventReference& EventReference )
+{
+	Super::NotifyBegin( MeshComp, Animation, TotalDuration, EventReference );
+
+	if ( ABaseCharacter* Character = MeshComp ? Cast<ABaseCharacter>( MeshComp->GetOwner( ) ) : nullptr )
+	{
+		Character->SetInvulnerable( true );
+	}
+}
+
+void UInvulnerabilityNotifyState::NotifyEnd( USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, const FAnimNotifyEventReference& EventReference )
+{
+	// also runs when the montage is interrupted, so the window can't get stuck open
+	if ( ABaseCharacter* Character = MeshComp ? Cast<ABaseCharacter>( MeshComp->GetOwner( ) ) : nullptr )
+	{
+		Character->SetInvulnerable( false );
+	}
+
+	Super::NotifyEnd( MeshComp, Animation, EventReference );
+}
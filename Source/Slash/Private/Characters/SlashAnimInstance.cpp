@@ -15,7 +15,7 @@ void USlashAnimInstance::NativeInitializeAnimation( )
 	{
 		SlashCharacterMovement = SlashCharacter->GetCharacterMovement( );
 	}
-	 
+	FootPlacement = GetWorld( ) ? GetWorld( )->GetSubsystem<UFootPlacementSubsystem>( ) : nullptr;
 }
 
 void USlashAnimInstance::NativeUpdateAnimation( float DeltaTime )
@@ -28,4 +28,11 @@ void USlashAnimInstance::NativeUpdateAnimation( float DeltaTime )
 		 IsFalling = SlashCharacterMovement->IsFalling( ); 
 		 CharacterState = SlashCharacter->GetCharacterState( );
 	}
+
+	// any character's anim blueprint can parent to this for the ground data, not just the player's
+	const ACharacter* Character = Cast<ACharacter>( TryGetPawnOwner( ) );
+	if ( FootPlacement == nullptr || !FootPlacement->GetFootGround( Character, LeftFootGround, RightFootGround ) )
+	{
+		LeftFootGround = RightFootGround = FSlashFootGround( );
+	}
 }
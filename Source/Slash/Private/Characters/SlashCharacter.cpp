@@ -6,13 +6,23 @@
 #include "Components/InputComponent.h"
 #include "EnhancedInputComponent.h"
 #include "EnhancedInputSubsystems.h"
-#include "GameFramework/SpringArmComponent.h"
+#include "Components/SlashSpringArmComponent.h"
 #include "Camera/CameraComponent.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "Items/Item.h"
 #include "Items/Weapons/Weapon.h"
 #include "Animation/AnimMontage.h"
 #include "Components/BoxComponent.h"
+#include "World/SlashRandomSubsystem.h"
+#include "World/SlashReplaySubsystem.h"
+#include "World/LagCompensationSubsystem.h"
+#include "World/SlashSaveSubsystem.h"
+#include "World/CombatAssetSubsystem.h"
+#include "Components/AttributeComponent.h"
+#include "Components/LockOnComponent.h"
+#include "Components/CameraOcclusionComponent.h"
+#include "Characters/ComboGraph.h"
+#include "Net/UnrealNetwork.h"
 
 // Sets default values
 ASlashCharacter::ASlashCharacter():
@@ -29,12 +39,15 @@ ASlashCharacter::ASlashCharacter():
 	GetCharacterMovement( )->bOrientRotationToMovement = true;
 	GetCharacterMovement( )->RotationRate = FRotator( 0.f, 400.f, 0.f );
 
-	CameraBoom = CreateDefaultSubobject<USpringArmComponent>( TEXT( "CameraBoom" ) );
+	CameraBoom = CreateDefaultSubobject<USlashSpringArmComponent>( TEXT( "CameraBoom" ) );
 	CameraBoom->SetupAttachment( GetRootComponent( ) );
 	CameraBoom->TargetArmLength = 300.f;
 
 	ViewCamera = CreateDefaultSubobject<UCameraComponent>( TEXT( "ViewCamera" ) );
 	ViewCamera->SetupAttachment( CameraBoom );
+
+	LockOn = CreateDefaultSubobject<ULockOnComponent>( TEXT( "LockOn" ) );
+	CameraOcclusion = CreateDefaultSubobject<UCameraOcclusionComponent>( TEXT( "CameraOcclusion" ) );
 }
 
 void ASlashCharacter::BeginPlay()
@@ -43,6 +56,27 @@ void ASlashCharacter::BeginPlay()
 
 	Tags.Add( FName( "SlashCharacter" ) );
 
+	Replay = GetWorld( )->GetSubsystem<USlashReplaySubsystem>( );
+
+	// client hits are judged against where both sides were on the attacker's screen
+	if ( HasAuthority( ) && GetNetMode( ) != NM_Standalone )
+	{
+		if ( ULagCompensationSubsystem* LagCompensation = GetWorld( )->GetSubsystem<ULagCompensationSubsystem>( ) )
+		{
+			LagCompensation->RegisterActor( this );
+		}
+	}
+
+	// actions are held back until the montages are in, so a swing never starts without its notifies
+	if ( UCombatAssetSubsystem* CombatAssets = GetWorld( )->GetSubsystem<UCombatAssetSubsystem>( ) )
+	{
+		CombatAssets->AcquireBundle( this, FSimpleDelegate::CreateUObject( this, &ASlashCharacter::OnCombatAssetsLoaded ) );
+	}
+	else
+	{
+		bCombatAssetsLoaded = true;
+	}
+
 	// == my code to limit camera pitch ==
 	APlayerController* PlayerController = Cast<APlayerController>( GetController( ) );
 	if ( PlayerController )
@@ -60,10 +94,93 @@ void ASlashCharacter::BeginPlay()
 	// =====================================
 }
 
+void ASlashCharacter::EndPlay( const EEndPlayReason::Type EndPlayReason )
+{
+	// a level reload shouldn't take the player's health and weapon with it
+	USlashSaveSubsystem* Save = USlashSaveSubsystem::Get( this );
+	if ( Save && EndPlayReason != EEndPlayReason::Destroyed && HasAuthority( ) && IsLocallyControlled( ) )
+	{
+		Save->CapturePlayer( this );
+	}
+	if ( ULagCompensationSubsystem* LagCompensation = GetWorld( )->GetSubsystem<ULagCompensationSubsystem>( ) )
+	{
+		LagCompensation->UnregisterActor( this );
+	}
+
+	Super::EndPlay( EndPlayReason );
+}
+
+void ASlashCharacter::PossessedBy( AController* NewController )
+{
+	Super::PossessedBy( NewController );
+
+	if ( NewController && NewController->IsLocalPlayerController( ) )
+	{
+		RestoreSavedState( );
+	}
+}
+
+void ASlashCharacter::RestoreSavedState( )
+{
+	USlashSaveSubsystem* Save = USlashSaveSubsystem::Get( this );
+	const FSlashPlayerSaveData* PlayerData = Save ? Save->GetPlayerData( ) : nullptr;
+	if ( PlayerData == nullptr ) return;
+
+	if ( Attributes && PlayerData->Health > 0.f )
+	{
+		Attributes->SetHealth( PlayerData->Health );
+	}
+
+	UCombatAssetSubsystem* CombatAssets = GetWorld( )->GetSubsystem<UCombatAssetSubsystem>( );
+	if ( CombatAssets && EquippedWeapon == nullptr && !PlayerData->WeaponClass.IsEmpty( ) )
+	{
+		const FSoftObjectPath WeaponPath( PlayerData->WeaponClass );
+		CombatAssets->LoadAsync( WeaponPath, FStreamableDelegate::CreateUObject( this, &ASlashCharacter::EquipSavedWeapon, WeaponPath ) );
+	}
+}
+
+void ASlashCharacter::EquipSavedWeapon( FSoftObjectPath WeaponPath )
+{
+	// a weapon picked up while the class was loading wins
+	UClass* WeaponClass = TSoftClassPtr<AWeapon>( WeaponPath ).Get( );
+	if ( WeaponClass == nullptr || EquippedWeapon ) return;
+
+	AWeapon* Weapon = GetWorld( )->SpawnActorDeferred<AWeapon>( WeaponClass, GetActorTransform( ), this, this, ESpawnActorCollisionHandlingMethod::AlwaysSpawn );
+	Weapon->PrepareForEquippedSpawn( );
+	Weapon->FinishSpawning( GetActorTransform( ) );
+	EquipWeapon( Weapon );
+}
+
+void ASlashCharacter::OnCombatAssetsLoaded( )
+{
+	bCombatAssetsLoaded = true;
+
+	// whatever was pressed while loading
+	ConsumeBufferedInput( );
+}
+
+void ASlashCharacter::GatherCombatAssets( TArray<FSoftObjectPath>& OutAssets ) const
+{
+	Super::GatherCombatAssets( OutAssets );
+
+	AddCombatAsset( OutAssets, EquipMontage.ToSoftObjectPath( ) );
+	AddCombatAsset( OutAssets, DodgeMontage.ToSoftObjectPath( ) );
+}
+
+void ASlashCharacter::GetLifetimeReplicatedProps( TArray<FLifetimeProperty>& OutLifetimeProps ) const
+{
+	Super::GetLifetimeReplicatedProps( OutLifetimeProps );
+
+	DOREPLIFETIME( ASlashCharacter, CharacterState );
+}
+
 void ASlashCharacter::Tick( float DeltaTime )
 {
 	Super::Tick( DeltaTime );
 
+	// normally started from EndAction or a combo window the moment the character frees up; this catches anything else
+	if ( !InputBuffer.HasAny( GetWorld( )->GetTimeSeconds( ), InputBufferTime ) ) return;
+	ConsumeBufferedInput( );
 }
 
 // Called to bind functionality to input
@@ -77,16 +194,19 @@ void ASlashCharacter::SetupPlayerInputComponent( UInputComponent* PlayerInputCom
 		EnhancedInputComponent->BindAction( LookAction, ETriggerEvent::Triggered, this, &ASlashCharacter::Look );
 		EnhancedInputComponent->BindAction( JumpAction, ETriggerEvent::Triggered, this, &ASlashCharacter::Jump );
 		EnhancedInputComponent->BindAction( EKeyAction, ETriggerEvent::Triggered, this, &ASlashCharacter::EKeyPressed );
-		EnhancedInputComponent->BindAction( AttackAction, ETriggerEvent::Triggered, this, &ASlashCharacter::Attack );
-		//EnhancedInputComponent->BindAction( DodgeAction, ETriggerEvent::Triggered, this, &ASlashCharacter::Dodge );
+		EnhancedInputComponent->BindAction( AttackAction, ETriggerEvent::Started, this, &ASlashCharacter::Attack );
+		EnhancedInputComponent->BindAction( LockOnAction, ETriggerEvent::Started, this, &ASlashCharacter::ToggleLockOn );
+		EnhancedInputComponent->BindAction( SwitchTargetAction, ETriggerEvent::Started, this, &ASlashCharacter::SwitchLockOnTarget );
+		EnhancedInputComponent->BindAction( DodgeAction, ETriggerEvent::Started, this, &ASlashCharacter::Dodge );
 	}
 }
 
 void ASlashCharacter::Move( const FInputActionValue& Value )
 {
-	if ( ActionState != EActionState::EAS_Unoccupied ) return;
-
 	const FVector2D MovementVector = Value.Get<FVector2D>( );
+	if ( !AcceptInput( ESlashInputAction::ESIA_Move, MovementVector ) ) return;
+
+	if ( ActionState != EActionState::EAS_Unoccupied ) return;
 
 	const FRotator Rotation = Controller->GetControlRotation( );
 	const FRotator YawRotation( 0.f, Rotation.Yaw, 0.f );
@@ -99,102 +219,335 @@ void ASlashCharacter::Move( const FInputActionValue& Value )
 
 void ASlashCharacter::Look( const FInputActionValue& Value )
 {
-	if ( ActionState != EActionState::EAS_Unoccupied ) return; 
-
 	const FVector2D LookAxisVector = Value.Get<FVector2D>( );
+	if ( !AcceptInput( ESlashInputAction::ESIA_Look, LookAxisVector ) ) return;
+
+	// while locked on the camera follows the target instead
+	if ( ActionState != EActionState::EAS_Unoccupied || LockOn->IsLocked( ) ) return; 
 
 	AddControllerPitchInput( LookAxisVector.Y );
 	AddControllerYawInput( LookAxisVector.X );
 }
 
+void ASlashCharacter::ToggleLockOn( )
+{
+	if ( !AcceptInput( ESlashInputAction::ESIA_LockOn ) ) return;
+
+	LockOn->ToggleLock( );
+}
+
+void ASlashCharacter::SwitchLockOnTarget( const FInputActionValue& Value )
+{
+	const float Direction = Value.Get<float>( );
+	if ( !AcceptInput( ESlashInputAction::ESIA_SwitchTarget, FVector2D( Direction, 0.f ) ) ) return;
+
+	LockOn->SwitchTarget( Direction );
+}
+
 void ASlashCharacter::Jump( )
 {
+	if ( !AcceptInput( ESlashInputAction::ESIA_Jump ) ) return;
+
 	Super::Jump( );
 }
 	 
 void ASlashCharacter::Attack( )
 {	
+	if ( !AcceptInput( ESlashInputAction::ESIA_Attack ) ) return;
+
 	Super::Attack( );
 
-	if ( CanAttack())
+	InputBuffer.Press( ESlashBufferedAction::ESBA_Attack, GetWorld( )->GetTimeSeconds( ) );
+	ConsumeBufferedInput( );
+}
+
+void ASlashCharacter::BeginAttack( int32 Node, FName SectionName )
+{
+	ComboNode = Node;
+	bComboWindowOpen = false;
+	AttackSection = SectionName;
+	PlayAttackMontage( );
+	ActionState = EActionState::EAS_Attacking;
+
+	if ( HasAuthority( ) )
+	{
+		MulticastPlayAttackSection( AttackSection );
+	}
+	else
 	{
-		PlayAttackMontage( );
-		ActionState = EActionState::EAS_Attacking;
+		ServerAttack( AttackSection );
 	}
 }
 
+/*
+*  the client picked the section; the server only checks it is the swing the combo graph allows from here
+*/
+void ASlashCharacter::ServerAttack_Implementation( FName SectionName )
+{
+	const int32 Node = GetNextComboNode( false );
+	if ( ComboGraph )
+	{
+		const FComboNode* Next = ComboGraph->GetNode( Node );
+		if ( Next == nullptr || Next->Section != SectionName )
+		{
+			RejectAction( );
+			return;
+		}
+	}
+	else if ( !CanAttack( ) )
+	{
+		RejectAction( );
+		return;
+	}
+
+	ComboNode = Node;
+	bComboWindowOpen = false;
+	AttackSection = SectionName;
+	PlayAttackSection( SectionName );
+	ActionState = EActionState::EAS_Attacking;
+	MulticastPlayAttackSection( SectionName );
+}
+
+void ASlashCharacter::MulticastPlayAttackSection_Implementation( FName SectionName )
+{
+	// the attacker and the server already started this swing themselves
+	if ( IsLocallyControlled( ) || HasAuthority( ) ) return;
+
+	PlayAttackSection( SectionName );
+}
+
+void ASlashCharacter::RequestHit( AActor* HitActor, const FVector& ImpactPoint )
+{
+	const ULagCompensationSubsystem* LagCompensation = GetWorld( )->GetSubsystem<ULagCompensationSubsystem>( );
+	const double ViewTime = LagCompensation ? LagCompensation->GetClientViewTime( ) : GetWorld( )->GetTimeSeconds( );
+	ServerRequestHit( HitActor, ImpactPoint, ViewTime );
+}
+
+/*
+*  judge the hit against where attacker and target were on the attacker's screen, not where they are on the server now
+*/
+void ASlashCharacter::ServerRequestHit_Implementation( AActor* HitActor, FVector_NetQuantize ImpactPoint, double ViewTime )
+{
+	if ( EquippedWeapon == nullptr || HitActor == nullptr || ActionState != EActionState::EAS_Attacking ) return;
+
+	// never ahead of the server; how far back it may go is capped by the recorded window
+	ViewTime = FMath::Min( ViewTime, GetWorld( )->GetTimeSeconds( ) );
+	const ULagCompensationSubsystem* LagCompensation = GetWorld( )->GetSubsystem<ULagCompensationSubsystem>( );
+	const FVector AttackerLocation = LagCompensation ? LagCompensation->GetLocationAtTime( this, ViewTime ) : GetActorLocation( );
+	const FVector TargetLocation = LagCompensation ? LagCompensation->GetLocationAtTime( HitActor, ViewTime ) : HitActor->GetActorLocation( );
+	if ( FVector::DistSquared( TargetLocation, AttackerLocation ) > FMath::Square( MaxHitDistance ) ) return;
+
+	EquippedWeapon->ApplyHit( HitActor, ImpactPoint );
+}
+
 bool ASlashCharacter::CanAttack( )
 {
-	return ActionState == EActionState::EAS_Unoccupied &&
+	return bCombatAssetsLoaded &&
+		ActionState == EActionState::EAS_Unoccupied &&
 		CharacterState != ECharacterState::ECS_Unequipped;
 }
 
 void ASlashCharacter::AttackEnd( )
 {
-	ActionState = EActionState::EAS_Unoccupied;
+	ComboNode = INDEX_NONE;
+	bComboWindowOpen = false;
+	EndAction( );
 }
 
 void ASlashCharacter::PlayAttackMontage( )
 {
 	Super::PlayAttackMontage( );
 
+	PlayAttackSection( AttackSection );
+}
+
+FName ASlashCharacter::PickRandomAttackSection( )
+{
+	const int32 Selection = USlashRandomSubsystem::GetStream( this, ESlashRandomStream::ESRS_Animation ).RandRange( 0, 1 );
+	return Selection == 0 ? FName( "Attack1" ) : FName( "Attack2" );
+}
+
+int32 ASlashCharacter::GetNextComboNode( bool bRequireWindow )
+{
+	if ( ComboGraph == nullptr ) return INDEX_NONE;
+	if ( CanAttack( ) ) return UComboGraph::EntryNode;
+	if ( ActionState != EActionState::EAS_Attacking || ( bRequireWindow && !bComboWindowOpen ) ) return INDEX_NONE;
+
+	const FComboNode* Current = ComboGraph->GetNode( ComboNode );
+	return Current ? Current->NextOnAttack : INDEX_NONE;
+}
+
+void ASlashCharacter::SetComboWindowOpen( bool bOpen )
+{
+	if ( bOpen == bComboWindowOpen || ActionState != EActionState::EAS_Attacking ) return;
+
+	bComboWindowOpen = bOpen;
+	if ( bOpen )
+	{
+		ConsumeBufferedInput( );
+	}
+}
+
+void ASlashCharacter::PlayAttackSection( FName SectionName )
+{
 	UAnimInstance* AnimInstance = GetMesh( )->GetAnimInstance( );
-	if ( AnimInstance && AttackMontage )
+	UAnimMontage* Montage = AttackMontage.Get( );
+	if ( AnimInstance && Montage )
 	{
-		AnimInstance->Montage_Play( AttackMontage );
-		const int32 Selection = FMath::RandRange( 0, 1 );
-		FName SectionName = FName( );
-		switch ( Selection )
-		{
-		case 0:
-			SectionName = FName( "Attack1" );
-			break;
-		case 1:
-			SectionName = FName( "Attack2" );
-			break;
-		default:
-			break;
-		}
-		AnimInstance->Montage_JumpToSection( SectionName, AttackMontage );
+		AnimInstance->Montage_Play( Montage );
+		AnimInstance->Montage_JumpToSection( SectionName, Montage );
+	}
+}
+
+void ASlashCharacter::ReplayInput( ESlashInputAction Action, const FVector2D& Value )
+{
+	switch ( Action )
+	{
+	case ESlashInputAction::ESIA_Move:
+		Move( FInputActionValue( Value ) );
+		break;
+	case ESlashInputAction::ESIA_Look:
+		Look( FInputActionValue( Value ) );
+		break;
+	case ESlashInputAction::ESIA_Jump:
+		Jump( );
+		break;
+	case ESlashInputAction::ESIA_Equip:
+		EKeyPressed( );
+		break;
+	case ESlashInputAction::ESIA_Attack:
+		Attack( );
+		break;
+	case ESlashInputAction::ESIA_LockOn:
+		ToggleLockOn( );
+		break;
+	case ESlashInputAction::ESIA_SwitchTarget:
+		SwitchLockOnTarget( FInputActionValue( Value.X ) );
+		break;
+	case ESlashInputAction::ESIA_Dodge:
+		Dodge( );
+		break;
+	default:
+		break;
 	}
 }
 
 void ASlashCharacter::EKeyPressed( )
 {
+	if ( !AcceptInput( ESlashInputAction::ESIA_Equip ) ) return;
+	if ( !HasAuthority( ) )
+	{
+		ServerEKeyPressed( );
+	}
+
 	AWeapon* OverlappingWeapon = Cast<AWeapon>( OverlappingItem );
 	if ( OverlappingWeapon )
 	{
-		OverlappingWeapon->Equip( GetMesh( ), FName( "RightHandSocket" ), this, this );
-		CharacterState = ECharacterState::ECS_EquippedOneHandedWeapon;
+		// a weapon placed in the level stays picked up across reloads
+		USlashSaveSubsystem* Save = USlashSaveSubsystem::Get( this );
+		if ( Save && HasAuthority( ) )
+		{
+			Save->RecordRemoved( OverlappingWeapon );
+		}
+		EquipWeapon( OverlappingWeapon );
 		OverlappingItem = nullptr;
-		EquippedWeapon = OverlappingWeapon;
 	}
 	else
 	{
 		if ( CanDisarm() )
 		{
-			PlayEqipMontage( FName("Disarm") );
-			CharacterState = ECharacterState::ECS_Unequipped;
-			ActionState = EActionState::EAS_EquippingWeapon;
+			BeginEquip( FName( "Disarm" ), ECharacterState::ECS_Unequipped );
 		}
 		else if ( CanArm( ) )
 		{
-			PlayEqipMontage( FName("Arm") );
-			CharacterState = ECharacterState::ECS_EquippedOneHandedWeapon;
-			ActionState = EActionState::EAS_EquippingWeapon;
+			BeginEquip( FName( "Arm" ), ECharacterState::ECS_EquippedOneHandedWeapon );
 		}
 	} 
 }
 
+void ASlashCharacter::ServerEKeyPressed_Implementation( )
+{
+	const EActionState PreviousActionState = ActionState;
+	const ECharacterState PreviousCharacterState = CharacterState;
+	EKeyPressed( );
+
+	// nothing to pick up, arm or disarm here; the owner may have started one anyway
+	if ( ActionState == PreviousActionState && CharacterState == PreviousCharacterState )
+	{
+		RejectAction( );
+	}
+}
+
+/*
+*  the montage's Arm/Disarm notify moves the weapon on every machine, so everyone has to play it
+*/
+void ASlashCharacter::BeginEquip( FName SectionName, ECharacterState NewState )
+{
+	PlayEqipMontage( SectionName );
+	CharacterState = NewState;
+	ActionState = EActionState::EAS_EquippingWeapon;
+
+	if ( HasAuthority( ) )
+	{
+		MulticastPlayEquipMontage( SectionName );
+	}
+}
+
+void ASlashCharacter::MulticastPlayEquipMontage_Implementation( FName SectionName )
+{
+	// the owner and the server already started it themselves
+	if ( IsLocallyControlled( ) || HasAuthority( ) ) return;
+
+	PlayEqipMontage( SectionName );
+	ActionState = EActionState::EAS_EquippingWeapon;
+}
+
+void ASlashCharacter::OnRep_CharacterState( )
+{
+	// mid Arm/Disarm the montage moves the weapon at the right moment; otherwise, e.g. for a late joiner, put it where the state says
+	if ( EquippedWeapon && ActionState != EActionState::EAS_EquippingWeapon )
+	{
+		EquippedWeapon->AttachMeshToSocket( GetMesh( ), GetWeaponSocket( ) );
+	}
+}
+
+void ASlashCharacter::OnRep_EquippedWeapon( )
+{
+	if ( EquippedWeapon )
+	{
+		EquippedWeapon->Equip( GetMesh( ), GetWeaponSocket( ), this, this );
+	}
+}
+
+FName ASlashCharacter::GetWeaponSocket( ) const
+{
+	return CharacterState == ECharacterState::ECS_Unequipped ? FName( "SpineSocket" ) : FName( "RightHandSocket" );
+}
+
+bool ASlashCharacter::AcceptInput( ESlashInputAction Action, const FVector2D& Value )
+{
+	// only this machine's own input is recorded or held back during a replay
+	return Replay == nullptr || !IsLocallyControlled( ) || Replay->AcceptInput( Action, Value );
+}
+
+void ASlashCharacter::EquipWeapon( AWeapon* Weapon )
+{
+	Weapon->Equip( GetMesh( ), FName( "RightHandSocket" ), this, this );
+	CharacterState = ECharacterState::ECS_EquippedOneHandedWeapon;
+	EquippedWeapon = Weapon;
+}
+
 bool ASlashCharacter::CanDisarm( )
 {
-	return ActionState == EActionState::EAS_Unoccupied &&
+	return bCombatAssetsLoaded &&
+		ActionState == EActionState::EAS_Unoccupied &&
 		CharacterState != ECharacterState::ECS_Unequipped;
 }
 
 bool ASlashCharacter::CanArm( )
 {
-	return ActionState == EActionState::EAS_Unoccupied &&
+	return bCombatAssetsLoaded &&
+		ActionState == EActionState::EAS_Unoccupied &&
 		CharacterState == ECharacterState::ECS_Unequipped &&
 		EquippedWeapon ;
 }
@@ -216,16 +569,195 @@ void ASlashCharacter::Arm( ) // attach sword to hand socket
 }
 
 void ASlashCharacter::FinishEquipping( )
+{
+	EndAction( );
+}
+
+void ASlashCharacter::EndAction( )
 {
 	ActionState = EActionState::EAS_Unoccupied;
+	ConsumeBufferedInput( );
+}
+
+void ASlashCharacter::Dodge( )
+{
+	if ( !AcceptInput( ESlashInputAction::ESIA_Dodge ) ) return;
+
+	InputBuffer.Press( ESlashBufferedAction::ESBA_Dodge, GetWorld( )->GetTimeSeconds( ) );
+	ConsumeBufferedInput( );
+}
+
+void ASlashCharacter::ConsumeBufferedInput( )
+{
+	const double Now = GetWorld( )->GetTimeSeconds( );
+
+	// the dodge goes first when both are waiting, so a follow-up swing never eats an escape
+	if ( InputBuffer.IsBuffered( ESlashBufferedAction::ESBA_Dodge, Now, InputBufferTime ) && CanDodge( ) )
+	{
+		InputBuffer.Consume( ESlashBufferedAction::ESBA_Dodge );
+		BeginDodge( );
+		return;
+	}
+
+	if ( !InputBuffer.IsBuffered( ESlashBufferedAction::ESBA_Attack, Now, InputBufferTime ) ) return;
+
+	if ( ComboGraph == nullptr )
+	{
+		if ( !CanAttack( ) ) return;
+		InputBuffer.Consume( ESlashBufferedAction::ESBA_Attack );
+		BeginAttack( INDEX_NONE, PickRandomAttackSection( ) );
+		return;
+	}
+
+	const int32 Node = GetNextComboNode( true );
+	if ( const FComboNode* Next = ComboGraph->GetNode( Node ) )
+	{
+		InputBuffer.Consume( ESlashBufferedAction::ESBA_Attack );
+		BeginAttack( Node, Next->Section );
+	}
+}
+
+void ASlashCharacter::BeginDodge( )
+{
+	// roll toward the stick, or straight ahead without input
+	const FVector InputDirection = GetLastMovementInputVector( ).GetSafeNormal2D( );
+	const FRotator Facing = InputDirection.IsNearlyZero( ) ? FRotator( 0.f, GetActorRotation( ).Yaw, 0.f ) : InputDirection.Rotation( );
+	StartDodge( Facing );
+
+	if ( HasAuthority( ) )
+	{
+		MulticastDodge( Facing );
+	}
+	else
+	{
+		ServerDodge( Facing );
+	}
+}
+
+bool ASlashCharacter::CanDodge( bool bRequireWindow ) const
+{
+	return bCombatAssetsLoaded &&
+		( ActionState == EActionState::EAS_Unoccupied || CanCancelIntoDodge( bRequireWindow ) ) &&
+		!GetCharacterMovement( )->IsFalling( ) &&
+		Attributes && Attributes->GetStamina( ) >= Attributes->GetDodgeCost( );
+}
+
+bool ASlashCharacter::CanCancelIntoDodge( bool bRequireWindow ) const
+{
+	if ( ComboGraph == nullptr || ActionState != EActionState::EAS_Attacking || ( bRequireWindow && !bComboWindowOpen ) ) return false;
+
+	const FComboNode* Current = ComboGraph->GetNode( ComboNode );
+	return Current && Current->bDodgeCancel;
+}
+
+void ASlashCharacter::StartDodge( const FRotator& Facing )
+{
+	if ( ActionState == EActionState::EAS_Attacking )
+	{
+		// cut the swing short: its collision window may never reach its closing notify
+		SetWeaponCollisionEnabled( ECollisionEnabled::NoCollision );
+		ComboNode = INDEX_NONE;
+		bComboWindowOpen = false;
+	}
+	SetActorRotation( Facing );
+	ActionState = EActionState::EAS_Dodge;
+
+	// simulated proxies only play the roll; the owner predicts the cost and the server's value replicates to it
+	if ( Attributes && GetLocalRole( ) != ROLE_SimulatedProxy )
+	{
+		Attributes->UseStamina( Attributes->GetDodgeCost( ) );
+	}
+	PlayDodgeMontage( );
+}
+
+void ASlashCharacter::ServerDodge_Implementation( FRotator Facing )
+{
+	if ( !CanDodge( false ) )
+	{
+		RejectAction( );
+		return;
+	}
+
+	StartDodge( Facing );
+	MulticastDodge( Facing );
+}
+
+void ASlashCharacter::RejectAction( )
+{
+	ClientRejectAction( ActionState, CharacterState, Attributes ? Attributes->GetStamina( ) : 0.f );
+}
+
+/*
+*  stops whatever the owner predicted and takes the server's state; the unchanged values never replicate on their own
+*/
+void ASlashCharacter::ClientRejectAction_Implementation( EActionState ServerActionState, ECharacterState ServerCharacterState, float ServerStamina )
+{
+	if ( ActionState != ServerActionState )
+	{
+		// set first, so the stopped dodge's end callback doesn't free the character and start a buffered action
+		ActionState = ServerActionState;
+		ComboNode = INDEX_NONE;
+		bComboWindowOpen = false;
+		SetWeaponCollisionEnabled( ECollisionEnabled::NoCollision );
+		SetInvulnerable( false );
+		if ( UAnimInstance* AnimInstance = GetMesh( )->GetAnimInstance( ) )
+		{
+			AnimInstance->Montage_Stop( 0.1f );
+		}
+	}
+
+	if ( CharacterState != ServerCharacterState )
+	{
+		CharacterState = ServerCharacterState;
+		OnRep_CharacterState( );
+	}
+
+	if ( Attributes )
+	{
+		Attributes->SetStamina( ServerStamina );
+	}
+}
+
+void ASlashCharacter::MulticastDodge_Implementation( FRotator Facing )
+{
+	// the dodger and the server already started it themselves
+	if ( IsLocallyControlled( ) || HasAuthority( ) ) return;
+
+	StartDodge( Facing );
+}
+
+void ASlashCharacter::PlayDodgeMontage( )
+{
+	UAnimInstance* AnimInstance = GetMesh( )->GetAnimInstance( );
+	UAnimMontage* Montage = DodgeMontage.Get( );
+	if ( AnimInstance == nullptr || Montage == nullptr )
+	{
+		EndAction( );
+		return;
+	}
+
+	AnimInstance->Montage_Play( Montage );
+	FOnMontageEnded EndDelegate;
+	EndDelegate.BindUObject( this, &ASlashCharacter::OnDodgeMontageEnded );
+	AnimInstance->Montage_SetEndDelegate( EndDelegate, Montage );
+}
+
+void ASlashCharacter::OnDodgeMontageEnded( UAnimMontage* Montage, bool bInterrupted )
+{
+	SetInvulnerable( false );
+	if ( ActionState == EActionState::EAS_Dodge )
+	{
+		EndAction( );
+	}
 }
 
 void ASlashCharacter::PlayEqipMontage( const FName SectionName )
 { 
 	UAnimInstance* AnimInstance = GetMesh( )->GetAnimInstance( );
-	if ( AnimInstance && EquipMontage )
+	UAnimMontage* Montage = EquipMontage.Get( );
+	if ( AnimInstance && Montage )
 	{
-		AnimInstance->Montage_Play( EquipMontage );
-		AnimInstance->Montage_JumpToSection( SectionName, EquipMontage );
+		AnimInstance->Montage_Play( Montage );
+		AnimInstance->Montage_JumpToSection( SectionName, Montage );
 	}
 }
\ No newline at end of file
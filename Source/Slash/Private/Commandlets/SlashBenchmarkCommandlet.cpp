@@ -0,0 +1,333 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Commandlets/SlashBenchmarkCommandlet.h"
+#include "Characters/SlashCharacter.h"
+#include "Enemy/Enemy.h"
+#include "Breakables/BreakableActor.h"
+#include "Items/Treasure.h"
+#include "Items/Weapons/Weapon.h"
+#include "World/SlashRandomSubsystem.h"
+#include "Interfaces/HitInterface.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerStart.h"
+#include "Kismet/GameplayStatics.h"
+#include "NavigationSystem.h"
+#include "EngineUtils.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Misc/App.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "HAL/FileManager.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+
+DEFINE_LOG_CATEGORY_STATIC( LogSlashBenchmark, Log, All );
+
+USlashBenchmarkCommandlet::USlashBenchmarkCommandlet( )
+{
+	LogToConsole = true;
+}
+
+int32 USlashBenchmarkCommandlet::Main( const FString& Params )
+{
+	FParse::Value( *Params, TEXT( "Map=" ), MapName );
+	FParse::Value( *Params, TEXT( "Enemies=" ), NumEnemies );
+	FParse::Value( *Params, TEXT( "Breakables=" ), NumBreakables );
+	FParse::Value( *Params, TEXT( "Treasures=" ), NumTreasures );
+	FParse::Value( *Params, TEXT( "Frames=" ), NumFrames );
+	FParse::Value( *Params, TEXT( "Warmup=" ), WarmupFrames );
+	FParse::Value( *Params, TEXT( "Seed=" ), RandomSeed );
+
+	FString Label = TEXT( "Unlabelled" );
+	FParse::Value( *Params, TEXT( "Label=" ), Label );
+
+	// same spawn layout and the same simulated time on every run
+	FMath::RandInit( RandomSeed );
+	FMath::SRandInit( RandomSeed );
+	FApp::SetUseFixedTimeStep( true );
+	FApp::SetFixedDeltaTime( FixedDeltaTime );
+	FApp::SetDeltaTime( FixedDeltaTime );
+
+	UWorld* World = LoadBenchmarkWorld( MapName );
+	if ( World == nullptr )
+	{
+		UE_LOG( LogSlashBenchmark, Error, TEXT( "Could not load map %s" ), *MapName );
+		return 1;
+	}
+
+	ASlashCharacter* Character = SpawnPlayer( World );
+	if ( Character == nullptr )
+	{
+		UE_LOG( LogSlashBenchmark, Error, TEXT( "Could not spawn the benchmark character" ) );
+		DestroyBenchmarkWorld( World );
+		return 1;
+	}
+
+	const FVector Center = Character->GetActorLocation( );
+	TArray<AActor*> Enemies;
+	TArray<AActor*> Breakables;
+	TArray<AActor*> Treasures;
+	SpawnActorsAround( World, Center, EnemyClass.TryLoadClass<AEnemy>( ), NumEnemies, 400.0, SpawnRadius, Enemies );
+	SpawnActorsAround( World, Center, BreakableClass.TryLoadClass<ABreakableActor>( ), NumBreakables, 200.0, SpawnRadius, Breakables );
+	SpawnActorsAround( World, Center, TreasureClass.TryLoadClass<ATreasure>( ), NumTreasures, 200.0, SpawnRadius, Treasures );
+
+	// combat bundles stream in after BeginPlay and the character holds its swings until they have; nothing else pumps async loading here
+	FlushAsyncLoading( );
+
+	UE_LOG( LogSlashBenchmark, Display, TEXT( "%s: %d enemies, %d breakables, %d treasures, %d + %d frames" ),
+		*MapName, Enemies.Num( ), Breakables.Num( ), Treasures.Num( ), WarmupFrames, NumFrames );
+
+	TArray<double> FrameTimes;
+	FrameTimes.Reserve( NumFrames );
+	double GCSeconds = 0.0;
+	int32 GCCount = 0;
+
+	// breakables are smashed one at a time across the measured frames so treasure spawns are spread out
+	const int32 BreakInterval = Breakables.Num( ) > 0 ? FMath::Max( NumFrames / Breakables.Num( ), 1 ) : 0;
+	int32 NextBreakable = 0;
+
+	const int32 TotalFrames = WarmupFrames + NumFrames;
+	for ( int32 Frame = 0; Frame < TotalFrames; ++Frame )
+	{
+		const bool bMeasuring = Frame >= WarmupFrames;
+
+#if CSV_PROFILER
+		if ( Frame == WarmupFrames )
+		{
+			FCsvProfiler::Get( )->BeginCapture( -1, FPaths::ProfilingDir( ) / TEXT( "CSV" ), FString::Printf( TEXT( "SlashBenchmark_%s.csv" ), *Label ) );
+		}
+		FCsvProfiler::Get( )->BeginFrame( );
+#endif
+
+		FApp::SetCurrentTime( FApp::GetCurrentTime( ) + FixedDeltaTime );
+		DriveCharacter( Character, Enemies );
+
+		if ( bMeasuring && BreakInterval > 0 && (Frame - WarmupFrames) % BreakInterval == 0 && Breakables.IsValidIndex( NextBreakable ) )
+		{
+			AActor* Breakable = Breakables[NextBreakable++];
+			if ( IsValid( Breakable ) )
+			{
+				IHitInterface::Execute_GetHit( Breakable, Breakable->GetActorLocation( ) );
+			}
+		}
+
+		const double FrameStart = FPlatformTime::Seconds( );
+		World->Tick( LEVELTICK_All, FixedDeltaTime );
+		const double FrameEnd = FPlatformTime::Seconds( );
+		++GFrameCounter;
+
+		if ( GCIntervalFrames > 0 && (Frame + 1) % GCIntervalFrames == 0 )
+		{
+			const double GCStart = FPlatformTime::Seconds( );
+			CollectGarbage( GARBAGE_COLLECTION_KEEPFLAGS );
+			if ( bMeasuring )
+			{
+				GCSeconds += FPlatformTime::Seconds( ) - GCStart;
+				++GCCount;
+			}
+		}
+
+#if CSV_PROFILER
+		FCsvProfiler::Get( )->EndFrame( );
+#endif
+
+		if ( bMeasuring )
+		{
+			FrameTimes.Add( FrameEnd - FrameStart );
+		}
+	}
+
+#if CSV_PROFILER
+	// the capture is written out on the next frame boundary
+	TSharedFuture<FString> CsvFile = FCsvProfiler::Get( )->EndCapture( );
+	FCsvProfiler::Get( )->BeginFrame( );
+	FCsvProfiler::Get( )->EndFrame( );
+	CsvFile.Wait( );
+#endif
+
+	WriteSummary( Label, FrameTimes, GCSeconds, GCCount );
+	DestroyBenchmarkWorld( World );
+	return 0;
+}
+
+UWorld* USlashBenchmarkCommandlet::LoadBenchmarkWorld( const FString& InMapName )
+{
+	UPackage* Package = LoadPackage( nullptr, *InMapName, LOAD_None );
+	UWorld* World = Package ? UWorld::FindWorldInPackage( Package ) : nullptr;
+	if ( World == nullptr ) return nullptr;
+
+	World->AddToRoot( );
+	World->WorldType = EWorldType::Game;
+
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext( EWorldType::Game );
+	WorldContext.SetCurrentWorld( World );
+
+	if ( !World->bIsWorldInitialized )
+	{
+		World->InitWorld( UWorld::InitializationValues( ).AllowAudioPlayback( false ).RequiresHitProxies( false ) );
+	}
+
+	if ( USlashRandomSubsystem* Random = World->GetSubsystem<USlashRandomSubsystem>( ) )
+	{
+		Random->SetMasterSeed( static_cast<int32>( RandomSeed ) );
+	}
+
+	const FURL URL;
+	World->SetGameMode( URL );
+	World->InitializeActorsForPlay( URL );
+	World->BeginPlay( );
+	return World;
+}
+
+void USlashBenchmarkCommandlet::DestroyBenchmarkWorld( UWorld* World )
+{
+	World->BeginTearingDown( );
+	for ( FActorIterator It( World ); It; ++It )
+	{
+		It->RouteEndPlay( EEndPlayReason::Quit );
+	}
+
+	GEngine->DestroyWorldContext( World );
+	World->DestroyWorld( false );
+	World->RemoveFromRoot( );
+	CollectGarbage( GARBAGE_COLLECTION_KEEPFLAGS );
+}
+
+ASlashCharacter* USlashBenchmarkCommandlet::SpawnPlayer( UWorld* World )
+{
+	UClass* Class = CharacterClass.TryLoadClass<ASlashCharacter>( );
+	if ( Class == nullptr )
+	{
+		Class = ASlashCharacter::StaticClass( );
+	}
+
+	const AActor* PlayerStart = UGameplayStatics::GetActorOfClass( World, APlayerStart::StaticClass( ) );
+	const FTransform SpawnTransform = PlayerStart ? PlayerStart->GetActorTransform( ) : FTransform( FVector( 0.f, 0.f, 200.f ) );
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+	ASlashCharacter* Character = World->SpawnActor<ASlashCharacter>( Class, SpawnTransform, SpawnParams );
+	if ( Character == nullptr ) return nullptr;
+
+	// a player controller so crowd, dormancy and pawn sensing see a viewer, but no local player or input
+	APlayerController* PlayerController = World->SpawnActor<APlayerController>( );
+	if ( PlayerController )
+	{
+		PlayerController->Possess( Character );
+	}
+
+	if ( UClass* WeaponClass = PlayerWeaponClass.TryLoadClass<AWeapon>( ) )
+	{
+		AWeapon* Weapon = World->SpawnActor<AWeapon>( WeaponClass, SpawnTransform );
+		if ( Weapon )
+		{
+			Character->EquipWeapon( Weapon );
+		}
+	}
+	return Character;
+}
+
+void USlashBenchmarkCommandlet::SpawnActorsAround( UWorld* World, const FVector& Center, UClass* ActorClass, int32 Count, double MinRadius, double MaxRadius, TArray<AActor*>& OutActors )
+{
+	if ( ActorClass == nullptr || Count <= 0 ) return;
+
+	const UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>( World );
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+	for ( int32 Index = 0; Index < Count; ++Index )
+	{
+		// uniform over the annulus, snapped onto the nav mesh when there is one
+		const double Angle = FMath::FRand( ) * 2.0 * PI;
+		const double Radius = FMath::Lerp( MinRadius, MaxRadius, FMath::Sqrt( FMath::FRand( ) ) );
+		FVector Location = Center + FVector( FMath::Cos( Angle ) * Radius, FMath::Sin( Angle ) * Radius, 0.0 );
+
+		FNavLocation NavLocation;
+		if ( NavSys && NavSys->ProjectPointToNavigation( Location, NavLocation ) )
+		{
+			Location = NavLocation.Location + FVector( 0.0, 0.0, 100.0 );
+		}
+
+		if ( AActor* Actor = World->SpawnActor<AActor>( ActorClass, Location, FRotator( 0.f, FMath::FRand( ) * 360.f, 0.f ), SpawnParams ) )
+		{
+			OutActors.Add( Actor );
+		}
+	}
+}
+
+void USlashBenchmarkCommandlet::DriveCharacter( ASlashCharacter* Character, const TArray<AActor*>& Enemies )
+{
+	if ( !IsValid( Character ) ) return;
+
+	const FVector CharacterLocation = Character->GetActorLocation( );
+	const AActor* Nearest = nullptr;
+	double NearestDistanceSquared = TNumericLimits<double>::Max( );
+	for ( const AActor* Actor : Enemies )
+	{
+		const AEnemy* Enemy = Cast<AEnemy>( Actor );
+		if ( !IsValid( Enemy ) || Enemy->GetEnemyState( ) == EEnemyState::EES_Dead ) continue;
+
+		const double DistanceSquared = FVector::DistSquared( CharacterLocation, Enemy->GetActorLocation( ) );
+		if ( DistanceSquared < NearestDistanceSquared )
+		{
+			NearestDistanceSquared = DistanceSquared;
+			Nearest = Enemy;
+		}
+	}
+
+	// walk up to the nearest enemy and keep swinging; Attack does nothing while a swing is still playing
+	if ( Nearest )
+	{
+		const FVector ToEnemy = (Nearest->GetActorLocation( ) - CharacterLocation).GetSafeNormal2D( );
+		Character->SetActorRotation( ToEnemy.Rotation( ) );
+		if ( NearestDistanceSquared > FMath::Square( 150.0 ) )
+		{
+			Character->AddMovementInput( ToEnemy );
+		}
+	}
+	Character->Attack( );
+}
+
+void USlashBenchmarkCommandlet::WriteSummary( const FString& Label, const TArray<double>& FrameTimes, double GCSeconds, int32 GCCount ) const
+{
+	TArray<double> Sorted = FrameTimes;
+	Sorted.Sort( );
+
+	auto PercentileMs = [&Sorted]( double Percentile )
+	{
+		if ( Sorted.Num( ) == 0 ) return 0.0;
+		const int32 Index = FMath::Clamp( FMath::CeilToInt( Percentile * Sorted.Num( ) ) - 1, 0, Sorted.Num( ) - 1 );
+		return Sorted[Index] * 1000.0;
+	};
+
+	double TotalSeconds = 0.0;
+	for ( const double FrameTime : Sorted )
+	{
+		TotalSeconds += FrameTime;
+	}
+	const double MeanMs = Sorted.Num( ) > 0 ? TotalSeconds * 1000.0 / Sorted.Num( ) : 0.0;
+
+	const FPlatformMemoryStats MemoryStats = FPlatformMemory::GetStats( );
+	const double PeakPhysicalMB = MemoryStats.PeakUsedPhysical / (1024.0 * 1024.0);
+	const double PeakVirtualMB = MemoryStats.PeakUsedVirtual / (1024.0 * 1024.0);
+
+	// one row per run, so before and after numbers end up side by side
+	const FString SummaryPath = FPaths::ProfilingDir( ) / TEXT( "SlashBenchmark.csv" );
+	if ( !IFileManager::Get( ).FileExists( *SummaryPath ) )
+	{
+		FFileHelper::SaveStringToFile(
+			TEXT( "Timestamp,Label,Map,Enemies,Breakables,Treasures,Frames,DeltaTime,MeanMs,P50Ms,P90Ms,P99Ms,MaxMs,GCMs,GCCount,PeakPhysicalMB,PeakVirtualMB\n" ),
+			*SummaryPath );
+	}
+
+	const FString Row = FString::Printf( TEXT( "%s,%s,%s,%d,%d,%d,%d,%.4f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%d,%.1f,%.1f\n" ),
+		*FDateTime::Now( ).ToString( ), *Label, *MapName, NumEnemies, NumBreakables, NumTreasures, Sorted.Num( ), FixedDeltaTime,
+		MeanMs, PercentileMs( 0.5 ), PercentileMs( 0.9 ), PercentileMs( 0.99 ), PercentileMs( 1.0 ),
+		GCSeconds * 1000.0, GCCount, PeakPhysicalMB, PeakVirtualMB );
+	FFileHelper::SaveStringToFile( Row, *SummaryPath, FFileHelper::EEncodingOptions::AutoDetect, &IFileManager::Get( ), FILEWRITE_Append );
+
+	UE_LOG( LogSlashBenchmark, Display, TEXT( "mean %.3f ms, p50 %.3f ms, p99 %.3f ms, max %.3f ms, GC %.3f ms over %d runs, peak %.1f MB -> %s" ),
+		MeanMs, PercentileMs( 0.5 ), PercentileMs( 0.99 ), PercentileMs( 1.0 ), GCSeconds * 1000.0, GCCount, PeakPhysicalMB, *SummaryPath );
+}
@@ -2,11 +2,31 @@
 
 
 #include "Components/AttributeComponent.h"
+#include "Net/UnrealNetwork.h"
 
 // Sets default values for this component's properties
 UAttributeComponent::UAttributeComponent()
 {
 	PrimaryComponentTick.bCanEverTick = true;
+	SetIsReplicatedByDefault( true );
+}
+
+void UAttributeComponent::GetLifetimeReplicatedProps( TArray<FLifetimeProperty>& OutLifetimeProps ) const
+{
+	Super::GetLifetimeReplicatedProps( OutLifetimeProps );
+
+	DOREPLIFETIME( UAttributeComponent, Health );
+	DOREPLIFETIME_CONDITION( UAttributeComponent, Stamina, COND_OwnerOnly );
+}
+
+void UAttributeComponent::OnRep_Health( )
+{
+	OnHealthChanged.Broadcast( Health );
+}
+
+void UAttributeComponent::OnRep_Stamina( )
+{
+	OnStaminaChanged.Broadcast( Stamina );
 }
 
 void UAttributeComponent::BeginPlay()
@@ -17,7 +37,30 @@ void UAttributeComponent::BeginPlay()
 void UAttributeComponent::ReceiveDamage( float Damage )
 {
 	Health = FMath::Clamp( Health - Damage, 0.f, MaxHealth );
+	OnHealthChanged.Broadcast( Health );
+}
 
+void UAttributeComponent::SetHealth( float NewHealth )
+{
+	Health = FMath::Clamp( NewHealth, 0.f, MaxHealth );
+	OnHealthChanged.Broadcast( Health );
+}
+
+void UAttributeComponent::UseStamina( float StaminaCost )
+{
+	Stamina = FMath::Clamp( Stamina - StaminaCost, 0.f, MaxStamina );
+	OnStaminaChanged.Broadcast( Stamina );
+}
+
+void UAttributeComponent::SetStamina( float NewStamina )
+{
+	Stamina = FMath::Clamp( NewStamina, 0.f, MaxStamina );
+	OnStaminaChanged.Broadcast( Stamina );
+}
+
+float UAttributeComponent::GetStaminaPercent( ) const
+{
+	return Stamina / MaxStamina;
 }
 
 float UAttributeComponent::GetHealthPercent( )
@@ -33,5 +76,11 @@ bool UAttributeComponent::IsAlive( )
 void UAttributeComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
 {
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	if ( Stamina < MaxStamina && IsAlive( ) )
+	{
+		Stamina = FMath::Min( Stamina + StaminaRegenRate * DeltaTime, MaxStamina );
+		OnStaminaChanged.Broadcast( Stamina );
+	}
 }
 
@@ -0,0 +1,87 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Components/BirdMovementComponent.h"
+#include "GameFramework/Pawn.h"
+#include "Slash/SlashStats.h"
+
+void UBirdMovementComponent::TickComponent( float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction )
+{
+	Super::TickComponent( DeltaTime, TickType, ThisTickFunction );
+
+	if ( ShouldSkipUpdate( DeltaTime ) || PawnOwner == nullptr || UpdatedComponent == nullptr || DeltaTime <= 0.f ) return;
+	SLASH_SCOPE_CYCLE_COUNTER( STAT_SlashBirdFlight );
+
+	const FVector Input = ConsumeInputVector( );
+	const FRotator Current = UpdatedComponent->GetComponentRotation( );
+	const float Throttle = FMath::Clamp( FVector::DotProduct( Input, Current.Vector( ) ), 0.f, 1.f );
+
+	// heading and bank are first order lags, exact for any step
+	const FRotator Control = PawnOwner->GetControlRotation( );
+	const float Blend = 1.f - FMath::Exp( -TurnResponse * DeltaTime );
+	const float YawDelta = FRotator::NormalizeAxis( Control.Yaw - Current.Yaw ) * Blend;
+	const float TargetPitch = FMath::Clamp( FRotator::NormalizeAxis( Control.Pitch ), -MaxPitch, MaxPitch );
+	const float Pitch = FMath::Lerp( FRotator::NormalizeAxis( Current.Pitch ), TargetPitch, Blend );
+	const float TargetBank = FMath::Clamp( YawDelta / DeltaTime * BankPerYawRate, -MaxBank, MaxBank );
+	Bank = TargetBank + ( Bank - TargetBank ) * FMath::Exp( -BankResponse * DeltaTime );
+	const FRotator NewRotation( Pitch, Current.Yaw + YawDelta, Bank );
+	const FVector Heading = NewRotation.Vector( );
+
+	// gravity along the flight path: diving gains speed, climbing bleeds it
+	const float Gravity = -GetGravityZ( );
+	Airspeed = IntegrateAirspeed( Airspeed, Throttle * MaxThrust - Gravity * Heading.Z, DeltaTime );
+
+	// lift holds the bird up at speed; below stall the shortfall is a sink that settles exponentially
+	const float VerticalAcceleration = FMath::Min( LiftCoefficient * FMath::Square( Airspeed ), Gravity ) - Gravity;
+	const float TerminalClimb = VerticalAcceleration / VerticalDamping;
+	const float Decay = FMath::Exp( -VerticalDamping * DeltaTime );
+	const float Rise = TerminalClimb * DeltaTime + ( ClimbRate - TerminalClimb ) * ( 1.f - Decay ) / VerticalDamping;
+	ClimbRate = TerminalClimb + ( ClimbRate - TerminalClimb ) * Decay;
+
+	FHitResult Hit;
+	SafeMoveUpdatedComponent( Heading * Airspeed * DeltaTime + FVector::UpVector * Rise, NewRotation.Quaternion( ), true, Hit );
+	if ( Hit.IsValidBlockingHit( ) )
+	{
+		Airspeed *= 1.f - FMath::Clamp( FVector::DotProduct( Heading, -Hit.Normal ), 0.f, 1.f );
+		if ( Hit.Normal.Z > 0.7f )
+		{
+			// perched
+			ClimbRate = FMath::Max( ClimbRate, 0.f );
+		}
+	}
+
+	Velocity = Heading * Airspeed + FVector::UpVector * ClimbRate;
+	UpdateComponentVelocity( );
+}
+
+float UBirdMovementComponent::IntegrateAirspeed( float Speed, float Acceleration, float DeltaTime ) const
+{
+	const float Drag = FMath::Max( DragCoefficient, KINDA_SMALL_NUMBER );
+	if ( FMath::IsNearlyZero( Acceleration ) )
+	{
+		return Speed / ( 1.f + Drag * Speed * DeltaTime );
+	}
+
+	const float Terminal = FMath::Sqrt( FMath::Abs( Acceleration ) / Drag );
+	const float Rate = FMath::Min( FMath::Sqrt( FMath::Abs( Acceleration ) * Drag ) * DeltaTime, 10.f );
+	const float Ratio = Speed / Terminal;
+	if ( Acceleration < 0.f )
+	{
+		// v = T tan( atan( v0 / T ) - rate ), stopped once the angle runs out
+		const float Angle = FMath::Atan( Ratio ) - Rate;
+		return Angle > 0.f ? Terminal * FMath::Tan( Angle ) : 0.f;
+	}
+	if ( FMath::IsNearlyEqual( Ratio, 1.f ) )
+	{
+		return Terminal;
+	}
+
+	// v = T tanh( atanh( v0 / T ) + rate ) below top speed, T coth( acoth( v0 / T ) + rate ) above it
+	const float Growth = ( Ratio + 1.f ) / FMath::Abs( Ratio - 1.f ) * FMath::Exp( 2.f * Rate );
+	return Ratio < 1.f ? Terminal * ( Growth - 1.f ) / ( Growth + 1.f ) : Terminal * ( Growth + 1.f ) / ( Growth - 1.f );
+}
+
+float UBirdMovementComponent::GetMaxSpeed( ) const
+{
+	return FMath::Sqrt( MaxThrust / FMath::Max( DragCoefficient, KINDA_SMALL_NUMBER ) );
+}
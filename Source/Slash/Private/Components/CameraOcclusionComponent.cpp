@@ -0,0 +1,134 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Components/CameraOcclusionComponent.h"
+#include "Camera/CameraComponent.h"
+#include "Components/PrimitiveComponent.h"
+#include "GameFramework/Pawn.h"
+#include "Materials/MaterialParameterCollection.h"
+#include "Materials/MaterialParameterCollectionInstance.h"
+#include "Engine/World.h"
+#include "Slash/SlashStats.h"
+
+UCameraOcclusionComponent::UCameraOcclusionComponent( )
+{
+	PrimaryComponentTick.bCanEverTick = true;
+
+	// after the spring arm has placed the camera for this frame
+	PrimaryComponentTick.TickGroup = TG_PostUpdateWork;
+}
+
+void UCameraOcclusionComponent::BeginPlay( )
+{
+	Super::BeginPlay( );
+
+	Camera = GetOwner( )->FindComponentByClass<UCameraComponent>( );
+}
+
+void UCameraOcclusionComponent::EndPlay( const EEndPlayReason::Type EndPlayReason )
+{
+	for ( const FFadingPrimitive& Entry : Fading )
+	{
+		if ( UPrimitiveComponent* Primitive = Entry.Primitive.Get( ) )
+		{
+			Primitive->SetCustomPrimitiveDataFloat( FadeDataIndex, 0.f );
+		}
+	}
+	Fading.Reset( );
+	FadingIndices.Reset( );
+
+	Super::EndPlay( EndPlayReason );
+}
+
+void UCameraOcclusionComponent::TickComponent( float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction )
+{
+	Super::TickComponent( DeltaTime, TickType, ThisTickFunction );
+
+	// only the local player's view is faded
+	const APawn* Pawn = Cast<APawn>( GetOwner( ) );
+	if ( Camera == nullptr || Pawn == nullptr || !Pawn->IsLocallyControlled( ) ) return;
+	SLASH_SCOPE_CYCLE_COUNTER( STAT_SlashCameraOcclusion );
+
+	ReadOcclusion( );
+	UpdateFades( DeltaTime );
+
+	const FVector CameraLocation = Camera->GetComponentLocation( );
+	const FVector TargetLocation = Pawn->GetActorLocation( );
+	if ( OcclusionCollection )
+	{
+		if ( UMaterialParameterCollectionInstance* Collection = GetWorld( )->GetParameterCollectionInstance( OcclusionCollection ) )
+		{
+			Collection->SetVectorParameterValue( CameraLocationParameter, CameraLocation );
+			Collection->SetVectorParameterValue( TargetLocationParameter, TargetLocation );
+		}
+	}
+	IssueOcclusion( CameraLocation, TargetLocation );
+}
+
+void UCameraOcclusionComponent::ReadOcclusion( )
+{
+	FTraceDatum Datum;
+	if ( !OcclusionTrace.IsValid( ) || !GetWorld( )->QueryTraceData( OcclusionTrace, Datum ) ) return;
+	OcclusionTrace = FTraceHandle( );
+
+	for ( FFadingPrimitive& Entry : Fading )
+	{
+		Entry.bOccluding = false;
+	}
+	for ( const FHitResult& Hit : Datum.OutHits )
+	{
+		UPrimitiveComponent* Primitive = Hit.GetComponent( );
+		if ( Primitive == nullptr ) continue;
+
+		const int32 Index = FadingIndices.Find( Primitive );
+		if ( Index != INDEX_NONE )
+		{
+			Fading[Index].bOccluding = true;
+			continue;
+		}
+		FadingIndices.Add( Primitive );
+		FFadingPrimitive& Entry = Fading.AddDefaulted_GetRef( );
+		Entry.Primitive = Primitive;
+		Entry.bOccluding = true;
+	}
+}
+
+void UCameraOcclusionComponent::UpdateFades( float DeltaTime )
+{
+	for ( int32 Index = Fading.Num( ) - 1; Index >= 0; --Index )
+	{
+		FFadingPrimitive& Entry = Fading[Index];
+		UPrimitiveComponent* Primitive = Entry.Primitive.Get( );
+		if ( Primitive == nullptr )
+		{
+			RemoveAtSwap( Index );
+			continue;
+		}
+
+		const float Fade = FMath::FInterpConstantTo( Entry.Fade, Entry.bOccluding ? 1.f : 0.f, DeltaTime, FadeSpeed );
+		if ( Fade != Entry.Fade )
+		{
+			Entry.Fade = Fade;
+			Primitive->SetCustomPrimitiveDataFloat( FadeDataIndex, Fade );
+		}
+		if ( Fade <= 0.f && !Entry.bOccluding )
+		{
+			RemoveAtSwap( Index );
+		}
+	}
+}
+
+void UCameraOcclusionComponent::IssueOcclusion( const FVector& CameraLocation, const FVector& TargetLocation )
+{
+	// fadeable meshes overlap the channel rather than block it, so the multi sweep reports every one on the way
+	FCollisionQueryParams Params( SCENE_QUERY_STAT( SlashCameraOcclusion ), false, GetOwner( ) );
+	GetOwner( )->GetAttachedActors( AttachedActors );
+	Params.AddIgnoredActors( AttachedActors );
+	OcclusionTrace = GetWorld( )->AsyncSweepByChannel( EAsyncTraceType::Multi, CameraLocation, TargetLocation, FQuat::Identity, OcclusionChannel, FCollisionShape::MakeSphere( TraceRadius ), Params );
+}
+
+void UCameraOcclusionComponent::RemoveAtSwap( int32 Index )
+{
+	FadingIndices.RemoveAtSwap( Index );
+	Fading.RemoveAtSwap( Index, 1, false );
+}
@@ -0,0 +1,302 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Components/LockOnComponent.h"
+#include "World/AreaDamageSubsystem.h"
+#include "Enemy/Enemy.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/Controller.h"
+#include "Algo/BinarySearch.h"
+#include "Algo/Sort.h"
+#include "Engine/World.h"
+
+ULockOnComponent::ULockOnComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+}
+
+void ULockOnComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	TargetIndex = GetWorld( )->GetSubsystem<UAreaDamageSubsystem>( );
+}
+
+void ULockOnComponent::TickComponent( float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction )
+{
+	Super::TickComponent( DeltaTime, TickType, ThisTickFunction );
+
+	ResolveSightTraces( );
+
+	TimeSinceRefresh += DeltaTime;
+	if ( TimeSinceRefresh >= RefreshInterval )
+	{
+		TimeSinceRefresh = 0.f;
+		RefreshCandidates( );
+	}
+
+	TimeSinceSightCheck += DeltaTime;
+	if ( TimeSinceSightCheck >= SightCheckInterval )
+	{
+		TimeSinceSightCheck = 0.f;
+		IssueSightTraces( );
+	}
+
+	if ( !IsLocked( ) ) return;
+
+	const FLockOnCandidate* Locked = FindCandidate( LockedTarget.Get( ) );
+	TimeOutOfSight = Locked && Locked->bVisible ? 0.f : TimeOutOfSight + DeltaTime;
+	if ( !IsValidTarget( LockedTarget.Get( ) ) || TimeOutOfSight > LoseSightTime )
+	{
+		ReleaseLock( );
+		return;
+	}
+	FollowTarget( DeltaTime );
+}
+
+void ULockOnComponent::ToggleLock( )
+{
+	if ( IsLocked( ) )
+	{
+		ReleaseLock( );
+		return;
+	}
+
+	// the candidate set is only kept while locked, so build it once now
+	FVector ViewLocation;
+	FRotator ViewRotation;
+	if ( !GetViewPoint( ViewLocation, ViewRotation ) ) return;
+	RefreshCandidates( );
+
+	// best score first; the press can't wait for async traces, so test sight directly until one is clear
+	PickOrder.Reset( );
+	for ( int32 Index = 0; Index < Candidates.Num( ); ++Index )
+	{
+		PickOrder.Add( Index );
+	}
+	Algo::SortBy( PickOrder, [this]( int32 Index ) { return Candidates[Index].Score; } );
+	for ( const int32 Index : PickOrder )
+	{
+		FLockOnCandidate& Candidate = Candidates[Index];
+		if ( !Candidate.bInRange || FMath::Abs( Candidate.Angle ) > MaxScreenAngle ) continue;
+
+		Candidate.bVisible = HasLineOfSight( ViewLocation, Candidate.Actor.Get( ) );
+		if ( Candidate.bVisible )
+		{
+			LockedTarget = Candidate.Actor;
+			break;
+		}
+	}
+	if ( !IsLocked( ) )
+	{
+		ResetCandidates( );
+		return;
+	}
+
+	ScoreCandidates( );
+	TimeOutOfSight = 0.f;
+	TimeSinceRefresh = 0.f;
+	TimeSinceSightCheck = 0.f;
+	IssueSightTraces( );
+	SetComponentTickEnabled( true );
+}
+
+void ULockOnComponent::SwitchTarget( float Direction )
+{
+	if ( !IsLocked( ) || SortedTargets.Num( ) < 2 || FMath::IsNearlyZero( Direction ) ) return;
+
+	const FLockOnCandidate* Locked = FindCandidate( LockedTarget.Get( ) );
+	if ( Locked == nullptr ) return;
+
+	// neighbours of the current target in angle order
+	const int32 Index = Direction > 0.f ?
+		Algo::UpperBoundBy( SortedTargets, Locked->Angle, &FSortedTarget::Angle ) :
+		Algo::LowerBoundBy( SortedTargets, Locked->Angle, &FSortedTarget::Angle ) - 1;
+	if ( !SortedTargets.IsValidIndex( Index ) ) return;
+
+	LockedTarget = SortedTargets[Index].Actor;
+	TimeOutOfSight = 0.f;
+}
+
+void ULockOnComponent::ReleaseLock( )
+{
+	LockedTarget.Reset( );
+	ResetCandidates( );
+	SortedTargets.Reset( );
+	SetComponentTickEnabled( false );
+}
+
+/*
+*  merge the grid's current answer into the candidate set, keeping trace state for the ones already known
+*/
+void ULockOnComponent::RefreshCandidates( )
+{
+	if ( TargetIndex == nullptr ) return;
+
+	GatheredTargets.Reset( );
+	TargetIndex->GatherTargets( GetOwner( )->GetActorLocation( ), LockOnRadius, GatheredTargets );
+
+	for ( FLockOnCandidate& Candidate : Candidates )
+	{
+		Candidate.bInRange = false;
+	}
+	for ( AActor* Target : GatheredTargets )
+	{
+		if ( !IsValidTarget( Target ) ) continue;
+
+		if ( FLockOnCandidate* Candidate = FindCandidate( Target ) )
+		{
+			Candidate->bInRange = true;
+		}
+		else
+		{
+			AddCandidate( Target );
+		}
+	}
+
+	// the locked target survives a refresh that misses it, so a brief exit doesn't drop the lock
+	for ( int32 Index = Candidates.Num( ) - 1; Index >= 0; --Index )
+	{
+		const FLockOnCandidate& Candidate = Candidates[Index];
+		if ( !Candidate.Actor.IsValid( ) || (!Candidate.bInRange && Candidate.Actor != LockedTarget) )
+		{
+			RemoveCandidateAt( Index );
+		}
+	}
+
+	ScoreCandidates( );
+}
+
+void ULockOnComponent::IssueSightTraces( )
+{
+	FVector ViewLocation;
+	FRotator ViewRotation;
+	if ( !GetViewPoint( ViewLocation, ViewRotation ) ) return;
+
+	FCollisionQueryParams Params( SCENE_QUERY_STAT( SlashLockOn ), false, GetOwner( ) );
+	for ( FLockOnCandidate& Candidate : Candidates )
+	{
+		const AActor* Actor = Candidate.Actor.Get( );
+		if ( Actor == nullptr ) continue;
+
+		Params.ClearIgnoredActors( );
+		Params.AddIgnoredActor( GetOwner( ) );
+		Params.AddIgnoredActor( Actor );
+		Candidate.SightTrace = GetWorld( )->AsyncLineTraceByChannel( EAsyncTraceType::Test, ViewLocation, Actor->GetActorLocation( ), ECollisionChannel::ECC_Visibility, Params );
+	}
+}
+
+void ULockOnComponent::ResolveSightTraces( )
+{
+	FTraceDatum Datum;
+	bool bChanged = false;
+	for ( FLockOnCandidate& Candidate : Candidates )
+	{
+		if ( !Candidate.SightTrace.IsValid( ) || !GetWorld( )->QueryTraceData( Candidate.SightTrace, Datum ) ) continue;
+
+		// test traces only report blocking hits, so no hits means a clear line
+		const bool bVisible = Datum.OutHits.Num( ) == 0;
+		bChanged |= bVisible != Candidate.bVisible;
+		Candidate.bVisible = bVisible;
+		Candidate.SightTrace = FTraceHandle( );
+	}
+	if ( bChanged )
+	{
+		ScoreCandidates( );
+	}
+}
+
+void ULockOnComponent::ScoreCandidates( )
+{
+	SortedTargets.Reset( );
+
+	FVector ViewLocation;
+	FRotator ViewRotation;
+	if ( !GetViewPoint( ViewLocation, ViewRotation ) ) return;
+
+	const FVector ViewForward = ViewRotation.Vector( );
+	const FVector ViewRight = FRotationMatrix( ViewRotation ).GetUnitAxis( EAxis::Y );
+	const FVector OwnerLocation = GetOwner( )->GetActorLocation( );
+
+	for ( FLockOnCandidate& Candidate : Candidates )
+	{
+		const AActor* Actor = Candidate.Actor.Get( );
+		if ( Actor == nullptr ) continue;
+
+		const FVector ToTarget = Actor->GetActorLocation( ) - ViewLocation;
+		Candidate.Angle = FMath::RadiansToDegrees( FMath::Atan2( FVector::DotProduct( ToTarget, ViewRight ), FVector::DotProduct( ToTarget, ViewForward ) ) );
+		Candidate.Score = FVector::Dist( Actor->GetActorLocation( ), OwnerLocation ) / LockOnRadius + AngleWeight * FMath::Abs( Candidate.Angle ) / 180.f;
+
+		if ( Candidate.bVisible && FMath::Abs( Candidate.Angle ) <= MaxScreenAngle )
+		{
+			SortedTargets.Add( { Candidate.Angle, Candidate.Actor } );
+		}
+	}
+	Algo::SortBy( SortedTargets, &FSortedTarget::Angle );
+}
+
+void ULockOnComponent::FollowTarget( float DeltaTime )
+{
+	APawn* Pawn = Cast<APawn>( GetOwner( ) );
+	AController* Controller = Pawn ? Pawn->GetController( ) : nullptr;
+	const AActor* Target = LockedTarget.Get( );
+	if ( Controller == nullptr || Target == nullptr ) return;
+
+	FRotator Desired = (Target->GetActorLocation( ) - Pawn->GetActorLocation( )).Rotation( );
+	Desired.Pitch += CameraPitchOffset;
+	Desired.Roll = 0.f;
+	Controller->SetControlRotation( FMath::RInterpTo( Controller->GetControlRotation( ), Desired, DeltaTime, CameraInterpSpeed ) );
+}
+
+bool ULockOnComponent::IsValidTarget( const AActor* Actor ) const
+{
+	// there are no teams, so only enemies are hostile; other players share the grid but are never locked onto
+	const AEnemy* Enemy = Cast<AEnemy>( Actor );
+	return Enemy && Enemy->GetEnemyState( ) != EEnemyState::EES_Dead;
+}
+
+bool ULockOnComponent::HasLineOfSight( const FVector& ViewLocation, const AActor* Actor ) const
+{
+	if ( Actor == nullptr ) return false;
+
+	FCollisionQueryParams Params( SCENE_QUERY_STAT( SlashLockOn ), false, GetOwner( ) );
+	Params.AddIgnoredActor( Actor );
+	return !GetWorld( )->LineTraceTestByChannel( ViewLocation, Actor->GetActorLocation( ), ECollisionChannel::ECC_Visibility, Params );
+}
+
+bool ULockOnComponent::GetViewPoint( FVector& OutLocation, FRotator& OutRotation ) const
+{
+	const APawn* Pawn = Cast<APawn>( GetOwner( ) );
+	const AController* Controller = Pawn ? Pawn->GetController( ) : nullptr;
+	if ( Controller == nullptr ) return false;
+
+	Controller->GetPlayerViewPoint( OutLocation, OutRotation );
+	return true;
+}
+
+ULockOnComponent::FLockOnCandidate* ULockOnComponent::FindCandidate( const AActor* Actor )
+{
+	const int32 Index = CandidateIndices.Find( Actor );
+	return Index != INDEX_NONE ? &Candidates[Index] : nullptr;
+}
+
+void ULockOnComponent::AddCandidate( AActor* Actor )
+{
+	CandidateIndices.Add( Actor );
+	FLockOnCandidate& Candidate = Candidates.AddDefaulted_GetRef( );
+	Candidate.Actor = Actor;
+	Candidate.bInRange = true;
+}
+
+void ULockOnComponent::RemoveCandidateAt( int32 Index )
+{
+	CandidateIndices.RemoveAtSwap( Index );
+	Candidates.RemoveAtSwap( Index, 1, false );
+}
+
+void ULockOnComponent::ResetCandidates( )
+{
+	Candidates.Reset( );
+	CandidateIndices.Reset( );
+}
@@ -0,0 +1,76 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Components/SlashSpringArmComponent.h"
+#include "Engine/World.h"
+#include "Slash/SlashStats.h"
+
+USlashSpringArmComponent::USlashSpringArmComponent( )
+{
+	ProbeChannel = ECollisionChannel::ECC_Camera;
+}
+
+void USlashSpringArmComponent::UpdateDesiredArmLocation( bool bDoTrace, bool bDoLocationLag, bool bDoRotationLag, float DeltaTime )
+{
+	UWorld* World = GetWorld( );
+	if ( !bDoTrace || TargetArmLength <= 0.f || World == nullptr || !World->IsGameWorld( ) )
+	{
+		Super::UpdateDesiredArmLocation( bDoTrace, bDoLocationLag, bDoRotationLag, DeltaTime );
+		return;
+	}
+	SLASH_SCOPE_CYCLE_COUNTER( STAT_SlashCameraProbe );
+
+	ReadProbe( );
+
+	const float Goal = BlockedArmLength >= 0.f ? BlockedArmLength : TargetArmLength;
+	if ( CurrentArmLength < 0.f )
+	{
+		CurrentArmLength = Goal;
+	}
+	CurrentArmLength = FMath::FInterpTo( CurrentArmLength, Goal, DeltaTime, Goal < CurrentArmLength ? PullInSpeed : LetOutSpeed );
+
+	{
+		// the engine's placement, lag and socket math on the eased length, with its own blocking sweep off
+		TGuardValue<float> ArmLength( TargetArmLength, CurrentArmLength );
+		Super::UpdateDesiredArmLocation( false, bDoLocationLag, bDoRotationLag, DeltaTime );
+	}
+
+	IssueProbe( DeltaTime );
+}
+
+void USlashSpringArmComponent::ReadProbe( )
+{
+	FTraceDatum Datum;
+	if ( !Probe.IsValid( ) || !GetWorld( )->QueryTraceData( Probe, Datum ) ) return;
+	Probe = FTraceHandle( );
+
+	const FHitResult* Hit = Datum.OutHits.FindByPredicate( []( const FHitResult& Result ) { return Result.bBlockingHit; } );
+	if ( Hit == nullptr )
+	{
+		BlockedArmLength = -1.f;
+		return;
+	}
+
+	// the sweep also covered the socket offset; the arm length that puts the camera as deep as the hit leaves that part out
+	const float HitDepth = FVector::DotProduct( Hit->Location - ProbeOrigin, ProbeDirection );
+	BlockedArmLength = FMath::Clamp( HitDepth - ProbeOffsetDepth, MinArmLength, FMath::Max( TargetArmLength, MinArmLength ) );
+}
+
+void USlashSpringArmComponent::IssueProbe( float DeltaTime )
+{
+	// the result is read next frame, so sweep from where the pivot and the view are heading
+	const AActor* Owner = GetOwner( );
+	const FVector Velocity = Owner ? Owner->GetVelocity( ) : FVector::ZeroVector;
+	const FVector Origin = PreviousArmOrigin + Velocity * DeltaTime;
+	const FRotator Rotation = PreviousDesiredRot + ( PreviousDesiredRot - LastProbeRotation ).GetNormalized( );
+	LastProbeRotation = PreviousDesiredRot;
+
+	const FVector Offset = FRotationMatrix( Rotation ).TransformVector( SocketOffset );
+	const FVector End = Origin - Rotation.Vector( ) * TargetArmLength + Offset;
+	ProbeOrigin = Origin;
+	ProbeDirection = -Rotation.Vector( );
+	ProbeOffsetDepth = FVector::DotProduct( Offset, ProbeDirection );
+
+	const FCollisionQueryParams Params( SCENE_QUERY_STAT( SlashSpringArm ), false, Owner );
+	Probe = GetWorld( )->AsyncSweepByChannel( EAsyncTraceType::Single, Origin, End, FQuat::Identity, ProbeChannel, FCollisionShape::MakeSphere( ProbeSize ), Params );
+}
@@ -3,6 +3,20 @@
 
 #include "Enemy/Enemy.h"
 #include "AIController.h"
+#include "AISystem.h"
+#include "Enemy/EnemyAIController.h"
+#include "Enemy/EngagementSubsystem.h"
+#include "Enemy/EnemyStateMachine.h"
+#include "Enemy/EnemyCrowdSubsystem.h"
+#include "Enemy/EnemyCompactState.h"
+#include "Enemy/EnemyTuningSubsystem.h"
+#include "World/StreamingDormancySubsystem.h"
+#include "World/SlashSaveSubsystem.h"
+#include "World/SlashRandomSubsystem.h"
+#include "World/LagCompensationSubsystem.h"
+#include "Network/SlashReplicationGraph.h"
+#include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
 #include "Components//SkeletalMeshComponent.h"
 #include "Components/CapsuleComponent.h" 
 #include "GameFramework/CharacterMovementComponent.h"
@@ -10,9 +24,13 @@
 #include "Perception/PawnSensingComponent.h"
 #include "HUD/HealthBarComponent.h"
 #include "Items/Weapons/Weapon.h" 
+#include "Items/Weapons/WeaponSpawnSubsystem.h"
+#include "Components/StaticMeshComponent.h"
 #include "Kismet/KismetSystemLibrary.h"
+#include "Animation/AnimMontage.h"
 
 #include "Slash/DebugMacros.h"
+#include "Slash/SlashStats.h"
 
 AEnemy::AEnemy()
 {
@@ -25,6 +43,9 @@ AEnemy::AEnemy()
 	GetCapsuleComponent()->SetCollisionResponseToChannel( ECollisionChannel::ECC_Camera, ECollisionResponse::ECR_Ignore );
 	
 	
+	// health already goes out packed into NetState
+	Attributes->SetIsReplicatedByDefault( false );
+
 	HealthBarWidget = CreateDefaultSubobject<UHealthBarComponent>( TEXT( "Health Bar" ) );
 	HealthBarWidget->SetupAttachment( GetRootComponent( ) );
 
@@ -36,29 +57,127 @@ AEnemy::AEnemy()
 	PawnSensing = CreateDefaultSubobject<UPawnSensingComponent>( TEXT( "Pawn Sensing" ) );
 	PawnSensing->SightRadius = 4000.f;
 	PawnSensing->SetPeripheralVisionAngle( 45.f );
+
+	AIControllerClass = AEnemyAIController::StaticClass( );
+	AutoPossessAI = EAutoPossessAI::PlacedInWorldOrSpawned;
+
+	RingGoal = FAISystem::InvalidLocation;
+
+	NetUpdateFrequency = PatrolNetUpdateFrequency;
 }
 
 void AEnemy::BeginPlay()
 {
 	Super::BeginPlay();
 
+	Tuning = GetWorld( )->GetSubsystem<UEnemyTuningSubsystem>( );
+	TuningRow = Tuning ? Tuning->FindRow( Archetype.ToSoftObjectPath( ) ) : UEnemyTuningSubsystem::DefaultRow;
+
 	if ( HealthBarWidget )
 	{
 		HealthBarWidget->SetVisibility( false );
 	}
+
+	// clients only present what the server replicates
+	if ( !HasAuthority( ) )
+	{
+		if ( PawnSensing )
+		{
+			PawnSensing->SetSensingUpdatesEnabled( false );
+		}
+		return;
+	}
+	 
+	// pick up where a crowd proxy left off, where we were the last time this cell was loaded, or from the save file
+	USlashSaveSubsystem* Save = USlashSaveSubsystem::Get( this );
+	FEnemyCompactState SavedState;
+	if ( RespawnState.IsSet( ) )
+	{
+		ApplyCompactState( RespawnState.GetValue( ) );
+		RespawnState.Reset( );
+	}
+	else if ( Save && Save->ConsumeEnemyState( this, SavedState ) )
+	{
+		if ( SavedState.State == EEnemyState::EES_Dead )
+		{
+			Destroy( );
+			return;
+		}
+		ApplyCompactState( SavedState );
+	}
+	Dormancy = GetWorld( )->GetSubsystem<UStreamingDormancySubsystem>( );
 	 
 	EnemyController = Cast<AAIController>( GetController( ) );
-	
-	MoveToTarget( PatrolTarget );
+	Engagement = GetWorld( )->GetSubsystem<UEngagementSubsystem>( );
+	Crowd = GetWorld( )->GetSubsystem<UEnemyCrowdSubsystem>( );
+	WeaponSpawner = GetWorld( )->GetSubsystem<UWeaponSpawnSubsystem>( );
+	if ( GetNetMode( ) != NM_Standalone )
+	{
+		LagCompensation = GetWorld( )->GetSubsystem<ULagCompensationSubsystem>( );
+	}
 
 	if ( PawnSensing )
 	{
 		PawnSensing->OnSeePawn.AddDynamic( this, &AEnemy::PawnSeen );
 	}
 
+	RegisterWithEnemySubsystems( );
+}
+
+void AEnemy::RegisterWithEnemySubsystems( )
+{
+	if ( Crowd )
+	{
+		Crowd->RegisterEnemy( this );
+	}
+	if ( LagCompensation )
+	{
+		LagCompensation->RegisterActor( this );
+	}
+
+	if ( Dormancy )
+	{
+		Dormancy->RegisterEnemy( this );
+	}
+	else
+	{
+		InitializeEnemy( );
+	}
+}
+
+void AEnemy::InitializeEnemy( )
+{
+	bInitialized = true;
+	EnterState( EnemyState );
+	SpawnDefaultWeapon( );
+}
+
+/*
+*  the weapon actor is queued with the spawner so a level full of enemies doesn't spawn every weapon in one frame
+*/
+void AEnemy::SpawnDefaultWeapon( )
+{
+	if ( WeaponClass == nullptr || EquippedWeapon ) return;
+
+	const bool bInCombat = EnemyStateMachine::IsInCombat( EnemyState );
+	if ( WeaponSpawner )
+	{
+		// the stand-in mesh isn't replicated, so networked games always get the weapon actor
+		if ( !bInCombat && WeaponSpawner->UseLightweightWeapons( ) && GetNetMode( ) == NM_Standalone )
+		{
+			if ( LightweightWeapon == nullptr )
+			{
+				LightweightWeapon = WeaponSpawner->AttachLightweightWeapon( GetMesh( ), WeaponClass, FName( "RightHandSocket" ) );
+			}
+			if ( LightweightWeapon ) return;
+		}
+		WeaponSpawner->RequestWeapon( this, WeaponClass, FName( "RightHandSocket" ), bInCombat );
+		return;
+	}
+
 	// attach weapon to enemy hand 
 	UWorld* World = GetWorld( );
-	if ( World && WeaponClass )
+	if ( World )
 	{
 		AWeapon* DefaultWeapon = World->SpawnActor<AWeapon>( WeaponClass );
 		DefaultWeapon->Equip( GetMesh( ), FName( "RightHandSocket" ), this, this );
@@ -66,13 +185,261 @@ void AEnemy::BeginPlay()
 	}  
 }
 
+void AEnemy::OnDefaultWeaponReady( AWeapon* Weapon )
+{
+	EquippedWeapon = Weapon;
+
+	if ( LightweightWeapon )
+	{
+		LightweightWeapon->DestroyComponent( );
+		LightweightWeapon = nullptr;
+	}
+}
+
+void AEnemy::ReleaseDefaultWeapon( )
+{
+	if ( WeaponSpawner )
+	{
+		WeaponSpawner->CancelRequests( this );
+	}
+	if ( EquippedWeapon == nullptr ) return;
+
+	if ( WeaponSpawner )
+	{
+		WeaponSpawner->ReleaseWeapon( EquippedWeapon );
+	}
+	else
+	{
+		EquippedWeapon->Destroy( );
+	}
+	EquippedWeapon = nullptr;
+}
+
+void AEnemy::EndPlay( const EEndPlayReason::Type EndPlayReason )
+{
+	// a pooled actor already left everything, and its stale state must not overwrite what its proxy records
+	if ( !bIsPooled )
+	{
+		if ( Engagement )
+		{
+			Engagement->ReleaseEnemy( this );
+		}
+
+		FEnemyCompactState FinalState;
+		ExportCompactState( FinalState );
+		if ( Crowd )
+		{
+			Crowd->UnregisterEnemy( this );
+		}
+		if ( Dormancy )
+		{
+			Dormancy->UnregisterEnemy( this, FinalState, EndPlayReason );
+		}
+		if ( LagCompensation )
+		{
+			LagCompensation->UnregisterActor( this );
+		}
+	}
+
+	if ( EndPlayReason == EEndPlayReason::Destroyed || EndPlayReason == EEndPlayReason::RemovedFromWorld )
+	{
+		ReleaseDefaultWeapon( );
+	}
+
+	Super::EndPlay( EndPlayReason );
+}
+
+void AEnemy::ExportCompactState( FEnemyCompactState& OutState ) const
+{
+	OutState.Location = GetActorLocation( );
+	OutState.Yaw = GetActorRotation( ).Yaw;
+	OutState.PatrolIndex = PatrolTargets.IndexOfByKey( PatrolTarget );
+	OutState.State = EnemyState;
+	OutState.Health = Attributes ? Attributes->GetHealth( ) : 0.f;
+}
+
+void AEnemy::PrepareRespawn( const FEnemyCompactState& CompactState, const FGuid& PersistentId )
+{
+	RespawnState = CompactState;
+	InheritedPersistentId = PersistentId;
+}
+
+/*
+*  the crowd pool keeps demoted actors around; parking one undoes everything BeginPlay registered
+*/
+void AEnemy::Deactivate( )
+{
+	if ( Engagement )
+	{
+		Engagement->ReleaseEnemy( this );
+	}
+	if ( Crowd )
+	{
+		Crowd->UnregisterEnemy( this );
+	}
+	if ( Dormancy )
+	{
+		Dormancy->ReleaseEnemy( this );
+	}
+	if ( LagCompensation )
+	{
+		LagCompensation->UnregisterActor( this );
+	}
+	UnregisterFromSubsystems( );
+
+	// whoever comes out of the pool may need a different weapon state, the spawner pools weapons on its own
+	ReleaseDefaultWeapon( );
+	if ( LightweightWeapon )
+	{
+		LightweightWeapon->DestroyComponent( );
+		LightweightWeapon = nullptr;
+	}
+	CombatTarget = nullptr;
+	InheritedPersistentId.Invalidate( );
+	bInitialized = false;
+
+	bIsPooled = true;
+	HideHealthBar( );
+	SetActorHiddenInGame( true );
+	SetActorEnableCollision( false );
+	RefreshSimulation( );
+}
+
+void AEnemy::Reactivate( const FEnemyCompactState& CompactState, const FGuid& PersistentId, const TArray<AActor*>& NewPatrolTargets )
+{
+	bIsPooled = false;
+	bIsDormant = false;
+	PatrolTargets = NewPatrolTargets;
+	InheritedPersistentId = PersistentId;
+
+	SetActorHiddenInGame( false );
+	SetActorEnableCollision( true );
+	ApplyCompactState( CompactState );
+	RefreshSimulation( );
+
+	// same registrations as BeginPlay; dormancy initializes the enemy, which enters the restored state and asks for its weapon
+	RegisterWithSubsystems( );
+	RegisterWithEnemySubsystems( );
+}
+
+/*
+*  only ever runs before the first EnterState, which picks the restored state up from there
+*/
+void AEnemy::ApplyCompactState( const FEnemyCompactState& CompactState )
+{
+	// checked like any teleport, so a stale position inside a wall or another enemy gets nudged to the nearest free spot
+	TeleportTo( CompactState.Location, FRotator( 0.f, CompactState.Yaw, 0.f ) );
+	PatrolTarget = PatrolTargets.IsValidIndex( CompactState.PatrolIndex ) ? PatrolTargets[CompactState.PatrolIndex] : nullptr;
+
+	if ( Attributes )
+	{
+		Attributes->SetHealth( CompactState.Health );
+		if ( HealthBarWidget )
+		{
+			HealthBarWidget->SetHealthPercent( Attributes->GetHealthPercent( ) );
+		}
+	}
+
+	EnemyState = CompactState.State;
+	UpdateNetState( );
+}
+
+bool AEnemy::CanBecomeProxy( ) const
+{
+	return ProxyMesh && EnemyState == EEnemyState::EES_Patrolling;
+}
+
+/*
+*  dormant enemies keep their place in the world but skip AI, movement and sensing until a player comes near
+*/
+void AEnemy::SetDormant( bool bDormant )
+{
+	bIsDormant = bDormant;
+	RefreshSimulation( );
+
+	if ( !bDormant )
+	{
+		if ( !bInitialized )
+		{
+			InitializeEnemy( );
+		}
+		else
+		{
+			EnterState( EnemyState );
+		}
+	}
+}
+
+bool AEnemy::CanSleep( ) const
+{
+	return EnemyState == EEnemyState::EES_Patrolling;
+}
+
+void AEnemy::RefreshSimulation( )
+{
+	const bool bSimulate = !bIsPooled && !bIsDormant;
+
+	SetActorTickEnabled( bSimulate );
+	GetCharacterMovement( )->SetComponentTickEnabled( bSimulate );
+
+	// dormant enemies are still drawn, keep a slow pose update so they don't freeze in the reference pose
+	GetMesh( )->SetComponentTickEnabled( !bIsPooled );
+	GetMesh( )->SetComponentTickInterval( bIsDormant ? DormantAnimTickInterval : 0.f );
+
+	if ( PawnSensing )
+	{
+		PawnSensing->SetSensingUpdatesEnabled( bSimulate );
+	}
+
+	// nothing moves while parked or asleep, so stop replicating until it wakes
+	if ( HasAuthority( ) )
+	{
+		SetNetDormancy( bSimulate ? DORM_Awake : DORM_DormantAll );
+	}
+
+	if ( !bSimulate )
+	{
+		if ( EnemyController )
+		{
+			EnemyController->StopMovement( );
+		}
+		ClearPatrolTimer( );
+		ClearAttackTimer( );
+	}
+}
+
 void AEnemy::Tick( float DeltaTime )
 {
+	SLASH_SCOPE_CYCLE_COUNTER( STAT_SlashEnemyTick );
 	Super::Tick( DeltaTime );
 
-	if ( IsDead()) return;
+	switch ( EnemyState )
+	{
+	case EEnemyState::EES_Patrolling:
+		INC_DWORD_STAT( STAT_SlashEnemiesPatrolling );
+		break;
+	case EEnemyState::EES_Chasing:
+		INC_DWORD_STAT( STAT_SlashEnemiesChasing );
+		break;
+	case EEnemyState::EES_Attacking:
+		INC_DWORD_STAT( STAT_SlashEnemiesAttacking );
+		break;
+	case EEnemyState::EES_Engaged:
+		INC_DWORD_STAT( STAT_SlashEnemiesEngaged );
+		break;
+	case EEnemyState::EES_Dead:
+		INC_DWORD_STAT( STAT_SlashEnemiesDead );
+		break;
+	default:
+		break;
+	}
+
+	// AI runs on the server, clients just follow the replicated movement
+	if ( IsDead() || !HasAuthority( ) ) return;
 
-	if ( EnemyState > EEnemyState::EES_Patrolling )
+	TickTimers( DeltaTime );
+
+	if ( EnemyStateMachine::IsInCombat( EnemyState ) )
 	{
 		CheckCombatTarget( );
 	}
@@ -82,6 +449,27 @@ void AEnemy::Tick( float DeltaTime )
 	}
 }
 
+void AEnemy::TickTimers( float DeltaTime )
+{
+	// DeltaTime already carries this enemy's CustomTimeDilation
+	if ( PatrolTimeRemaining >= 0.f )
+	{
+		PatrolTimeRemaining -= DeltaTime;
+		if ( PatrolTimeRemaining < 0.f )
+		{
+			PatrolTimerFinished( );
+		}
+	}
+	if ( AttackTimeRemaining >= 0.f )
+	{
+		AttackTimeRemaining -= DeltaTime;
+		if ( AttackTimeRemaining < 0.f )
+		{
+			AttackTimerFinished( );
+		}
+	}
+}
+
 void AEnemy::PatrolTimerFinished( )
 {
 	MoveToTarget( PatrolTarget );
@@ -105,37 +493,161 @@ void AEnemy::ShowHealthBar( )
 
 void AEnemy::LoseInterest( )
 {
+	if ( Engagement )
+	{
+		Engagement->ReleaseEnemy( this );
+	}
 	CombatTarget = nullptr;
 	HideHealthBar( );
 }
 
-void AEnemy::StartPatrolling( )
+void AEnemy::DispatchEnemyEvent( EEnemyEvent Event )
 {
-	EnemyState = EEnemyState::EES_Patrolling;
-	GetCharacterMovement( )->MaxWalkSpeed = PatrollingSpeed;
-	MoveToTarget( PatrolTarget );
+	const FEnemyTransition& Transition = EnemyStateMachine::GetTransition( EnemyState, Event );
+	const EEnemyState PreviousState = EnemyState;
+	const bool bStateChanged = Transition.NextState != PreviousState;
+	if ( !bStateChanged && Transition.Action == EEnemyAction::EEA_None ) return;
+
+	if ( EnemyStateMachine::IsTracingTransitions( ) )
+	{
+		FEnemyTransitionRecord Record;
+		Record.Time = GetWorld( )->GetTimeSeconds( );
+		Record.EnemyId = GetUniqueID( );
+		Record.FromState = PreviousState;
+		Record.ToState = Transition.NextState;
+		Record.Event = Event;
+		Record.Action = Transition.Action;
+		EnemyStateMachine::RecordTransition( Record );
+	}
+
+	if ( bStateChanged )
+	{
+		ExitState( PreviousState );
+		EnemyState = Transition.NextState;
+		EnterState( EnemyState );
+		UpdateNetState( );
+	}
+
+	RunEnemyAction( Transition.Action );
+}
+
+void AEnemy::EnterState( EEnemyState State )
+{
+	switch ( State )
+	{
+	case EEnemyState::EES_Patrolling:
+		GetCharacterMovement( )->MaxWalkSpeed = GetTuning( ).PatrollingSpeed;
+		MoveToTarget( PatrolTarget );
+		break;
+	case EEnemyState::EES_Chasing:
+		GetCharacterMovement( )->MaxWalkSpeed = GetTuning( ).ChaseSpeed;
+		if ( bInitialized && EquippedWeapon == nullptr )
+		{
+			SpawnDefaultWeapon( );
+		}
+		break;
+	case EEnemyState::EES_Attacking:
+		StartAttackTimer( );
+		break;
+	default:
+		break;
+	}
+}
+
+void AEnemy::ExitState( EEnemyState State )
+{
+	switch ( State )
+	{
+	case EEnemyState::EES_Patrolling:
+		ClearPatrolTimer( );
+		break;
+	case EEnemyState::EES_Attacking:
+		ClearAttackTimer( );
+		break;
+	default:
+		break;
+	}
+}
+
+void AEnemy::RunEnemyAction( EEnemyAction Action )
+{
+	switch ( Action )
+	{
+	case EEnemyAction::EEA_Chase:
+		ChaseTarget( );
+		break;
+	case EEnemyAction::EEA_LoseInterest:
+		LoseInterest( );
+		break;
+	case EEnemyAction::EEA_Attack:
+		Attack( );
+		break;
+	case EEnemyAction::EEA_Die:
+		Die( );
+		break;
+	default:
+		break;
+	}
 }
 
 void AEnemy::ChaseTarget( )
 {
-	EnemyState = EEnemyState::EES_Chasing;
-	GetCharacterMovement( )->MaxWalkSpeed = chaseSpeed;
-	MoveToTarget( CombatTarget );
+	// forces a fresh move request if we end up waiting on the ring
+	RingGoal = FAISystem::InvalidLocation;
+
+	if ( CanApproachTarget( ) )
+	{
+		MoveToTarget( CombatTarget );
+	}
+	else
+	{
+		HoldRingPosition( );
+	}
 }
 
-bool AEnemy::IsOutsideCombatRadius( )
+/*
+*  no free attack slot, wait on the ring around the target until one opens up
+*  the slot itself is only taken once the enemy reaches the attack radius
+*/
+void AEnemy::HoldRingPosition( )
 {
-	return !InTargetRange( CombatTarget, CombatRadius );
+	if ( Engagement == nullptr || CombatTarget == nullptr ) return;
+
+	if ( CanApproachTarget( ) )
+	{
+		if ( IsWaitingOnRing( ) )
+		{
+			RingGoal = FAISystem::InvalidLocation;
+			MoveToTarget( CombatTarget );
+		}
+		return;
+	}
+
+	const FVector RingLocation = Engagement->GetRingLocation( this, CombatTarget );
+	if ( FVector::DistSquared2D( RingLocation, RingGoal ) > FMath::Square( RingRepathDistance ) )
+	{
+		RingGoal = RingLocation;
+		MoveToLocation( RingLocation );
+	}
 }
 
-bool AEnemy::IsOutsideAttackRadius( )
+/*
+*  one distance per update, classified against the squared radii
+*/
+EEnemyEvent AEnemy::SenseCombatEvent( )
 {
-	return !InTargetRange( CombatTarget, AttackRadius );
+	const double DistanceSquared = GetDistanceSquaredToTarget( CombatTarget );
+
+	const FEnemyTuning& Row = GetTuning( );
+	if ( DistanceSquared > Row.CombatRadiusSquared ) return EEnemyEvent::EEE_TargetLost;
+	if ( DistanceSquared > Row.AttackRadiusSquared ) return EEnemyEvent::EEE_TargetOutOfReach;
+	return TryAcquireAttackSlot( ) ? EEnemyEvent::EEE_TargetInReach : EEnemyEvent::EEE_TargetOutOfReach;
 }
 
-bool AEnemy::IsInsideAttackRadius( )
+double AEnemy::GetDistanceSquaredToTarget( AActor* Target ) const
 {
-	return InTargetRange( CombatTarget, AttackRadius );
+	if ( Target == nullptr ) return TNumericLimits<double>::Max( );
+	return FVector::DistSquared( Target->GetActorLocation( ), GetActorLocation( ) );
 }
 
 bool AEnemy::IsChasing( )
@@ -143,36 +655,53 @@ bool AEnemy::IsChasing( )
 	return EnemyState == EEnemyState::EES_Chasing;
 }
 
-bool AEnemy::IsAttacking  ( )
+bool AEnemy::IsDead( )
 {
-	return EnemyState == EEnemyState::EES_Attacking; 
+	return EnemyState == EEnemyState::EES_Dead;
 }
 
-bool AEnemy::IsDead( )
+bool AEnemy::IsWaitingOnRing( )
 {
-	return EnemyState == EEnemyState::EES_Dead;
+	return FAISystem::IsValidLocation( RingGoal );
+}
+
+bool AEnemy::HasAttackSlot( ) const
+{
+	if ( Engagement == nullptr ) return true;
+	return Engagement->HasAttackSlot( this, CombatTarget );
+}
+
+bool AEnemy::CanApproachTarget( ) const
+{
+	if ( Engagement == nullptr ) return true;
+	return Engagement->HasAttackSlot( this, CombatTarget ) || Engagement->HasFreeAttackSlot( CombatTarget );
 }
 
-bool AEnemy::IsEngaged( )
+bool AEnemy::TryAcquireAttackSlot( )
 {
-	return EnemyState == EEnemyState::EES_Engaged
+	if ( Engagement == nullptr ) return true;
+	return Engagement->TryAcquireAttackSlot( this, CombatTarget );
 }
 
 void AEnemy::ClearPatrolTimer( )
 {
-	GetWorldTimerManager( ).ClearTimer( PatrolTimer );
+	PatrolTimeRemaining = -1.f;
 }
 
 void AEnemy::StartAttackTimer( )
 {
-	EnemyState == EEnemyState::EES_Attacking;
-	const float AttackTime = FMath::RandRange( AttackMin, AttackMax );
-	GetWorldTimerManager().SetTimer( AttackTimer, this, &AEnemy::Attack, AttackTime );
+	const float AttackTime = USlashRandomSubsystem::GetStream( this, ESlashRandomStream::ESRS_EnemyCombat ).FRandRange( GetTuning( ).AttackMin, GetTuning( ).AttackMax );
+	AttackTimeRemaining = AttackTime;
+}
+
+void AEnemy::AttackTimerFinished( )
+{
+	DispatchEnemyEvent( EEnemyEvent::EEE_AttackStarted );
 }
 
 void AEnemy::ClearAttackTimer( )
 {
-	GetWorldTimerManager( ).ClearTimer( AttackTimer );
+	AttackTimeRemaining = -1.f;
 }
 
 AActor* AEnemy::ChoosePatrolTarget( )
@@ -189,8 +718,8 @@ AActor* AEnemy::ChoosePatrolTarget( )
 	const int32 NumPatrolTargets = ValidTargets.Num( );
 	if ( NumPatrolTargets > 0 )
 	{
-		const int32 TargetSelection = FMath::RandRange( 0, NumPatrolTargets - 1 );
-		return PatrolTargets[TargetSelection];
+		const int32 TargetSelection = USlashRandomSubsystem::GetStream( this, ESlashRandomStream::ESRS_EnemyPatrol ).RandRange( 0, NumPatrolTargets - 1 );
+		return ValidTargets[TargetSelection];
 	}
 	return nullptr;
 }
@@ -206,10 +735,11 @@ void AEnemy::PlayAttackMontage( )
 	Super::PlayAttackMontage( );
 
 	UAnimInstance* AnimInstance = GetMesh( )->GetAnimInstance( );
-	if ( AnimInstance && AttackMontage )
+	UAnimMontage* Montage = AttackMontage.Get( );
+	if ( AnimInstance && Montage )
 	{
-		AnimInstance->Montage_Play( AttackMontage );
-		const int32 Selection = FMath::RandRange( 0, 3 );
+		AnimInstance->Montage_Play( Montage );
+		const int32 Selection = USlashRandomSubsystem::GetStream( this, ESlashRandomStream::ESRS_Animation ).RandRange( 0, 3 );
 		FName SectionName = FName( );
 		switch ( Selection )
 		{
@@ -228,16 +758,26 @@ void AEnemy::PlayAttackMontage( )
 		default:
 			break;
 		}
-		AnimInstance->Montage_JumpToSection( SectionName, AttackMontage );
-	} 
+		AnimInstance->Montage_JumpToSection( SectionName, Montage );
+
+		FOnMontageEnded EndDelegate;
+		EndDelegate.BindUObject( this, &AEnemy::OnAttackMontageEnded );
+		AnimInstance->Montage_SetEndDelegate( EndDelegate, Montage );
+	}
+	else
+	{
+		AttackEnd( );
+	}
+}
+
+void AEnemy::OnAttackMontageEnded( UAnimMontage* Montage, bool bInterrupted )
+{
+	AttackEnd( );
 }
 
-bool AEnemy::CanAttack( )
+void AEnemy::AttackEnd( )
 {
-	bool bCanAttack = IsInsideAttackRadius( ) &&
-		!IsAttacking( ) &&
-		!IsDead();
-	return bCanAttack;
+	DispatchEnemyEvent( EEnemyEvent::EEE_AttackEnded );
 }
 
 void AEnemy::HandleDamage( float DamageAmount )
@@ -247,6 +787,7 @@ void AEnemy::HandleDamage( float DamageAmount )
 	{
 		HealthBarWidget->SetHealthPercent( Attributes->GetHealthPercent( ) );
 	}
+	UpdateNetState( );
 }
 
 void AEnemy::MoveToTarget( AActor* Target )
@@ -259,139 +800,224 @@ void AEnemy::MoveToTarget( AActor* Target )
 	EnemyController->MoveTo( MoveRequest );
 }
 
+void AEnemy::MoveToLocation( const FVector& Location )
+{
+	if ( EnemyController == nullptr ) return;
+	FAIMoveRequest MoveRequest;
+	MoveRequest.SetGoalLocation( Location );
+	MoveRequest.SetAcceptanceRadius( 60.f );
+
+	EnemyController->MoveTo( MoveRequest );
+}
+
 /*
 *  enemy sees the player and starts chasing
 */
 void AEnemy::PawnSeen( APawn* SeenPawn )
 {
+	SLASH_SCOPE_CYCLE_COUNTER( STAT_SlashEnemyPawnSeen );
 	const bool bShouldChaseTarget =
-		EnemyState != EEnemyState::EES_Dead &&
-		EnemyState != EEnemyState::EES_Chasing &&
-		EnemyState < EEnemyState::EES_Attacking &&
+		EnemyStateMachine::GetTransition( EnemyState, EEnemyEvent::EEE_PawnSeen ).Action == EEnemyAction::EEA_Chase &&
 		SeenPawn->ActorHasTag( FName( "SlashCharacter" ) );
 
 	if ( bShouldChaseTarget )
 	{
 		CombatTarget = SeenPawn;
-		ClearPatrolTimer( );
-		ChaseTarget( );
-
+		DispatchEnemyEvent( EEnemyEvent::EEE_PawnSeen );
 	}
 }
 
-bool AEnemy::InTargetRange( AActor* Target, double Radius )
+bool AEnemy::InTargetRange( AActor* Target, double RadiusSquared )
 {
 	if ( Target == nullptr ) return false;
-	const double DistanceToTarget = (Target->GetActorLocation( ) - GetActorLocation( )).Size( );
 	//DRAW_SPHERE_SingleFrame( GetActorLocation( ) );
 	//DRAW_SPHERE_SingleFrame( Target->GetActorLocation( ) );
 
-	return DistanceToTarget <= Radius;
+	return GetDistanceSquaredToTarget( Target ) <= RadiusSquared;
+}
+
+const FEnemyTuning& AEnemy::GetTuning( ) const
+{
+	static const FEnemyTuning DefaultTuning;
+	return Tuning ? Tuning->GetRow( TuningRow ) : DefaultTuning;
 }
 
 void AEnemy::CheckPatrolTarget( )
 {
-	if ( InTargetRange( PatrolTarget, PatrolRadius ) )
+	const FEnemyTuning& Row = GetTuning( );
+	if ( InTargetRange( PatrolTarget, Row.PatrolRadiusSquared ) )
 	{
 		PatrolTarget = ChoosePatrolTarget( );
-		const float WaitTime = FMath::RandRange( WaitMin, WaitMax );
-		GetWorldTimerManager( ).SetTimer( PatrolTimer, this, &AEnemy::PatrolTimerFinished, WaitTime );
+		const float WaitTime = USlashRandomSubsystem::GetStream( this, ESlashRandomStream::ESRS_EnemyPatrol ).FRandRange( Row.WaitMin, Row.WaitMax );
+		PatrolTimeRemaining = WaitTime;
 	}
 }
 
 void AEnemy::CheckCombatTarget( )
 {
-	if ( IsOutsideCombatRadius() )
-	{
-		ClearAttackTimer( );
-		LoseInterest( );
-		if ( !IsEngaged( ) ) StartPatrolling( );
-	}
-	else if ( IsOutsideAttackRadius( ) && !IsChasing() )
+	DispatchEnemyEvent( SenseCombatEvent( ) );
+
+	// slots free up and get taken while chasing, approach when one is open and fall back to the ring when not
+	if ( IsChasing( ) && !HasAttackSlot( ) )
 	{
-		ClearAttackTimer( );
-		if( !IsEngaged() ) ChaseTarget( );
+		HoldRingPosition( );
 	}
-	else if ( CanAttack() )
+}
+
+/*
+*  AI reaction, after the damage bus has applied every hit of the frame
+*/
+void AEnemy::GetHit_Implementation( const FVector& ImpactPoint ) 
+{
+	DispatchEnemyEvent( EEnemyEvent::EEE_Damaged );
+	if ( !IsAlive( ) )
 	{
-		StartPatrolling( );
+		DispatchEnemyEvent( EEnemyEvent::EEE_Died );
 	}
 }
 
-void AEnemy::GetHit_Implementation( const FVector& ImpactPoint ) 
+void AEnemy::PlayHitEffects( const FVector& ImpactPoint, EHitDirection Direction )
 {
-	ShowHealthBar( );
+	// the server already classified the direction, clients just play the section
+	MulticastHitEffects( ImpactPoint, Direction, IsAlive( ) );
+}
 
-	if ( IsAlive( ) )
+void AEnemy::MulticastHitEffects_Implementation( const FVector_NetQuantize& ImpactPoint, EHitDirection Direction, bool bAlive )
+{
+	if ( bAlive )
 	{
-		DirectionalHitReact( ImpactPoint );
+		ShowHealthBar( );
+		DirectionalHitReact( Direction );
 	}
-	else Die( );
 
-	PlayHitSound( ImpactPoint );
 	SpawnJHitParticles( ImpactPoint );
 }
 
+void AEnemy::PlayHitAudio( const FVector& ImpactPoint )
+{
+	MulticastHitAudio( ImpactPoint );
+}
+
+void AEnemy::MulticastHitAudio_Implementation( const FVector_NetQuantize& ImpactPoint )
+{
+	PlayHitSound( ImpactPoint );
+}
+
 float AEnemy::TakeDamage( float DamageAmount, struct FDamageEvent const& DamageEvent, class AController* EventInstigator, AActor* DamageCauser )
 {
+	SLASH_SCOPE_CYCLE_COUNTER( STAT_SlashEnemyTakeDamage );
 	HandleDamage( DamageAmount );
-	CombatTarget = EventInstigator->GetPawn( );
-	ChaseTarget( );
+	if ( EventInstigator && !IsDead( ) )
+	{
+		CombatTarget = EventInstigator->GetPawn( );
+	}
 	return DamageAmount;
 }
 
-void AEnemy::Destroyed( )
+void AEnemy::Die( )
 {
-	if ( EquippedWeapon )
+	const int32 Selection = USlashRandomSubsystem::GetStream( this, ESlashRandomStream::ESRS_Animation ).RandRange( 0, 5 );
+	DeathPose = static_cast<EDeathPose>( Selection );
+	PlayDeathMontage( );
+
+	HideHealthBar( );
+
+	if ( Engagement )
 	{
-		EquippedWeapon->Destroy( );
+		Engagement->ReleaseEnemy( this );
+	}
+
+	GetCapsuleComponent( )->SetCollisionEnabled( ECollisionEnabled::NoCollision );
+	SetLifeSpan( 3.f );
+	UpdateNetState( );
+
+	// recorded now rather than in EndPlay so a save during the death animation already has it
+	if ( USlashSaveSubsystem* Save = USlashSaveSubsystem::Get( this ) )
+	{
+		FEnemyCompactState DeadState;
+		ExportCompactState( DeadState );
+		Save->RecordEnemy( this, DeadState );
 	}
 }
 
-void AEnemy::Die( )
+void AEnemy::PlayDeathMontage( )
 {
 	UAnimInstance* AnimInstance = GetMesh( )->GetAnimInstance( );
-	if ( AnimInstance && DeathMontage )
+	UAnimMontage* Montage = DeathMontage.Get( );
+	if ( AnimInstance && Montage )
 	{
-		AnimInstance->Montage_Play( DeathMontage );
+		AnimInstance->Montage_Play( Montage );
 
-		const int32 Selection = FMath::RandRange( 0, 5 );
-		FName SectionName = FName( );
-		switch ( Selection )
-		{
-		case 0:
-			SectionName = FName( "Death1" );
-			DeathPose = EDeathPose::EDP_Death1;
-			break;
-		case 1:
-			SectionName = FName( "Death2" );
-			DeathPose = EDeathPose::EDP_Death2;
-			break;
-		case 2:
-			SectionName = FName( "Death3" );
-			DeathPose = EDeathPose::EDP_Death3;
-			break;
-		case 3:
-			SectionName = FName( "Death4" );
-			DeathPose = EDeathPose::EDP_Death4;
-			break;
-		case 4:
-			SectionName = FName( "Death5" );
-			DeathPose = EDeathPose::EDP_Death5;
-			break;
-		case 5:
-			SectionName = FName( "Death6" );
-			DeathPose = EDeathPose::EDP_Death6;
-			break;
-		default:
-			break;
-		}
+		// sections are Death1..Death6, in EDeathPose order
+		const FName SectionName( *FString::Printf( TEXT( "Death%d" ), static_cast<int32>( DeathPose ) + 1 ) );
+		AnimInstance->Montage_JumpToSection( SectionName, Montage );
+	}
+}
+
+void AEnemy::GatherCombatAssets( TArray<FSoftObjectPath>& OutAssets ) const
+{
+	Super::GatherCombatAssets( OutAssets );
 
-		AnimInstance->Montage_JumpToSection( SectionName, DeathMontage );
+	// the weapon is spawned later, its equip sound should already be here by then
+	AddCombatAssetsOf( OutAssets, WeaponClass );
+}
+
+void AEnemy::GetLifetimeReplicatedProps( TArray<FLifetimeProperty>& OutLifetimeProps ) const
+{
+	Super::GetLifetimeReplicatedProps( OutLifetimeProps );
+
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+	DOREPLIFETIME_WITH_PARAMS_FAST( AEnemy, NetState, Params );
+}
+
+void AEnemy::UpdateNetState( )
+{
+	if ( !HasAuthority( ) ) return;
+
+	// patrolling enemies only need a trickle of updates, fights need them promptly
+	const bool bInCombat = EnemyStateMachine::IsInCombat( EnemyState );
+	const float NewNetUpdateFrequency = bInCombat ? CombatNetUpdateFrequency : PatrolNetUpdateFrequency;
+	NetPriority = bInCombat ? 3.f : 1.f;
+	if ( NewNetUpdateFrequency != NetUpdateFrequency )
+	{
+		NetUpdateFrequency = NewNetUpdateFrequency;
+		USlashReplicationGraph::NotifyUpdateFrequencyChanged( this );
 	}
 
-	HideHealthBar( );
+	FEnemyNetState NewState;
+	NewState.State = EnemyState;
+	NewState.DeathPose = DeathPose;
+	NewState.SetHealthPercent( Attributes ? Attributes->GetHealthPercent( ) : 0.f );
+	if ( NewState == NetState ) return;
 
-	GetCapsuleComponent( )->SetCollisionEnabled( ECollisionEnabled::NoCollision );
-	SetLifeSpan( 3.f );
+	NetState = NewState;
+	MARK_PROPERTY_DIRTY_FROM_NAME( AEnemy, NetState, this );
+	if ( NetDormancy > DORM_Awake )
+	{
+		FlushNetDormancy( );
+	}
+	if ( Crowd )
+	{
+		Crowd->UpdateRoster( this, NetState );
+	}
+}
+
+void AEnemy::OnRep_NetState( )
+{
+	const bool bJustDied = NetState.State == EEnemyState::EES_Dead && EnemyState != EEnemyState::EES_Dead;
+
+	EnemyState = NetState.State;
+	DeathPose = NetState.DeathPose;
+	if ( HealthBarWidget )
+	{
+		HealthBarWidget->SetHealthPercent( NetState.GetHealthPercent( ) );
+	}
+
+	if ( bJustDied )
+	{
+		PlayDeathMontage( );
+		HideHealthBar( );
+		GetCapsuleComponent( )->SetCollisionEnabled( ECollisionEnabled::NoCollision );
+	}
 }
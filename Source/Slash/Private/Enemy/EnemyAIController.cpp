@@ -0,0 +1,25 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Enemy/EnemyAIController.h"
+#include "Navigation/CrowdFollowingComponent.h"
+
+AEnemyAIController::AEnemyAIController( const FObjectInitializer& ObjectInitializer ) :
+	Super( ObjectInitializer.SetDefaultSubobjectClass<UCrowdFollowingComponent>( TEXT( "PathFollowingComponent" ) ) )
+{
+}
+
+void AEnemyAIController::BeginPlay( )
+{
+	Super::BeginPlay( );
+
+	UCrowdFollowingComponent* CrowdFollowing = Cast<UCrowdFollowingComponent>( GetPathFollowingComponent( ) );
+	if ( CrowdFollowing )
+	{
+		CrowdFollowing->SetCrowdSimulationState( ECrowdSimulationState::Enabled );
+		CrowdFollowing->SetCrowdAvoidanceQuality( ECrowdAvoidanceQuality::Medium );
+		CrowdFollowing->SetCrowdSeparation( bEnableSeparation );
+		CrowdFollowing->SetCrowdSeparationWeight( SeparationWeight );
+		CrowdFollowing->SetCrowdCollisionQueryRange( CollisionQueryRange );
+	}
+}
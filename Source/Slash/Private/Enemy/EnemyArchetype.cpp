@@ -0,0 +1,20 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Enemy/EnemyArchetype.h"
+
+FEnemyTuning UEnemyArchetype::Bake( ) const
+{
+	FEnemyTuning Tuning;
+	Tuning.CombatRadiusSquared = FMath::Square( CombatRadius );
+	Tuning.AttackRadiusSquared = FMath::Square( AttackRadius );
+	Tuning.PatrolRadius = PatrolRadius;
+	Tuning.PatrolRadiusSquared = FMath::Square( PatrolRadius );
+	Tuning.WaitMin = FMath::Min( WaitMin, WaitMax );
+	Tuning.WaitMax = FMath::Max( WaitMin, WaitMax );
+	Tuning.AttackMin = FMath::Min( AttackMin, AttackMax );
+	Tuning.AttackMax = FMath::Max( AttackMin, AttackMax );
+	Tuning.PatrollingSpeed = PatrollingSpeed;
+	Tuning.ChaseSpeed = ChaseSpeed;
+	return Tuning;
+}
@@ -0,0 +1,395 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Enemy/EnemyCrowdSubsystem.h"
+#include "Enemy/Enemy.h"
+#include "Enemy/EnemyRoster.h"
+#include "Enemy/EnemyArchetype.h"
+#include "World/StreamingDormancySubsystem.h"
+#include "World/SlashSaveSubsystem.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "NavigationSystem.h"
+#include "Engine/World.h"
+#include "Slash/SlashStats.h"
+
+void UEnemyCrowdSubsystem::FEnemyProxies::RemoveAtSwap( int32 Index )
+{
+	States.RemoveAtSwap( Index, 1, false );
+	Routes.RemoveAtSwap( Index, 1, false );
+	PersistentIds.RemoveAtSwap( Index, 1, false );
+	Levels.RemoveAtSwap( Index, 1, false );
+}
+
+void UEnemyCrowdSubsystem::Initialize( FSubsystemCollectionBase& Collection )
+{
+	Super::Initialize( Collection );
+
+	LevelRemovedHandle = FWorldDelegates::LevelRemovedFromWorld.AddUObject( this, &UEnemyCrowdSubsystem::OnLevelRemoved );
+}
+
+void UEnemyCrowdSubsystem::RegisterEnemy( AEnemy* Enemy )
+{
+	if ( Enemy )
+	{
+		LiveEnemies.AddUnique( Enemy );
+		UpdateRoster( Enemy, Enemy->GetNetState( ) );
+	}
+}
+
+void UEnemyCrowdSubsystem::UnregisterEnemy( AEnemy* Enemy )
+{
+	LiveEnemies.RemoveSwap( Enemy );
+	if ( Roster )
+	{
+		Roster->RemoveEnemy( Enemy );
+	}
+}
+
+void UEnemyCrowdSubsystem::UpdateRoster( AEnemy* Enemy, const FEnemyNetState& State )
+{
+	UWorld* World = GetWorld( );
+	if ( Enemy == nullptr || World->GetNetMode( ) == NM_Standalone || World->GetNetMode( ) == NM_Client ) return;
+
+	if ( Roster == nullptr )
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.ObjectFlags |= RF_Transient;
+		Roster = World->SpawnActor<AEnemyRoster>( SpawnParams );
+		if ( Roster == nullptr ) return;
+	}
+	Roster->UpdateEnemy( Enemy, State );
+}
+
+void UEnemyCrowdSubsystem::Tick( float DeltaTime )
+{
+	SLASH_SCOPE_TRACE( STAT_SlashCrowdTick );
+	if ( !bEnableProxies ) return;
+
+	TimeSinceUpdate += DeltaTime;
+	if ( TimeSinceUpdate >= UpdateInterval )
+	{
+		TimeSinceUpdate = 0.f;
+		GatherViewerLocations( );
+		DemoteDistantEnemies( );
+		ProjectProxiesToNavigation( );
+	}
+
+	if ( ViewerLocations.Num( ) > 0 )
+	{
+		PromoteNearbyProxies( );
+	}
+
+	AdvanceProxies( DeltaTime );
+	UpdateInstances( );
+
+	SET_DWORD_STAT( STAT_SlashCrowdProxies, Proxies.Num( ) );
+}
+
+TStatId UEnemyCrowdSubsystem::GetStatId( ) const
+{
+	return GET_STATID( STAT_SlashCrowdTick );
+}
+
+void UEnemyCrowdSubsystem::Deinitialize( )
+{
+	FWorldDelegates::LevelRemovedFromWorld.Remove( LevelRemovedHandle );
+
+	Proxies = FEnemyProxies( );
+	ProxyBatches.Empty( );
+	Instances.Reset( );
+	Routes.Empty( );
+	LiveEnemies.Empty( );
+	EnemyPool.Empty( );
+	Roster = nullptr;
+
+	Super::Deinitialize( );
+}
+
+void UEnemyCrowdSubsystem::GatherViewerLocations( )
+{
+	ViewerLocations.Reset( );
+	for ( FConstPlayerControllerIterator It = GetWorld( )->GetPlayerControllerIterator( ); It; ++It )
+	{
+		const APlayerController* PlayerController = It->Get( );
+		if ( PlayerController && PlayerController->GetPawn( ) )
+		{
+			ViewerLocations.Add( PlayerController->GetPawn( )->GetActorLocation( ) );
+		}
+	}
+}
+
+bool UEnemyCrowdSubsystem::IsNearViewer( const FVector& Location, double Radius ) const
+{
+	const double RadiusSquared = FMath::Square( Radius );
+	for ( const FVector& ViewerLocation : ViewerLocations )
+	{
+		if ( FVector::DistSquared( ViewerLocation, Location ) <= RadiusSquared ) return true;
+	}
+	return false;
+}
+
+void UEnemyCrowdSubsystem::DemoteDistantEnemies( )
+{
+	// without a viewer there is nothing to measure against, keep everyone as they are
+	if ( ViewerLocations.Num( ) == 0 ) return;
+
+	for ( int32 Index = LiveEnemies.Num( ) - 1; Index >= 0; --Index )
+	{
+		AEnemy* Enemy = LiveEnemies[Index].Get( );
+		if ( Enemy == nullptr )
+		{
+			LiveEnemies.RemoveAtSwap( Index );
+			continue;
+		}
+
+		if ( Enemy->CanBecomeProxy( ) && !IsNearViewer( Enemy->GetActorLocation( ), DemotionRadius ) )
+		{
+			LiveEnemies.RemoveAtSwap( Index );
+			Demote( Enemy );
+		}
+	}
+}
+
+void UEnemyCrowdSubsystem::PromoteNearbyProxies( )
+{
+	int32 Promotions = 0;
+	for ( int32 Index = Proxies.Num( ) - 1; Index >= 0 && Promotions < MaxPromotionsPerFrame; --Index )
+	{
+		if ( IsNearViewer( Proxies.States[Index].Location, PromotionRadius ) )
+		{
+			Promote( Index );
+			++Promotions;
+		}
+	}
+}
+
+void UEnemyCrowdSubsystem::AdvanceProxies( float DeltaTime )
+{
+	for ( int32 Index = 0; Index < Proxies.Num( ); ++Index )
+	{
+		FEnemyCompactState& State = Proxies.States[Index];
+		const TArray<TWeakObjectPtr<AActor>>& Route = Routes[Proxies.Routes[Index]];
+		if ( Route.Num( ) == 0 || !Route.IsValidIndex( State.PatrolIndex ) ) continue;
+
+		const AActor* PatrolTarget = Route[State.PatrolIndex].Get( );
+		if ( PatrolTarget == nullptr ) continue;
+
+		const FEnemyProxyBatch& Batch = ProxyBatches[Instances.GetBatch( Index )];
+		FVector ToTarget = PatrolTarget->GetActorLocation( ) - State.Location;
+		ToTarget.Z = 0.0;
+		const double Distance = ToTarget.Size( );
+
+		if ( Distance <= Batch.AcceptanceRadius )
+		{
+			State.PatrolIndex = (State.PatrolIndex + 1) % Route.Num( );
+			continue;
+		}
+
+		const double Step = FMath::Min<double>( Batch.Speed * DeltaTime, Distance );
+		State.Location += ToTarget * (Step / Distance);
+		State.Yaw = FMath::RadiansToDegrees( FMath::Atan2( ToTarget.Y, ToTarget.X ) );
+	}
+}
+
+/*
+*  proxies step in straight lines between patrol points, a few times a second they are pulled back onto the navmesh
+*/
+void UEnemyCrowdSubsystem::ProjectProxiesToNavigation( )
+{
+	const UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>( GetWorld( ) );
+	if ( NavSys == nullptr ) return;
+
+	for ( int32 Index = 0; Index < Proxies.Num( ); ++Index )
+	{
+		FEnemyCompactState& State = Proxies.States[Index];
+		const float HalfHeight = ProxyBatches[Instances.GetBatch( Index )].HalfHeight;
+
+		FNavLocation NavLocation;
+		if ( NavSys->ProjectPointToNavigation( State.Location - FVector( 0.0, 0.0, HalfHeight ), NavLocation, NavProjectionExtent ) )
+		{
+			State.Location = NavLocation.Location + FVector( 0.0, 0.0, HalfHeight );
+		}
+	}
+}
+
+void UEnemyCrowdSubsystem::UpdateInstances( )
+{
+	Instances.UpdateTransforms( [this]( int32 Index ) { return GetProxyTransform( Index ); } );
+}
+
+FTransform UEnemyCrowdSubsystem::GetProxyTransform( int32 ProxyIndex ) const
+{
+	// place the proxy where the skeletal mesh would have been drawn
+	const FEnemyCompactState& State = Proxies.States[ProxyIndex];
+	return ProxyBatches[Instances.GetBatch( ProxyIndex )].MeshOffset * FTransform( FRotator( 0.f, State.Yaw, 0.f ), State.Location );
+}
+
+void UEnemyCrowdSubsystem::Demote( AEnemy* Enemy )
+{
+	const int32 BatchIndex = FindOrAddBatch( Enemy );
+	if ( BatchIndex == INDEX_NONE ) return;
+
+	FEnemyCompactState State;
+	Enemy->ExportCompactState( State );
+
+	Proxies.States.Add( State );
+	Proxies.Routes.Add( static_cast<uint16>( AddRoute( Enemy->GetPatrolTargets( ) ) ) );
+	Proxies.PersistentIds.Add( UStreamingDormancySubsystem::GetPersistentId( Enemy ) );
+	Proxies.Levels.Add( Enemy->GetLevel( ) );
+	Instances.AddEntry( BatchIndex, ProxyBatches[BatchIndex].MeshOffset * FTransform( FRotator( 0.f, State.Yaw, 0.f ), State.Location ) );
+
+	// the proxy is all that is kept; the actor waits in the pool for the next promotion, or goes when the pool is full
+	TArray<TWeakObjectPtr<AEnemy>>& Pool = EnemyPool.FindOrAdd( Enemy->GetClass( ) );
+	Pool.RemoveAllSwap( []( const TWeakObjectPtr<AEnemy>& Pooled ) { return !Pooled.IsValid( ); } );
+	if ( Pool.Num( ) < MaxPooledPerClass )
+	{
+		Enemy->Deactivate( );
+		Pool.Add( Enemy );
+	}
+	else
+	{
+		Enemy->Destroy( );
+	}
+}
+
+void UEnemyCrowdSubsystem::Promote( int32 ProxyIndex )
+{
+	const FEnemyProxyBatch& Batch = ProxyBatches[Instances.GetBatch( ProxyIndex )];
+	FEnemyCompactState State = Proxies.States[ProxyIndex];
+	FindGround( State.Location, Batch.HalfHeight, State.Location );
+
+	TArray<AActor*> PatrolTargets;
+	for ( const TWeakObjectPtr<AActor>& PatrolTarget : Routes[Proxies.Routes[ProxyIndex]] )
+	{
+		PatrolTargets.Add( PatrolTarget.Get( ) );
+	}
+	const FGuid PersistentId = Proxies.PersistentIds[ProxyIndex];
+
+	if ( AEnemy* Pooled = TakePooledEnemy( Batch.EnemyClass, Proxies.Levels[ProxyIndex].Get( ) ) )
+	{
+		Pooled->Reactivate( State, PersistentId, PatrolTargets );
+		RemoveProxy( ProxyIndex );
+		return;
+	}
+
+	FActorSpawnParameters SpawnParams;
+	// spawned into the placed enemy's cell, so it streams out with it
+	SpawnParams.OverrideLevel = Proxies.Levels[ProxyIndex].Get( );
+	// resolved like a teleport, the capsule is moved out of walls and other enemies rather than spawned inside them
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+	SpawnParams.CustomPreSpawnInitalization = [&State, &PatrolTargets, &PersistentId]( AActor* Actor )
+	{
+		AEnemy* Enemy = CastChecked<AEnemy>( Actor );
+		Enemy->SetPatrolTargets( PatrolTargets );
+		Enemy->PrepareRespawn( State, PersistentId );
+	};
+
+	// BeginPlay restores the state and enters it once, the actor registers itself with us again from there
+	AEnemy* Enemy = GetWorld( )->SpawnActor<AEnemy>( Batch.EnemyClass, State.Location, FRotator( 0.f, State.Yaw, 0.f ), SpawnParams );
+	if ( Enemy == nullptr ) return;
+
+	RemoveProxy( ProxyIndex );
+}
+
+AEnemy* UEnemyCrowdSubsystem::TakePooledEnemy( UClass* Class, const ULevel* Level )
+{
+	TArray<TWeakObjectPtr<AEnemy>>* Pool = EnemyPool.Find( Class );
+	if ( Pool == nullptr ) return nullptr;
+
+	for ( int32 Index = Pool->Num( ) - 1; Index >= 0; --Index )
+	{
+		AEnemy* Enemy = (*Pool)[Index].Get( );
+		if ( Enemy == nullptr || Enemy->IsActorBeingDestroyed( ) )
+		{
+			Pool->RemoveAtSwap( Index );
+			continue;
+		}
+		if ( Enemy->GetLevel( ) == Level )
+		{
+			Pool->RemoveAtSwap( Index );
+			return Enemy;
+		}
+	}
+	return nullptr;
+}
+
+void UEnemyCrowdSubsystem::RemoveProxy( int32 ProxyIndex )
+{
+	Instances.RemoveAtSwap( ProxyIndex );
+	Proxies.RemoveAtSwap( ProxyIndex );
+}
+
+bool UEnemyCrowdSubsystem::FindGround( const FVector& Location, float HalfHeight, FVector& OutLocation ) const
+{
+	const FVector Start = Location + FVector( 0.0, 0.0, NavProjectionExtent.Z );
+	const FVector End = Location - FVector( 0.0, 0.0, HalfHeight + NavProjectionExtent.Z );
+
+	FHitResult Hit;
+	FCollisionQueryParams Params( SCENE_QUERY_STAT( SlashCrowdGround ), false );
+	if ( !GetWorld( )->LineTraceSingleByObjectType( Hit, Start, End, FCollisionObjectQueryParams( ECollisionChannel::ECC_WorldStatic ), Params ) ) return false;
+
+	OutLocation = Hit.ImpactPoint + FVector( 0.0, 0.0, HalfHeight );
+	return true;
+}
+
+void UEnemyCrowdSubsystem::RecordProxies( USlashSaveSubsystem& Save ) const
+{
+	for ( int32 Index = 0; Index < Proxies.Num( ); ++Index )
+	{
+		Save.RecordEnemy( Proxies.Levels[Index].Get( ), Proxies.PersistentIds[Index], Proxies.States[Index] );
+	}
+}
+
+void UEnemyCrowdSubsystem::OnLevelRemoved( ULevel* Level, UWorld* World )
+{
+	if ( World != GetWorld( ) ) return;
+
+	USlashSaveSubsystem* Save = USlashSaveSubsystem::Get( this );
+	for ( int32 Index = Proxies.Num( ) - 1; Index >= 0; --Index )
+	{
+		// a null level means the whole world is going away
+		const ULevel* ProxyLevel = Proxies.Levels[Index].Get( );
+		if ( Level && ProxyLevel && ProxyLevel != Level ) continue;
+
+		if ( Save && ProxyLevel )
+		{
+			Save->RecordEnemy( ProxyLevel, Proxies.PersistentIds[Index], Proxies.States[Index] );
+		}
+		RemoveProxy( Index );
+	}
+
+	// parked actors of the cell go with it
+	for ( TPair<TObjectKey<UClass>, TArray<TWeakObjectPtr<AEnemy>>>& Pool : EnemyPool )
+	{
+		Pool.Value.RemoveAllSwap( [Level]( const TWeakObjectPtr<AEnemy>& Pooled ) { return !Pooled.IsValid( ) || Level == nullptr || Pooled->GetLevel( ) == Level; } );
+	}
+}
+
+int32 UEnemyCrowdSubsystem::FindOrAddBatch( AEnemy* Enemy )
+{
+	const int32 Existing = ProxyBatches.IndexOfByPredicate( [Enemy]( const FEnemyProxyBatch& Batch ) { return Batch.EnemyClass == Enemy->GetClass( ); } );
+	if ( Existing != INDEX_NONE ) return Existing;
+
+	// batches are added to both lists together, so their indices match
+	if ( Instances.AddBatch( GetWorld( ), Enemy->GetProxyMesh( ) ) == INDEX_NONE ) return INDEX_NONE;
+
+	FEnemyProxyBatch& Batch = ProxyBatches.AddDefaulted_GetRef( );
+	Batch.EnemyClass = Enemy->GetClass( );
+	Batch.MeshOffset = Enemy->GetMesh( )->GetRelativeTransform( );
+	Batch.HalfHeight = Enemy->GetCapsuleComponent( )->GetScaledCapsuleHalfHeight( );
+	const FEnemyTuning& Tuning = Enemy->GetTuning( );
+	Batch.Speed = Tuning.PatrollingSpeed;
+	Batch.AcceptanceRadius = Tuning.PatrolRadius;
+	return ProxyBatches.Num( ) - 1;
+}
+
+int32 UEnemyCrowdSubsystem::AddRoute( const TArray<AActor*>& PatrolTargets )
+{
+	TArray<TWeakObjectPtr<AActor>> Route( PatrolTargets );
+
+	const int32 Existing = Routes.IndexOfByKey( Route );
+	if ( Existing != INDEX_NONE ) return Existing;
+	return Routes.Add( MoveTemp( Route ) );
+}
@@ -0,0 +1,66 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Enemy/EnemyRoster.h"
+#include "Enemy/Enemy.h"
+#include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
+
+AEnemyRoster::AEnemyRoster( )
+{
+	bReplicates = true;
+	bAlwaysRelevant = true;
+	NetUpdateFrequency = 2.f;
+}
+
+void AEnemyRoster::GetLifetimeReplicatedProps( TArray<FLifetimeProperty>& OutLifetimeProps ) const
+{
+	Super::GetLifetimeReplicatedProps( OutLifetimeProps );
+
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+	DOREPLIFETIME_WITH_PARAMS_FAST( AEnemyRoster, Roster, Params );
+}
+
+void AEnemyRoster::AddEnemy( AEnemy* Enemy, const FEnemyNetState& State )
+{
+	EntryIndices.Add( Enemy );
+	FEnemyRosterEntry& Entry = Roster.Entries.AddDefaulted_GetRef( );
+	Entry.Enemy = Enemy;
+	Entry.Location = Enemy->GetActorLocation( );
+	Entry.State = State;
+	Roster.MarkItemDirty( Entry );
+	MarkRosterDirty( );
+}
+
+void AEnemyRoster::UpdateEnemy( AEnemy* Enemy, const FEnemyNetState& State )
+{
+	const int32 Index = EntryIndices.Find( Enemy );
+	if ( Index == INDEX_NONE )
+	{
+		AddEnemy( Enemy, State );
+		return;
+	}
+
+	FEnemyRosterEntry& Entry = Roster.Entries[Index];
+	Entry.Location = Enemy->GetActorLocation( );
+	Entry.State = State;
+	Roster.MarkItemDirty( Entry );
+	MarkRosterDirty( );
+}
+
+void AEnemyRoster::RemoveEnemy( AEnemy* Enemy )
+{
+	const int32 Index = EntryIndices.Find( Enemy );
+	if ( Index == INDEX_NONE ) return;
+
+	EntryIndices.RemoveAtSwap( Index );
+	Roster.Entries.RemoveAtSwap( Index );
+	Roster.MarkArrayDirty( );
+	MarkRosterDirty( );
+}
+
+void AEnemyRoster::MarkRosterDirty( )
+{
+	MARK_PROPERTY_DIRTY_FROM_NAME( AEnemyRoster, Roster, this );
+}
@@ -0,0 +1,74 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Enemy/EnemyStateMachine.h"
+#include "HAL/IConsoleManager.h"
+
+namespace EnemyStateMachine
+{
+	static constexpr int32 TraceCapacity = 1024;
+	static_assert( (TraceCapacity & (TraceCapacity - 1)) == 0, "Trace ring buffer is indexed with a mask" );
+
+	static FEnemyTransitionRecord TraceBuffer[TraceCapacity];
+	static uint64 TraceHead = 0;
+
+	static bool bTraceTransitions = false;
+	static FAutoConsoleVariableRef CVarTraceTransitions(
+		TEXT( "Slash.Enemy.TraceTransitions" ),
+		bTraceTransitions,
+		TEXT( "Record every enemy state transition into a ring buffer (see Slash.Enemy.DumpTransitions)" )
+	);
+
+	static const TCHAR* StateName( EEnemyState State )
+	{
+		static const TCHAR* Names[NumStates] = { TEXT( "Dead" ), TEXT( "Patrolling" ), TEXT( "Chasing" ), TEXT( "Attacking" ), TEXT( "Engaged" ) };
+		return Names[static_cast<int32>( State )];
+	}
+
+	static const TCHAR* EventName( EEnemyEvent Event )
+	{
+		static const TCHAR* Names[NumEvents] = { TEXT( "PawnSeen" ), TEXT( "Damaged" ), TEXT( "TargetLost" ), TEXT( "TargetOutOfReach" ), TEXT( "TargetInReach" ), TEXT( "AttackStarted" ), TEXT( "AttackEnded" ), TEXT( "Died" ) };
+		return Names[static_cast<int32>( Event )];
+	}
+
+	static FAutoConsoleCommand DumpTransitionsCommand(
+		TEXT( "Slash.Enemy.DumpTransitions" ),
+		TEXT( "Log the buffered enemy state transitions, oldest first" ),
+		FConsoleCommandDelegate::CreateLambda( []( )
+		{
+			TArray<FEnemyTransitionRecord> Records;
+			GetRecordedTransitions( Records );
+			for ( const FEnemyTransitionRecord& Record : Records )
+			{
+				UE_LOG( LogTemp, Log, TEXT( "%.4f enemy %u: %s --%s--> %s" ),
+					Record.Time, Record.EnemyId, StateName( Record.FromState ), EventName( Record.Event ), StateName( Record.ToState ) );
+			}
+		} )
+	);
+
+	void RecordTransition( const FEnemyTransitionRecord& Record )
+	{
+		TraceBuffer[TraceHead & (TraceCapacity - 1)] = Record;
+		++TraceHead;
+	}
+
+	bool IsTracingTransitions( )
+	{
+		return bTraceTransitions;
+	}
+
+	void GetRecordedTransitions( TArray<FEnemyTransitionRecord>& OutRecords )
+	{
+		const uint64 Count = FMath::Min<uint64>( TraceHead, TraceCapacity );
+		OutRecords.Reset( static_cast<int32>( Count ) );
+		for ( uint64 Index = TraceHead - Count; Index < TraceHead; ++Index )
+		{
+			OutRecords.Add( TraceBuffer[Index & (TraceCapacity - 1)] );
+		}
+	}
+
+	void ResetRecordedTransitions( )
+	{
+		TraceHead = 0;
+	}
+}
@@ -0,0 +1,36 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Enemy/EnemyTuningSubsystem.h"
+
+bool UEnemyTuningSubsystem::DoesSupportWorldType( const EWorldType::Type WorldType ) const
+{
+	// editor and preview worlds never begin play, so nothing there reads a row
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UEnemyTuningSubsystem::Initialize( FSubsystemCollectionBase& Collection )
+{
+	Super::Initialize( Collection );
+
+	Table = Cast<UEnemyTuningTable>( TablePath.TryLoad( ) );
+	if ( Table == nullptr )
+	{
+		UE_LOG( LogTemp, Error, TEXT( "Enemy tuning table '%s' could not be loaded, every enemy uses the default tuning. Set TablePath under [/Script/Slash.EnemyTuningSubsystem] to an existing UEnemyTuningTable" ), *TablePath.ToString( ) );
+		return;
+	}
+
+#if WITH_EDITOR
+	// pick up archetype edits that haven't been saved into the table yet; saving the table bakes it otherwise
+	if ( GetWorld( )->WorldType == EWorldType::PIE )
+	{
+		Table->Bake( );
+	}
+#endif
+}
+
+uint16 UEnemyTuningSubsystem::FindRow( const FSoftObjectPath& ArchetypePath ) const
+{
+	const int32 Row = Table ? Table->FindRow( ArchetypePath ) : INDEX_NONE;
+	return Row == INDEX_NONE ? DefaultRow : static_cast<uint16>( Row );
+}
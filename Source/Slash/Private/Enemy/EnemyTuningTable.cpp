@@ -0,0 +1,34 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Enemy/EnemyTuningTable.h"
+#include "UObject/ObjectSaveContext.h"
+
+int32 UEnemyTuningTable::FindRow( const FSoftObjectPath& ArchetypePath ) const
+{
+	if ( ArchetypePath.IsNull( ) ) return INDEX_NONE;
+	return RowArchetypes.IndexOfByKey( ArchetypePath );
+}
+
+#if WITH_EDITOR
+void UEnemyTuningTable::Bake( )
+{
+	RowArchetypes.Reset( Archetypes.Num( ) );
+	Rows.Reset( Archetypes.Num( ) );
+	for ( const TSoftObjectPtr<UEnemyArchetype>& SoftArchetype : Archetypes )
+	{
+		const UEnemyArchetype* Archetype = SoftArchetype.LoadSynchronous( );
+		if ( Archetype == nullptr || RowArchetypes.Contains( SoftArchetype.ToSoftObjectPath( ) ) ) continue;
+
+		RowArchetypes.Add( SoftArchetype.ToSoftObjectPath( ) );
+		Rows.Add( Archetype->Bake( ) );
+	}
+}
+
+void UEnemyTuningTable::PreSave( FObjectPreSaveContext ObjectSaveContext )
+{
+	Bake( );
+
+	Super::PreSave( ObjectSaveContext );
+}
+#endif
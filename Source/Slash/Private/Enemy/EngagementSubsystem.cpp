@@ -0,0 +1,146 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Enemy/EngagementSubsystem.h"
+#include "Enemy/Enemy.h"
+
+bool UEngagementSubsystem::TryAcquireAttackSlot( AEnemy* Enemy, AActor* Target )
+{
+	if ( Enemy == nullptr || Target == nullptr ) return false;
+	if ( HasAttackSlot( Enemy, Target ) ) return true;
+
+	// an enemy only ever engages one target
+	const TWeakObjectPtr<AActor>* PreviousTarget = EnemyTargets.Find( Enemy );
+	if ( PreviousTarget && PreviousTarget->Get( ) != Target )
+	{
+		ReleaseEnemy( Enemy );
+	}
+
+	FEngagement& Engagement = Engagements.FindOrAdd( Target );
+	Engagement.Attackers.RemoveAllSwap( []( const TWeakObjectPtr<AEnemy>& Attacker ) { return !Attacker.IsValid( ); } );
+	EnemyTargets.Add( Enemy, Target );
+
+	if ( Engagement.Attackers.Num( ) >= MaxAttackersPerTarget ) return false;
+
+	Engagement.Waiting.RemoveAllSwap( [Enemy]( const FWaitingEnemy& Waiting ) { return Waiting.Enemy.Get( ) == Enemy; } );
+	Engagement.Attackers.Add( Enemy );
+	return true;
+}
+
+bool UEngagementSubsystem::HasAttackSlot( const AEnemy* Enemy, AActor* Target ) const
+{
+	const FEngagement* Engagement = Engagements.Find( Target );
+	if ( Engagement == nullptr ) return false;
+
+	for ( const TWeakObjectPtr<AEnemy>& Attacker : Engagement->Attackers )
+	{
+		if ( Attacker.Get( ) == Enemy ) return true;
+	}
+	return false;
+}
+
+bool UEngagementSubsystem::HasFreeAttackSlot( AActor* Target ) const
+{
+	const FEngagement* Engagement = Engagements.Find( Target );
+	if ( Engagement == nullptr ) return MaxAttackersPerTarget > 0;
+
+	int32 NumAttackers = 0;
+	for ( const TWeakObjectPtr<AEnemy>& Attacker : Engagement->Attackers )
+	{
+		NumAttackers += Attacker.IsValid( ) ? 1 : 0;
+	}
+	return NumAttackers < MaxAttackersPerTarget;
+}
+
+void UEngagementSubsystem::ReleaseEnemy( AEnemy* Enemy )
+{
+	TWeakObjectPtr<AActor> Target;
+	if ( !EnemyTargets.RemoveAndCopyValue( Enemy, Target ) ) return;
+
+	FEngagement* Engagement = Engagements.Find( Target );
+	if ( Engagement )
+	{
+		RemoveFromEngagement( Enemy, *Engagement );
+		if ( Engagement->Attackers.Num( ) == 0 && Engagement->Waiting.Num( ) == 0 )
+		{
+			Engagements.Remove( Target );
+		}
+	}
+}
+
+FVector UEngagementSubsystem::GetRingLocation( AEnemy* Enemy, AActor* Target )
+{
+	if ( Enemy == nullptr || Target == nullptr ) return FVector::ZeroVector;
+
+	const FVector TargetLocation = Target->GetActorLocation( );
+	FEngagement& Engagement = Engagements.FindOrAdd( Target );
+
+	FWaitingEnemy* Waiting = Engagement.Waiting.FindByPredicate( [Enemy]( const FWaitingEnemy& Entry ) { return Entry.Enemy.Get( ) == Enemy; } );
+	if ( Waiting == nullptr )
+	{
+		Engagement.Waiting.RemoveAllSwap( []( const FWaitingEnemy& Entry ) { return !Entry.Enemy.IsValid( ); } );
+
+		FWaitingEnemy NewEntry;
+		NewEntry.Enemy = Enemy;
+		NewEntry.RingSlot = ChooseRingSlot( Engagement, Enemy->GetActorLocation( ) - TargetLocation );
+		Waiting = &Engagement.Waiting.Add_GetRef( NewEntry );
+		EnemyTargets.Add( Enemy, Target );
+	}
+
+	const int32 NumSlots = FMath::Max( SlotsPerRing, 1 );
+	const int32 Ring = Waiting->RingSlot / NumSlots;
+	const int32 SlotInRing = Waiting->RingSlot % NumSlots;
+
+	// stagger every other ring by half a slot so outer enemies can see past the inner ones
+	const float SlotAngle = 2.f * PI / NumSlots;
+	const float Angle = SlotAngle * (SlotInRing + ((Ring & 1) ? 0.5f : 0.f));
+	const float Radius = InnerRingRadius + Ring * RingSpacing;
+
+	return TargetLocation + FVector( FMath::Cos( Angle ), FMath::Sin( Angle ), 0.f ) * Radius;
+}
+
+void UEngagementSubsystem::Deinitialize( )
+{
+	Engagements.Empty( );
+	EnemyTargets.Empty( );
+
+	Super::Deinitialize( );
+}
+
+void UEngagementSubsystem::RemoveFromEngagement( AEnemy* Enemy, FEngagement& Engagement )
+{
+	Engagement.Attackers.RemoveAllSwap( [Enemy]( const TWeakObjectPtr<AEnemy>& Attacker ) { return !Attacker.IsValid( ) || Attacker.Get( ) == Enemy; } );
+	Engagement.Waiting.RemoveAllSwap( [Enemy]( const FWaitingEnemy& Waiting ) { return !Waiting.Enemy.IsValid( ) || Waiting.Enemy.Get( ) == Enemy; } );
+}
+
+int32 UEngagementSubsystem::ChooseRingSlot( const FEngagement& Engagement, const FVector& ToEnemy ) const
+{
+	const int32 NumSlots = FMath::Max( SlotsPerRing, 1 );
+	const float SlotAngle = 2.f * PI / NumSlots;
+	float Bearing = FMath::Atan2( ToEnemy.Y, ToEnemy.X );
+	if ( Bearing < 0.f ) Bearing += 2.f * PI;
+
+	// innermost ring first, then the free slot closest to the enemy's current bearing
+	for ( int32 Ring = 0; ; ++Ring )
+	{
+		const float RingOffset = (Ring & 1) ? 0.5f : 0.f;
+		int32 BestSlot = INDEX_NONE;
+		float BestDelta = TNumericLimits<float>::Max( );
+
+		for ( int32 Slot = 0; Slot < NumSlots; ++Slot )
+		{
+			const int32 RingSlot = Ring * NumSlots + Slot;
+			const bool bTaken = Engagement.Waiting.ContainsByPredicate( [RingSlot]( const FWaitingEnemy& Waiting ) { return Waiting.RingSlot == RingSlot; } );
+			if ( bTaken ) continue;
+
+			const float Delta = FMath::Abs( FMath::FindDeltaAngleRadians( Bearing, SlotAngle * (Slot + RingOffset) ) );
+			if ( Delta < BestDelta )
+			{
+				BestDelta = Delta;
+				BestSlot = RingSlot;
+			}
+		}
+
+		if ( BestSlot != INDEX_NONE ) return BestSlot;
+	}
+}
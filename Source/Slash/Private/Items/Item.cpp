@@ -7,6 +7,8 @@
 #include "Components/SphereComponent.h"
 #include "Characters/SlashCharacter.h"
 #include "NiagaraComponent.h"
+#include "World/SlashSaveSubsystem.h"
+#include "World/CombatAssetSubsystem.h"
 
 
 // Sets default values
@@ -31,11 +33,34 @@ void AItem::BeginPlay()
 {
 	Super::BeginPlay();
 
+	// picked up in an earlier visit to this cell
+	USlashSaveSubsystem* Save = USlashSaveSubsystem::Get( this );
+	if ( Save && Save->WasRemoved( this ) )
+	{
+		Destroy( );
+		return;
+	}
+
 	/*int32 AvgInt = Avg<int32>( 5, 3 );
 	UE_LOG( LogTemp, Warning, TEXT( "The average of 5 and 3 is: %d" ), AvgInt );*/
 
 	Sphere->OnComponentBeginOverlap.AddDynamic( this, &AItem::OnSphereOverlap );
 	Sphere->OnComponentEndOverlap.AddDynamic( this, &AItem::OnSphereEndOverlap );
+
+	if ( UCombatAssetSubsystem* CombatAssets = GetWorld( )->GetSubsystem<UCombatAssetSubsystem>( ) )
+	{
+		CombatAssets->AcquireBundle( this );
+	}
+}
+
+void AItem::EndPlay( const EEndPlayReason::Type EndPlayReason )
+{
+	if ( UCombatAssetSubsystem* CombatAssets = GetWorld( )->GetSubsystem<UCombatAssetSubsystem>( ) )
+	{
+		CombatAssets->ReleaseBundle( this );
+	}
+
+	Super::EndPlay( EndPlayReason );
 }
 
 float AItem::TransformedSin( )
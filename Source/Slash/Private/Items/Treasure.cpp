@@ -4,20 +4,42 @@
 #include "Items/Treasure.h"
 #include "Characters/SlashCharacter.h"
 #include "Kismet/GameplayStatics.h"
+#include "Sound/SoundBase.h"
+#include "World/SlashSaveSubsystem.h"
+
+ATreasure::ATreasure( )
+{
+	// sent once when it drops, then dormant until it is picked up
+	bReplicates = true;
+	NetDormancy = DORM_DormantAll;
+}
+
+void ATreasure::GatherCombatAssets( TArray<FSoftObjectPath>& OutAssets ) const
+{
+	AddCombatAsset( OutAssets, PickupSound.ToSoftObjectPath( ) );
+}
 
 void ATreasure::OnSphereOverlap( UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult )
 {
 	ASlashCharacter* SlashCharacter = Cast<ASlashCharacter>( OtherActor );
 	if ( SlashCharacter )
 	{
-		if ( PickupSound )
+		if ( USoundBase* Sound = PickupSound.Get( ) )
 		{
 			UGameplayStatics::PlaySoundAtLocation(
 				this,
-				PickupSound,
+				Sound,
 				GetActorLocation()
 			);
 		}
-		Destroy( );
+		// the server owns the pickup, clients only play the sound
+		if ( HasAuthority( ) )
+		{
+			if ( USlashSaveSubsystem* Save = USlashSaveSubsystem::Get( this ) )
+			{
+				Save->RecordRemoved( this );
+			}
+			Destroy( );
+		}
 	}
 }
@@ -0,0 +1,185 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Items/Weapons/ProjectileSubsystem.h"
+#include "World/DamageEventSubsystem.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Async/ParallelFor.h"
+#include "Engine/World.h"
+#include "Slash/SlashStats.h"
+
+void UProjectileSubsystem::FProjectiles::RemoveAtSwap( int32 Index )
+{
+	Locations.RemoveAtSwap( Index, 1, false );
+	PreviousLocations.RemoveAtSwap( Index, 1, false );
+	Velocities.RemoveAtSwap( Index, 1, false );
+	Ages.RemoveAtSwap( Index, 1, false );
+	Sweeps.RemoveAtSwap( Index, 1, false );
+	Causers.RemoveAtSwap( Index, 1, false );
+	Instigators.RemoveAtSwap( Index, 1, false );
+}
+
+bool UProjectileSubsystem::Fire( UProjectileType* Type, const FVector& Origin, const FVector& Direction, AActor* Causer, AController* Instigator )
+{
+	if ( Type == nullptr || Projectiles.Num( ) >= MaxProjectiles ) return false;
+
+	const int32 BatchIndex = FindOrAddBatch( Type );
+	if ( BatchIndex == INDEX_NONE ) return false;
+
+	Projectiles.Locations.Add( Origin );
+	Projectiles.PreviousLocations.Add( Origin );
+	Projectiles.Velocities.Add( Direction.GetSafeNormal( ) * Type->Speed );
+	Projectiles.Ages.Add( 0.f );
+	Projectiles.Sweeps.AddDefaulted( );
+	Projectiles.Causers.Add( Causer );
+	Projectiles.Instigators.Add( Instigator );
+	Instances.AddEntry( BatchIndex, FTransform( Direction.ToOrientationQuat( ), Origin ) );
+	return true;
+}
+
+void UProjectileSubsystem::Tick( float DeltaTime )
+{
+	SLASH_SCOPE_CYCLE_COUNTER( STAT_SlashProjectileTick );
+
+	if ( Projectiles.Num( ) > 0 )
+	{
+		ResolveSweeps( );
+		Integrate( DeltaTime );
+		IssueSweeps( );
+	}
+	UpdateInstances( );
+	SET_DWORD_STAT( STAT_SlashProjectilesInFlight, Projectiles.Num( ) );
+}
+
+TStatId UProjectileSubsystem::GetStatId( ) const
+{
+	return GET_STATID( STAT_SlashProjectileTick );
+}
+
+void UProjectileSubsystem::Deinitialize( )
+{
+	Projectiles = FProjectiles( );
+	Instances.Reset( );
+	Types.Empty( );
+
+	Super::Deinitialize( );
+}
+
+/*
+*  last frame's sweeps finished during the physics step; anything that hit is spent
+*/
+void UProjectileSubsystem::ResolveSweeps( )
+{
+	UWorld* World = GetWorld( );
+	UDamageEventSubsystem* DamageEvents = World->GetNetMode( ) != NM_Client ? World->GetSubsystem<UDamageEventSubsystem>( ) : nullptr;
+
+	FTraceDatum Datum;
+	for ( int32 Index = Projectiles.Num( ) - 1; Index >= 0; --Index )
+	{
+		const FTraceHandle& Sweep = Projectiles.Sweeps[Index];
+		if ( !Sweep.IsValid( ) || !World->QueryTraceData( Sweep, Datum ) ) continue;
+
+		const FHitResult* Hit = Datum.OutHits.FindByPredicate( []( const FHitResult& Result ) { return Result.bBlockingHit; } );
+		if ( Hit == nullptr ) continue;
+
+		AActor* HitActor = Hit->GetActor( );
+		if ( DamageEvents && HitActor )
+		{
+			FSlashDamageEvent Event;
+			Event.Target = HitActor;
+			Event.Causer = Projectiles.Causers[Index];
+			Event.Instigator = Projectiles.Instigators[Index];
+			Event.ImpactPoint = Hit->ImpactPoint;
+			Event.Damage = GetType( Index )->Damage;
+			DamageEvents->QueueDamage( Event );
+		}
+		RemoveProjectile( Index );
+	}
+}
+
+void UProjectileSubsystem::Integrate( float DeltaTime )
+{
+	const float GravityZ = GetWorld( )->GetGravityZ( );
+
+	// expire first so the parallel pass never has to remove anything
+	for ( int32 Index = Projectiles.Num( ) - 1; Index >= 0; --Index )
+	{
+		Projectiles.Ages[Index] += DeltaTime;
+		if ( Projectiles.Ages[Index] > GetType( Index )->Lifetime )
+		{
+			RemoveProjectile( Index );
+		}
+	}
+
+	const int32 NumProjectiles = Projectiles.Num( );
+	const int32 NumTasks = FMath::DivideAndRoundUp( NumProjectiles, FMath::Max( ProjectilesPerTask, 1 ) );
+	ParallelFor( NumTasks, [this, DeltaTime, GravityZ, NumProjectiles]( int32 TaskIndex )
+	{
+		const int32 First = TaskIndex * ProjectilesPerTask;
+		const int32 Last = FMath::Min( First + ProjectilesPerTask, NumProjectiles );
+		for ( int32 Index = First; Index < Last; ++Index )
+		{
+			FVector& Velocity = Projectiles.Velocities[Index];
+			FVector& Location = Projectiles.Locations[Index];
+			Velocity.Z += GravityZ * GetType( Index )->GravityScale * DeltaTime;
+			Projectiles.PreviousLocations[Index] = Location;
+			Location += Velocity * DeltaTime;
+		}
+	}, NumTasks > 1 ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread );
+}
+
+void UProjectileSubsystem::IssueSweeps( )
+{
+	UWorld* World = GetWorld( );
+	for ( int32 Index = 0; Index < Projectiles.Num( ); ++Index )
+	{
+		const UProjectileType* Type = GetType( Index );
+		AActor* Causer = Projectiles.Causers[Index].Get( );
+
+		FCollisionQueryParams Params( SCENE_QUERY_STAT( SlashProjectile ), false, Causer );
+		if ( Causer && Causer->GetOwner( ) )
+		{
+			Params.AddIgnoredActor( Causer->GetOwner( ) );
+		}
+
+		Projectiles.Sweeps[Index] = World->AsyncSweepByChannel(
+			EAsyncTraceType::Single,
+			Projectiles.PreviousLocations[Index],
+			Projectiles.Locations[Index],
+			FQuat::Identity,
+			Type->CollisionChannel,
+			FCollisionShape::MakeSphere( Type->Radius ),
+			Params
+		);
+	}
+}
+
+void UProjectileSubsystem::UpdateInstances( )
+{
+	// meshes point down +X, along the flight path
+	Instances.UpdateTransforms( [this]( int32 Index ) { return FTransform( Projectiles.Velocities[Index].ToOrientationQuat( ), Projectiles.Locations[Index] ); } );
+}
+
+int32 UProjectileSubsystem::FindOrAddBatch( UProjectileType* Type )
+{
+	const int32 Existing = Types.IndexOfByKey( Type );
+	if ( Existing != INDEX_NONE ) return Existing;
+
+	const int32 BatchIndex = Instances.AddBatch( GetWorld( ), Type->Mesh );
+	if ( BatchIndex == INDEX_NONE ) return INDEX_NONE;
+
+	Instances.GetInstances( BatchIndex )->SetCastShadow( false );
+	Types.Add( Type );
+	return BatchIndex;
+}
+
+const UProjectileType* UProjectileSubsystem::GetType( int32 Index ) const
+{
+	return Types[Instances.GetBatch( Index )];
+}
+
+void UProjectileSubsystem::RemoveProjectile( int32 Index )
+{
+	Instances.RemoveAtSwap( Index );
+	Projectiles.RemoveAtSwap( Index );
+}
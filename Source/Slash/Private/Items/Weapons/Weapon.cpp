@@ -4,14 +4,21 @@
 #include "Items/Weapons/Weapon.h"
 #include "Characters/SlashCharacter.h"
 #include "Kismet/GameplayStatics.h"
+#include "Sound/SoundBase.h"
 #include "Components/SphereComponent.h"
 #include "Components/BoxComponent.h"
 #include "Kismet/KismetSystemLibrary.h"
-#include "Interfaces/HitInterface.h"
+#include "World/DamageEventSubsystem.h"
+#include "World/HitstopSubsystem.h"
 #include "NiagaraComponent.h"
+#include "Slash/SlashStats.h"
 
 AWeapon::AWeapon( )
 {
+	// the server owns hits; clients only need to see where the weapon is held
+	bReplicates = true;
+	SetReplicateMovement( true );
+
 	WeaponBox = CreateDefaultSubobject<UBoxComponent>( TEXT( "WeaponBox" ) );
 	WeaponBox->SetupAttachment( GetRootComponent( ) );
 	WeaponBox->SetCollisionEnabled( ECollisionEnabled::NoCollision );
@@ -37,11 +44,11 @@ void AWeapon::Equip( USceneComponent* InParent, FName SocketName, AActor* NewOwn
 	SetInstigator( NewInstigator );
 	AttachMeshToSocket( InParent, SocketName );  
 	ItemState = EItemState::EIS_Equipped;
-	if ( EquipSound )
+	if ( USoundBase* Sound = EquipSound.Get( ) )
 	{
 		UGameplayStatics::PlaySoundAtLocation(
 			this,
-			EquipSound,
+			Sound,
 			GetActorLocation( )
 			);
 	}
@@ -62,6 +69,43 @@ void AWeapon::AttachMeshToSocket( USceneComponent* InParent, FName SocketName )
 	ItemMesh->AttachToComponent( InParent, TransformRules, SocketName );
 }
 
+void AWeapon::PrepareForEquippedSpawn( )
+{
+	// the pickup sphere and embers only matter for weapons lying in the world
+	if ( Sphere )
+	{
+		Sphere->SetCollisionEnabled( ECollisionEnabled::NoCollision );
+	}
+	if ( EmbersEffect )
+	{
+		EmbersEffect->bAutoActivate = false;
+	}
+	ItemState = EItemState::EIS_Equipped;
+}
+
+void AWeapon::GatherCombatAssets( TArray<FSoftObjectPath>& OutAssets ) const
+{
+	AddCombatAsset( OutAssets, EquipSound.ToSoftObjectPath( ) );
+}
+
+void AWeapon::ReturnToPool( )
+{
+	DetachFromActor( FDetachmentTransformRules::KeepWorldTransform );
+	ItemMesh->DetachFromComponent( FDetachmentTransformRules::KeepWorldTransform );
+	WeaponBox->SetCollisionEnabled( ECollisionEnabled::NoCollision );
+	IgnoreActors.Empty( );
+	SetOwner( nullptr );
+	SetInstigator( nullptr );
+	SetActorHiddenInGame( true );
+	SetActorTickEnabled( false );
+}
+
+void AWeapon::TakeFromPool( )
+{
+	SetActorHiddenInGame( false );
+	SetActorTickEnabled( true );
+}
+
 void AWeapon::OnSphereOverlap( UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult )
 {
 	Super::OnSphereOverlap( OverlappedComponent, OtherActor, OtherComp, OtherBodyIndex, bFromSweep, SweepResult );
@@ -74,6 +118,15 @@ void AWeapon::OnSphereEndOverlap( UPrimitiveComponent* OverlappedComponent, AAct
 
 void AWeapon::OnBoxOverlap( UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult )
 {
+	SLASH_SCOPE_CYCLE_COUNTER( STAT_SlashWeaponBoxOverlap );
+
+	// a swing is traced where its wielder is controlled: the server's own and the AI's apply directly,
+	// a remote player's only arrive through ServerRequestHit, checked against what that player saw
+	APawn* Wielder = Cast<APawn>( GetOwner( ) );
+	if ( Wielder && !Wielder->IsLocallyControlled( ) ) return;
+
+	INC_DWORD_STAT( STAT_SlashWeaponTraces );
+
 	const FVector Start = BoxTraceStart->GetComponentLocation( );
   	const FVector End = BoxTraceEnd->GetComponentLocation( );
 
@@ -99,25 +152,50 @@ void AWeapon::OnBoxOverlap( UPrimitiveComponent* OverlappedComponent, AActor* Ot
 		BoxHit,
 		true 
 	);
-	if ( BoxHit.GetActor( ) )
-	{
-		UGameplayStatics::ApplyDamage(
-			BoxHit.GetActor( ),
-			Damage,
-			GetInstigator( )->GetController( ),
-			this,
-			UDamageType::StaticClass( )
-		);
+	AActor* HitActor = BoxHit.GetActor( );
+	if ( HitActor == nullptr ) return;
 
-		IHitInterface* HitInterface = Cast<IHitInterface>( BoxHit.GetActor( ) );
-		if ( HitInterface )
+	if ( HasAuthority( ) )
+	{
+		ApplyHit( HitActor, BoxHit.ImpactPoint );
+	}
+	else
+	{
+		// a client's own swing: ask the server to confirm the hit
+		ASlashCharacter* Character = Cast<ASlashCharacter>( Wielder );
+		if ( Character && !IgnoreActors.Contains( HitActor ) )
 		{
-			HitInterface->Execute_GetHit( BoxHit.GetActor( ), BoxHit.ImpactPoint );
+			IgnoreActors.AddUnique( HitActor );
+			Character->RequestHit( HitActor, BoxHit.ImpactPoint );
 		}
-		IgnoreActors.AddUnique( BoxHit.GetActor( ) );
-		
-		 CreateFields( BoxHit.ImpactPoint );
+	}
+}
 
-		 
+void AWeapon::ApplyHit( AActor* HitActor, const FVector& ImpactPoint )
+{
+	if ( HitActor == nullptr || IgnoreActors.Contains( HitActor ) ) return;
+	IgnoreActors.AddUnique( HitActor );
+
+	UDamageEventSubsystem* DamageEvents = GetWorld( )->GetSubsystem<UDamageEventSubsystem>( );
+	if ( DamageEvents == nullptr ) return;
+
+	FSlashDamageEvent Event;
+	Event.Target = HitActor;
+	Event.Causer = this;
+	Event.Instigator = GetInstigator( ) ? GetInstigator( )->GetController( ) : nullptr;
+	Event.ImpactPoint = ImpactPoint;
+	Event.Damage = Damage;
+	DamageEvents->QueueDamage( Event );
+}
+
+void AWeapon::MulticastHitConfirmed_Implementation( const FVector_NetQuantize& FieldLocation, AActor* Victim )
+{
+	CreateFields( FieldLocation );
+
+	// CustomTimeDilation isn't replicated; each machine decides whether its player was in this hit
+	UHitstopSubsystem* Hitstop = GetWorld( )->GetSubsystem<UHitstopSubsystem>( );
+	if ( Hitstop && Victim )
+	{
+		Hitstop->AddHitPulse( GetOwner( ), Victim, HitstopDuration, HitstopDilation );
 	}
 }
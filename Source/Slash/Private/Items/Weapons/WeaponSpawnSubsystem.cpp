@@ -0,0 +1,139 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Items/Weapons/WeaponSpawnSubsystem.h"
+#include "Items/Weapons/Weapon.h"
+#include "Enemy/Enemy.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/World.h"
+#include "Slash/SlashStats.h"
+
+void UWeaponSpawnSubsystem::RequestWeapon( AEnemy* Enemy, TSubclassOf<AWeapon> WeaponClass, FName SocketName, bool bUrgent )
+{
+	if ( Enemy == nullptr || WeaponClass == nullptr ) return;
+
+	const int32 Existing = Requests.IndexOfByPredicate( [Enemy]( const FWeaponRequest& Request ) { return Request.Enemy.Get( ) == Enemy; } );
+	if ( Existing != INDEX_NONE )
+	{
+		if ( !bUrgent ) return;
+		Requests.RemoveAt( Existing );
+	}
+
+	FWeaponRequest Request;
+	Request.Enemy = Enemy;
+	Request.WeaponClass = WeaponClass;
+	Request.SocketName = SocketName;
+
+	if ( bUrgent )
+	{
+		Requests.Insert( Request, 0 );
+	}
+	else
+	{
+		Requests.Add( Request );
+	}
+}
+
+void UWeaponSpawnSubsystem::CancelRequests( AEnemy* Enemy )
+{
+	Requests.RemoveAll( [Enemy]( const FWeaponRequest& Request ) { return Request.Enemy.Get( ) == Enemy; } );
+}
+
+UStaticMeshComponent* UWeaponSpawnSubsystem::AttachLightweightWeapon( USkeletalMeshComponent* Parent, TSubclassOf<AWeapon> WeaponClass, FName SocketName )
+{
+	if ( Parent == nullptr || WeaponClass == nullptr ) return nullptr;
+
+	const AWeapon* WeaponDefaults = WeaponClass->GetDefaultObject<AWeapon>( );
+	const UStaticMeshComponent* DefaultMesh = WeaponDefaults ? WeaponDefaults->GetItemMesh( ) : nullptr;
+	if ( DefaultMesh == nullptr || DefaultMesh->GetStaticMesh( ) == nullptr ) return nullptr;
+
+	UStaticMeshComponent* WeaponMesh = NewObject<UStaticMeshComponent>( Parent->GetOwner( ) );
+	WeaponMesh->SetStaticMesh( DefaultMesh->GetStaticMesh( ) );
+	WeaponMesh->SetCollisionEnabled( ECollisionEnabled::NoCollision );
+	WeaponMesh->SetGenerateOverlapEvents( false );
+	WeaponMesh->SetCanEverAffectNavigation( false );
+	WeaponMesh->SetupAttachment( Parent, SocketName );
+	WeaponMesh->RegisterComponent( );
+	return WeaponMesh;
+}
+
+void UWeaponSpawnSubsystem::ReleaseWeapon( AWeapon* Weapon )
+{
+	if ( Weapon == nullptr ) return;
+
+	TArray<TWeakObjectPtr<AWeapon>>& Pooled = Pool.FindOrAdd( Weapon->GetClass( ) );
+	if ( Pooled.Num( ) >= MaxPooledPerClass )
+	{
+		Weapon->Destroy( );
+		return;
+	}
+
+	Weapon->ReturnToPool( );
+	Pooled.Add( Weapon );
+}
+
+void UWeaponSpawnSubsystem::Tick( float DeltaTime )
+{
+	SLASH_SCOPE_TRACE( STAT_SlashWeaponSpawnTick );
+	int32 Processed = 0;
+	int32 Spawned = 0;
+	while ( Processed < Requests.Num( ) && Spawned < MaxSpawnsPerFrame )
+	{
+		const FWeaponRequest Request = Requests[Processed++];
+		AEnemy* Enemy = Request.Enemy.Get( );
+		if ( Enemy == nullptr ) continue;
+
+		AWeapon* Weapon = AcquireWeapon( Request.WeaponClass, Enemy );
+		if ( Weapon == nullptr ) continue;
+
+		Weapon->Equip( Enemy->GetMesh( ), Request.SocketName, Enemy, Enemy );
+		Enemy->OnDefaultWeaponReady( Weapon );
+		++Spawned;
+	}
+
+	if ( Processed > 0 )
+	{
+		Requests.RemoveAt( 0, Processed, false );
+	}
+
+	SET_DWORD_STAT( STAT_SlashPendingWeaponSpawns, Requests.Num( ) );
+}
+
+TStatId UWeaponSpawnSubsystem::GetStatId( ) const
+{
+	return GET_STATID( STAT_SlashWeaponSpawnTick );
+}
+
+void UWeaponSpawnSubsystem::Deinitialize( )
+{
+	Requests.Empty( );
+	Pool.Empty( );
+
+	Super::Deinitialize( );
+}
+
+AWeapon* UWeaponSpawnSubsystem::AcquireWeapon( TSubclassOf<AWeapon> WeaponClass, AEnemy* Enemy )
+{
+	if ( TArray<TWeakObjectPtr<AWeapon>>* Pooled = Pool.Find( WeaponClass ) )
+	{
+		while ( Pooled->Num( ) > 0 )
+		{
+			AWeapon* Weapon = Pooled->Pop( false ).Get( );
+			if ( Weapon )
+			{
+				Weapon->TakeFromPool( );
+				return Weapon;
+			}
+		}
+	}
+
+	// deferred so the pickup-only parts (embers, pickup sphere) never get activated or build physics state
+	const FTransform SpawnTransform = Enemy->GetActorTransform( );
+	AWeapon* Weapon = GetWorld( )->SpawnActorDeferred<AWeapon>( WeaponClass, SpawnTransform, Enemy, Enemy, ESpawnActorCollisionHandlingMethod::AlwaysSpawn );
+	if ( Weapon == nullptr ) return nullptr;
+
+	Weapon->PrepareForEquippedSpawn( );
+	Weapon->FinishSpawning( SpawnTransform );
+	return Weapon;
+}
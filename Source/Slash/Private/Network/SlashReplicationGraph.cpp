@@ -0,0 +1,268 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Network/SlashReplicationGraph.h"
+#include "Enemy/Enemy.h"
+#include "Characters/SlashCharacter.h"
+#include "Items/Weapons/Weapon.h"
+#include "Items/Treasure.h"
+#include "Breakables/BreakableActor.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Slash/SlashStats.h"
+
+void USlashReplicationGraph::InitGlobalActorClassSettings( )
+{
+	Super::InitGlobalActorClassSettings( );
+
+	FParse::Value( FCommandLine::Get( ), TEXT( "SlashNetSoak=" ), SoakReportInterval );
+
+	// breakables are placed in the level and never move, treasure sits still until it is picked up
+	ClassRepNodePolicies.Set( AEnemy::StaticClass( ), ESlashClassRepNodeMapping::ESCRNM_Spatialize_Dynamic );
+	ClassRepNodePolicies.Set( ASlashCharacter::StaticClass( ), ESlashClassRepNodeMapping::ESCRNM_Spatialize_Dynamic );
+	ClassRepNodePolicies.Set( AWeapon::StaticClass( ), ESlashClassRepNodeMapping::ESCRNM_Spatialize_Dynamic );
+	ClassRepNodePolicies.Set( ABreakableActor::StaticClass( ), ESlashClassRepNodeMapping::ESCRNM_Spatialize_Static );
+	ClassRepNodePolicies.Set( ATreasure::StaticClass( ), ESlashClassRepNodeMapping::ESCRNM_Spatialize_Dormancy );
+
+	SetClassCullDistance( AEnemy::StaticClass( ), EnemyCullDistance );
+	SetClassCullDistance( ASlashCharacter::StaticClass( ), EnemyCullDistance );
+	SetClassCullDistance( AWeapon::StaticClass( ), EnemyCullDistance );
+	SetClassCullDistance( ABreakableActor::StaticClass( ), BreakableCullDistance );
+	SetClassCullDistance( ATreasure::StaticClass( ), TreasureCullDistance );
+}
+
+void USlashReplicationGraph::SetClassCullDistance( UClass* Class, float CullDistance )
+{
+	const AActor* ActorCDO = Class->GetDefaultObject<AActor>( );
+
+	FClassReplicationInfo ClassInfo;
+	ClassInfo.SetCullDistanceSquared( FMath::Square( CullDistance ) );
+	ClassInfo.ReplicationPeriodFrame = GetReplicationPeriodFrameForFrequency( ActorCDO->NetUpdateFrequency );
+	GlobalActorReplicationInfoMap.SetClassInfo( Class, ClassInfo );
+}
+
+void USlashReplicationGraph::InitGlobalGraphNodes( )
+{
+	GridNode = CreateNewNode<UReplicationGraphNode_GridSpatialization2D>( );
+	GridNode->CellSize = GridCellSize;
+	GridNode->SpatialBias = SpatialBias;
+	AddGlobalGraphNode( GridNode );
+
+	AlwaysRelevantNode = CreateNewNode<UReplicationGraphNode_ActorList>( );
+	AddGlobalGraphNode( AlwaysRelevantNode );
+}
+
+void USlashReplicationGraph::InitConnectionGraphNodes( UNetReplicationGraphConnection* RepGraphConnection )
+{
+	Super::InitConnectionGraphNodes( RepGraphConnection );
+
+	USlashReplicationGraphNode_AlwaysRelevant_ForConnection* Node = CreateNewNode<USlashReplicationGraphNode_AlwaysRelevant_ForConnection>( );
+	AddConnectionGraphNode( Node, RepGraphConnection );
+	AlwaysRelevantForConnection.Add( RepGraphConnection->NetConnection, Node );
+}
+
+void USlashReplicationGraph::RemoveClientConnection( UNetConnection* NetConnection )
+{
+	AlwaysRelevantForConnection.Remove( NetConnection );
+
+	Super::RemoveClientConnection( NetConnection );
+}
+
+ESlashClassRepNodeMapping USlashReplicationGraph::GetMappingPolicy( UClass* Class )
+{
+	if ( const ESlashClassRepNodeMapping* Policy = ClassRepNodePolicies.Get( Class ) )
+	{
+		return *Policy;
+	}
+
+	// anything not listed above is routed by its replication flags
+	const AActor* ActorCDO = Class->GetDefaultObject<AActor>( );
+	ESlashClassRepNodeMapping Policy = ESlashClassRepNodeMapping::ESCRNM_Spatialize_Dynamic;
+	if ( ActorCDO == nullptr || !ActorCDO->GetIsReplicated( ) )
+	{
+		Policy = ESlashClassRepNodeMapping::ESCRNM_NotRouted;
+	}
+	else if ( ActorCDO->bAlwaysRelevant )
+	{
+		Policy = ESlashClassRepNodeMapping::ESCRNM_RelevantAllConnections;
+	}
+	else if ( ActorCDO->bOnlyRelevantToOwner )
+	{
+		Policy = ESlashClassRepNodeMapping::ESCRNM_RelevantOwnerConnection;
+	}
+
+	ClassRepNodePolicies.Set( Class, Policy );
+	return Policy;
+}
+
+void USlashReplicationGraph::RouteAddNetworkActorToNodes( const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo )
+{
+	switch ( GetMappingPolicy( ActorInfo.Class ) )
+	{
+	case ESlashClassRepNodeMapping::ESCRNM_RelevantAllConnections:
+		AlwaysRelevantNode->NotifyAddNetworkActor( ActorInfo );
+		break;
+	case ESlashClassRepNodeMapping::ESCRNM_RelevantOwnerConnection:
+		ActorsWithoutNetConnection.Add( ActorInfo.Actor );
+		break;
+	case ESlashClassRepNodeMapping::ESCRNM_Spatialize_Static:
+		GridNode->AddActor_Static( ActorInfo, GlobalInfo );
+		break;
+	case ESlashClassRepNodeMapping::ESCRNM_Spatialize_Dynamic:
+		GridNode->AddActor_Dynamic( ActorInfo, GlobalInfo );
+		break;
+	case ESlashClassRepNodeMapping::ESCRNM_Spatialize_Dormancy:
+		GridNode->AddActor_Dormancy( ActorInfo, GlobalInfo );
+		break;
+	default:
+		break;
+	}
+}
+
+void USlashReplicationGraph::RouteRemoveNetworkActorToNodes( const FNewReplicatedActorInfo& ActorInfo )
+{
+	switch ( GetMappingPolicy( ActorInfo.Class ) )
+	{
+	case ESlashClassRepNodeMapping::ESCRNM_RelevantAllConnections:
+		AlwaysRelevantNode->NotifyRemoveNetworkActor( ActorInfo );
+		break;
+	case ESlashClassRepNodeMapping::ESCRNM_RelevantOwnerConnection:
+	{
+		ActorsWithoutNetConnection.Remove( ActorInfo.Actor );
+		UNetConnection* Connection = ActorInfo.Actor ? ActorInfo.Actor->GetNetConnection( ) : nullptr;
+		USlashReplicationGraphNode_AlwaysRelevant_ForConnection* Node = GetAlwaysRelevantNodeForConnection( Connection );
+		if ( Node == nullptr || !Node->NotifyRemoveNetworkActor( ActorInfo, false ) )
+		{
+			// mid teardown the actor may have lost its owner already; it can only be in one connection's list
+			for ( const TPair<UNetConnection*, USlashReplicationGraphNode_AlwaysRelevant_ForConnection*>& Pair : AlwaysRelevantForConnection )
+			{
+				if ( Pair.Value && Pair.Value->NotifyRemoveNetworkActor( ActorInfo, false ) ) break;
+			}
+		}
+		break;
+	}
+	case ESlashClassRepNodeMapping::ESCRNM_Spatialize_Static:
+		GridNode->RemoveActor_Static( ActorInfo );
+		break;
+	case ESlashClassRepNodeMapping::ESCRNM_Spatialize_Dynamic:
+		GridNode->RemoveActor_Dynamic( ActorInfo );
+		break;
+	case ESlashClassRepNodeMapping::ESCRNM_Spatialize_Dormancy:
+		GridNode->RemoveActor_Dormancy( ActorInfo );
+		break;
+	default:
+		break;
+	}
+}
+
+void USlashReplicationGraph::FlushActorsWithoutNetConnection( )
+{
+	for ( int32 Index = ActorsWithoutNetConnection.Num( ) - 1; Index >= 0; --Index )
+	{
+		AActor* Actor = ActorsWithoutNetConnection[Index];
+		UNetConnection* Connection = Actor ? Actor->GetNetConnection( ) : nullptr;
+		if ( Actor && Connection == nullptr ) continue;
+
+		if ( USlashReplicationGraphNode_AlwaysRelevant_ForConnection* Node = GetAlwaysRelevantNodeForConnection( Connection ) )
+		{
+			Node->NotifyAddNetworkActor( FNewReplicatedActorInfo( Actor ) );
+		}
+		ActorsWithoutNetConnection.RemoveAtSwap( Index, 1, false );
+	}
+}
+
+USlashReplicationGraphNode_AlwaysRelevant_ForConnection* USlashReplicationGraph::GetAlwaysRelevantNodeForConnection( UNetConnection* Connection ) const
+{
+	USlashReplicationGraphNode_AlwaysRelevant_ForConnection* const* Node = Connection ? AlwaysRelevantForConnection.Find( Connection ) : nullptr;
+	return Node ? *Node : nullptr;
+}
+
+int32 USlashReplicationGraph::ServerReplicateActors( float DeltaSeconds )
+{
+	FlushActorsWithoutNetConnection( );
+
+	const double StartTime = FPlatformTime::Seconds( );
+	int32 NumReplicated = 0;
+	{
+		SLASH_SCOPE_CYCLE_COUNTER( STAT_SlashReplicateActors );
+		NumReplicated = Super::ServerReplicateActors( DeltaSeconds );
+	}
+
+	if ( SoakReportInterval > 0.f )
+	{
+		AccumulateSoakStats( FPlatformTime::Seconds( ) - StartTime, DeltaSeconds );
+	}
+	return NumReplicated;
+}
+
+void USlashReplicationGraph::AccumulateSoakStats( double ReplicateSeconds, float DeltaSeconds )
+{
+	++SoakFrames;
+	SoakReplicateSeconds += ReplicateSeconds;
+	SoakElapsedSeconds += DeltaSeconds;
+	if ( SoakElapsedSeconds < SoakReportInterval ) return;
+
+	const int32 NumConnections = NetDriver ? NetDriver->ClientConnections.Num( ) : 0;
+	const double ReplicateMs = SoakReplicateSeconds * 1000.0 / SoakFrames;
+	const double ReplicateMsPerConnection = ReplicateMs / FMath::Max( NumConnections, 1 );
+	const uint32 OutBytesPerSecond = NetDriver ? NetDriver->OutBytesPerSecond : 0;
+	const uint32 InBytesPerSecond = NetDriver ? NetDriver->InBytesPerSecond : 0;
+	const uint32 OutBytesPerConnection = OutBytesPerSecond / FMath::Max( NumConnections, 1 );
+
+	const FString SoakPath = FPaths::ProfilingDir( ) / TEXT( "SlashNetSoak.csv" );
+	if ( !IFileManager::Get( ).FileExists( *SoakPath ) )
+	{
+		FFileHelper::SaveStringToFile(
+			TEXT( "Timestamp,Map,Connections,Frames,ReplicateMs,ReplicateMsPerConnection,OutBytesPerSec,OutBytesPerSecPerConnection,InBytesPerSec\n" ),
+			*SoakPath );
+	}
+
+	const FString MapName = GetWorld( ) ? UWorld::RemovePIEPrefix( GetWorld( )->GetMapName( ) ) : FString( );
+	const FString Row = FString::Printf( TEXT( "%s,%s,%d,%d,%.3f,%.3f,%u,%u,%u\n" ),
+		*FDateTime::Now( ).ToString( ), *MapName, NumConnections, SoakFrames, ReplicateMs, ReplicateMsPerConnection,
+		OutBytesPerSecond, OutBytesPerConnection, InBytesPerSecond );
+	FFileHelper::SaveStringToFile( Row, *SoakPath, FFileHelper::EEncodingOptions::AutoDetect, &IFileManager::Get( ), FILEWRITE_Append );
+
+	UE_LOG( LogTemp, Display, TEXT( "Net soak: %d connections, replicate %.3f ms/frame (%.3f ms per connection), out %u B/s (%u B/s per connection), in %u B/s" ),
+		NumConnections, ReplicateMs, ReplicateMsPerConnection, OutBytesPerSecond, OutBytesPerConnection, InBytesPerSecond );
+
+	SoakFrames = 0;
+	SoakReplicateSeconds = 0.0;
+	SoakElapsedSeconds = 0.0;
+}
+
+void USlashReplicationGraph::NotifyUpdateFrequencyChanged( AActor* Actor )
+{
+	UNetDriver* ActorNetDriver = Actor ? Actor->GetNetDriver( ) : nullptr;
+	USlashReplicationGraph* Graph = ActorNetDriver ? Cast<USlashReplicationGraph>( ActorNetDriver->GetReplicationDriver( ) ) : nullptr;
+	if ( Graph == nullptr ) return;
+
+	if ( FGlobalActorReplicationInfo* GlobalInfo = Graph->GlobalActorReplicationInfoMap.Find( Actor ) )
+	{
+		GlobalInfo->Settings.ReplicationPeriodFrame = Graph->GetReplicationPeriodFrameForFrequency( Actor->NetUpdateFrequency );
+	}
+}
+
+void USlashReplicationGraphNode_AlwaysRelevant_ForConnection::GatherActorListsForConnection( const FConnectionGatherActorListParameters& Params )
+{
+	Super::GatherActorListsForConnection( Params );
+
+	EquippedWeapons.Reset( );
+	for ( const FNetViewer& Viewer : Params.Viewers )
+	{
+		const ABaseCharacter* Character = Cast<ABaseCharacter>( Viewer.ViewTarget );
+		AWeapon* Weapon = Character ? Character->GetEquippedWeapon( ) : nullptr;
+		if ( Weapon && Weapon->GetIsReplicated( ) )
+		{
+			EquippedWeapons.Add( Weapon );
+		}
+	}
+
+	if ( EquippedWeapons.Num( ) > 0 )
+	{
+		Params.OutGatheredReplicationLists.AddReplicationActorList( EquippedWeapons );
+	}
+}
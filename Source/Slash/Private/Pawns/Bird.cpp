@@ -9,6 +9,7 @@
 #include "EnhancedInputComponent.h"
 #include "GameFramework/SpringArmComponent.h"
 #include "Camera/CameraComponent.h"
+#include "Components/BirdMovementComponent.h"
 
 // Sets default values
 ABird::ABird()
@@ -27,10 +28,16 @@ ABird::ABird()
 	CameraBoom = CreateDefaultSubobject<USpringArmComponent>( TEXT( "CameraBoom" ) );
 	CameraBoom->SetupAttachment( GetRootComponent( ) );
 	CameraBoom->TargetArmLength = 300.f;
+	CameraBoom->bUsePawnControlRotation = true;
 
 	ViewCamera = CreateDefaultSubobject<UCameraComponent>( TEXT( "ViewCamera" ) );
 	ViewCamera->SetupAttachment( CameraBoom );
 
+	// the flight model turns the bird toward the control rotation itself
+	bUseControllerRotationYaw = false;
+	FlightMovement = CreateDefaultSubobject<UBirdMovementComponent>( TEXT( "FlightMovement" ) );
+	FlightMovement->UpdatedComponent = Capsule;
+
 	AutoPossessPlayer = EAutoReceiveInput::Player0;
 }
 
@@ -80,6 +87,11 @@ void ABird::Tick(float DeltaTime)
 
 }
 
+UPawnMovementComponent* ABird::GetMovementComponent( ) const
+{
+	return FlightMovement;
+}
+
 // Called to bind functionality to input
 void ABird::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
 {
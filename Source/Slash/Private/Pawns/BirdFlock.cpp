@@ -0,0 +1,201 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Pawns/BirdFlock.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Async/ParallelFor.h"
+#include "Slash/SlashStats.h"
+
+namespace BirdFlock
+{
+	// power of two, so a bucket is a mask away from the cell hash
+	static constexpr uint32 NumBuckets = 4096;
+}
+
+ABirdFlock::ABirdFlock( )
+{
+	PrimaryActorTick.bCanEverTick = true;
+
+	Instances = CreateDefaultSubobject<UInstancedStaticMeshComponent>( TEXT( "Instances" ) );
+	Instances->SetCollisionEnabled( ECollisionEnabled::NoCollision );
+	Instances->SetCastShadow( false );
+	Instances->SetMobility( EComponentMobility::Movable );
+	SetRootComponent( Instances );
+}
+
+void ABirdFlock::BeginPlay( )
+{
+	Super::BeginPlay( );
+
+	// cosmetic only, so it keeps its own stream rather than drawing from the replayed gameplay streams
+	FRandomStream Random( Seed );
+	const int32 Count = FMath::Max( NumBirds, 0 );
+
+	// the grid divides by it; ClampMin only guards the details panel
+	NeighbourRadius = FMath::Max( NeighbourRadius, 1.f );
+	Boids.Positions.SetNumUninitialized( Count );
+	Boids.Velocities.SetNumUninitialized( Count );
+	Boids.Steering.SetNumZeroed( Count );
+	SortedBoids.SetNumUninitialized( Count );
+	BoidBuckets.SetNumUninitialized( Count );
+	InstanceTransforms.SetNumUninitialized( Count );
+	for ( int32 Index = 0; Index < Count; ++Index )
+	{
+		Boids.Positions[Index] = FVector3f( Random.GetUnitVector( ) * Random.FRandRange( 0.f, Radius ) );
+		Boids.Velocities[Index] = FVector3f( Random.GetUnitVector( ) * Random.FRandRange( MinSpeed, MaxSpeed ) );
+		InstanceTransforms[Index] = FTransform( FQuat( Boids.Velocities[Index].ToOrientationQuat( ) ), FVector( Boids.Positions[Index] ) );
+	}
+
+	Instances->ClearInstances( );
+	Instances->AddInstances( InstanceTransforms, false );
+}
+
+void ABirdFlock::Tick( float DeltaTime )
+{
+	Super::Tick( DeltaTime );
+
+	if ( Boids.Num( ) == 0 || !Instances->WasRecentlyRendered( 0.5f ) ) return;
+	SLASH_SCOPE_CYCLE_COUNTER( STAT_SlashBirdFlock );
+
+	BuildGrid( );
+	Steer( );
+	Integrate( DeltaTime );
+	Instances->BatchUpdateInstancesTransforms( 0, InstanceTransforms, false, true );
+}
+
+FIntVector ABirdFlock::GetCell( const FVector3f& Position ) const
+{
+	return FIntVector(
+		FMath::FloorToInt32( Position.X / NeighbourRadius ),
+		FMath::FloorToInt32( Position.Y / NeighbourRadius ),
+		FMath::FloorToInt32( Position.Z / NeighbourRadius ) );
+}
+
+uint32 ABirdFlock::GetBucket( const FIntVector& Cell )
+{
+	return ( uint32( Cell.X ) * 73856093u ^ uint32( Cell.Y ) * 19349663u ^ uint32( Cell.Z ) * 83492791u ) & ( BirdFlock::NumBuckets - 1 );
+}
+
+/*
+*  counting sort by bucket: two passes over the birds, no per-cell containers
+*/
+void ABirdFlock::BuildGrid( )
+{
+	const int32 NumBoids = Boids.Num( );
+	BucketStarts.SetNumZeroed( BirdFlock::NumBuckets + 1, false );
+	for ( int32 Index = 0; Index < NumBoids; ++Index )
+	{
+		BoidBuckets[Index] = GetBucket( GetCell( Boids.Positions[Index] ) );
+		++BucketStarts[BoidBuckets[Index]];
+	}
+
+	int32 Start = 0;
+	for ( uint32 Bucket = 0; Bucket <= BirdFlock::NumBuckets; ++Bucket )
+	{
+		const int32 Count = BucketStarts[Bucket];
+		BucketStarts[Bucket] = Start;
+		Start += Count;
+	}
+
+	// scatter with each bucket's start as its cursor, which leaves it on the next bucket's start; shift back after
+	for ( int32 Index = 0; Index < NumBoids; ++Index )
+	{
+		SortedBoids[BucketStarts[BoidBuckets[Index]]++] = Index;
+	}
+	for ( uint32 Bucket = BirdFlock::NumBuckets; Bucket > 0; --Bucket )
+	{
+		BucketStarts[Bucket] = BucketStarts[Bucket - 1];
+	}
+	BucketStarts[0] = 0;
+}
+
+void ABirdFlock::Steer( )
+{
+	const int32 NumBoids = Boids.Num( );
+	const int32 PerTask = FMath::Max( BirdsPerTask, 1 );
+	const int32 NumTasks = FMath::DivideAndRoundUp( NumBoids, PerTask );
+	const float NeighbourRadiusSquared = FMath::Square( NeighbourRadius );
+	ParallelFor( NumTasks, [this, NumBoids, PerTask, NeighbourRadiusSquared]( int32 TaskIndex )
+	{
+		const int32 First = TaskIndex * PerTask;
+		const int32 Last = FMath::Min( First + PerTask, NumBoids );
+		for ( int32 Index = First; Index < Last; ++Index )
+		{
+			const FVector3f Position = Boids.Positions[Index];
+			const FVector3f Velocity = Boids.Velocities[Index];
+			FVector3f Separation = FVector3f::ZeroVector;
+			FVector3f Heading = FVector3f::ZeroVector;
+			FVector3f Centre = FVector3f::ZeroVector;
+			int32 Neighbours = 0;
+
+			// neighbouring cells can share a bucket, so each bucket is only walked once
+			TArray<uint32, TInlineAllocator<27>> Visited;
+			const FIntVector Cell = GetCell( Position );
+			for ( int32 Z = -1; Z <= 1; ++Z )
+			for ( int32 Y = -1; Y <= 1; ++Y )
+			for ( int32 X = -1; X <= 1; ++X )
+			{
+				const uint32 Bucket = GetBucket( Cell + FIntVector( X, Y, Z ) );
+				if ( Visited.Contains( Bucket ) ) continue;
+				Visited.Add( Bucket );
+
+				for ( int32 Slot = BucketStarts[Bucket]; Slot < BucketStarts[Bucket + 1]; ++Slot )
+				{
+					const int32 Other = SortedBoids[Slot];
+					const FVector3f Offset = Position - Boids.Positions[Other];
+					const float DistanceSquared = Offset.SizeSquared( );
+					if ( Other == Index || DistanceSquared > NeighbourRadiusSquared ) continue;
+
+					++Neighbours;
+					Heading += Boids.Velocities[Other];
+					Centre += Boids.Positions[Other];
+					const float Distance = FMath::Sqrt( DistanceSquared );
+					if ( Distance < SeparationRadius && Distance > KINDA_SMALL_NUMBER )
+					{
+						Separation += Offset / Distance * ( 1.f - Distance / SeparationRadius );
+					}
+				}
+			}
+
+			FVector3f Steering = Separation * ( SeparationWeight * MaxSteering );
+			if ( Neighbours > 0 )
+			{
+				Steering += ( Heading / float( Neighbours ) - Velocity ) * AlignmentWeight;
+				Steering += ( Centre / float( Neighbours ) - Position ) * CohesionWeight;
+			}
+			const float HomeDistance = Position.Size( );
+			if ( HomeDistance > Radius )
+			{
+				Steering -= Position / HomeDistance * ( ( HomeDistance - Radius ) * HomeWeight );
+			}
+			Boids.Steering[Index] = Steering.GetClampedToMaxSize( MaxSteering );
+		}
+	}, NumTasks > 1 ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread );
+}
+
+void ABirdFlock::Integrate( float DeltaTime )
+{
+	const int32 NumBoids = Boids.Num( );
+	const int32 PerTask = FMath::Max( BirdsPerTask, 1 );
+	const int32 NumTasks = FMath::DivideAndRoundUp( NumBoids, PerTask );
+	ParallelFor( NumTasks, [this, NumBoids, PerTask, DeltaTime]( int32 TaskIndex )
+	{
+		const int32 First = TaskIndex * PerTask;
+		const int32 Last = FMath::Min( First + PerTask, NumBoids );
+		for ( int32 Index = First; Index < Last; ++Index )
+		{
+			FVector3f& Velocity = Boids.Velocities[Index];
+			FVector3f& Position = Boids.Positions[Index];
+			Velocity += Boids.Steering[Index] * DeltaTime;
+			const float Speed = Velocity.Size( );
+			if ( Speed > KINDA_SMALL_NUMBER )
+			{
+				Velocity *= FMath::Clamp( Speed, MinSpeed, MaxSpeed ) / Speed;
+			}
+			Position += Velocity * DeltaTime;
+
+			// meshes point down +X, along the flight path
+			InstanceTransforms[Index] = FTransform( FQuat( Velocity.ToOrientationQuat( ) ), FVector( Position ) );
+		}
+	}, NumTasks > 1 ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread );
+}
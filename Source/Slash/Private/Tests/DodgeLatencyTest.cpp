@@ -0,0 +1,122 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Tests/SlashTestWorld.h"
+#include "Characters/SlashCharacter.h"
+#include "Items/Weapons/Weapon.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Misc/PackageName.h"
+
+namespace DodgeLatencyTest
+{
+	/* the native character has no montages, and without them no action ever ends */
+	const TCHAR* CharacterClassPath = TEXT( "/Game/Blueprints/Characters/BP_SlashCharacter.BP_SlashCharacter_C" );
+	const TCHAR* WeaponClassPath = TEXT( "/Game/Blueprints/Items/Weapons/BP_Weapon.BP_Weapon_C" );
+
+	constexpr float FrameRates[] = { 30.f, 60.f, 120.f };
+	constexpr int32 Seed = 1337;
+
+	/** How long before the swing frees the character the buffered dodge is pressed; well inside InputBufferTime */
+	constexpr float PressLeadSeconds = 0.2f;
+
+	/** Wall time per world tick, generous enough for a loaded build machine */
+	constexpr double TickSeconds = 0.05;
+}
+
+/*
+*  counts world ticks from the press to ActionState reaching EAS_Dodge, and compares that with the tick on which
+*  the same swing, played without a dodge pressed, frees the character
+*/
+IMPLEMENT_SIMPLE_AUTOMATION_TEST( FDodgeLatencyTest, "Slash.Combat.Player.DodgeLatency", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter )
+
+bool FDodgeLatencyTest::RunTest( const FString& Parameters )
+{
+	using namespace DodgeLatencyTest;
+
+	// a checkout without the content can't run this; say so instead of failing
+	if ( !FPackageName::DoesPackageExist( FPackageName::ObjectPathToPackageName( FString( CharacterClassPath ) ) ) ||
+		!FPackageName::DoesPackageExist( FPackageName::ObjectPathToPackageName( FString( WeaponClassPath ) ) ) )
+	{
+		AddWarning( FString::Printf( TEXT( "Skipped: %s or %s is missing" ), CharacterClassPath, WeaponClassPath ) );
+		return true;
+	}
+
+	UClass* CharacterClass = LoadClass<ASlashCharacter>( nullptr, CharacterClassPath );
+	UClass* WeaponClass = LoadClass<AWeapon>( nullptr, WeaponClassPath );
+	if ( !TestNotNull( TEXT( "Character blueprint" ), CharacterClass ) || !TestNotNull( TEXT( "Weapon blueprint" ), WeaponClass ) ) return false;
+
+	for ( const float FrameRate : FrameRates )
+	{
+		const float DeltaTime = 1.f / FrameRate;
+		const int32 TicksPerSecond = FMath::RoundToInt( FrameRate );
+		const int32 MaxTicks = 5 * TicksPerSecond;
+
+		FSlashTestWorld TestWorld( Seed );
+		ASlashCharacter* Character = Cast<ASlashCharacter>( TestWorld.SpawnPlayerPawn( FVector( 0.f, 0.f, 100.f ), CharacterClass ) );
+		AWeapon* Weapon = TestWorld.SpawnWeapon( FVector::ZeroVector, WeaponClass );
+		if ( !TestNotNull( TEXT( "Character" ), Character ) || !TestNotNull( TEXT( "Weapon" ), Weapon ) ) return false;
+
+		// the character holds its actions until its montage bundle has streamed in, and nothing pumps async loading here
+		FlushAsyncLoading( );
+
+		// montages and their notifies have to run even though nothing is rendered
+		Character->GetMesh( )->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones;
+		Character->EquipWeapon( Weapon );
+
+		auto IsUnoccupied = [Character]( ) { return Character->GetActionState( ) == EActionState::EAS_Unoccupied; };
+		auto IsAttacking = [Character]( ) { return Character->GetActionState( ) == EActionState::EAS_Attacking; };
+		auto IsDodging = [Character]( ) { return Character->GetActionState( ) == EActionState::EAS_Dodge; };
+
+		// land, finish whatever is playing and let stamina refill
+		auto Settle = [&]( )
+		{
+			TestWorld.TickUntil( DeltaTime, MaxTicks, IsUnoccupied );
+			TestWorld.TickUntil( DeltaTime, TicksPerSecond, []( ) { return false; } );
+		};
+
+		// idle: the dodge starts on the press itself
+		Settle( );
+		Character->Dodge( );
+		const int32 IdleTicks = TestWorld.TickUntil( DeltaTime, MaxTicks, IsDodging );
+		TestEqual( FString::Printf( TEXT( "%.0f fps: ticks from an idle press to the dodge" ), FrameRate ), IdleTicks, 0 );
+
+		// reference swing, nothing buffered: the tick on which it frees the character
+		Settle( );
+		TestWorld.Reseed( Seed );
+		Character->Attack( );
+		if ( !TestTrue( FString::Printf( TEXT( "%.0f fps: reference swing started" ), FrameRate ), IsAttacking( ) ) ) continue;
+		const int32 FreeTicks = TestWorld.TickUntil( DeltaTime, MaxTicks, [&IsAttacking]( ) { return !IsAttacking( ); } );
+		if ( !TestTrue( FString::Printf( TEXT( "%.0f fps: reference swing ended" ), FrameRate ), FreeTicks > 0 ) ) continue;
+
+		// the same swing again, reseeded so it picks the same section, with the dodge pressed during its recovery
+		Settle( );
+		TestWorld.Reseed( Seed );
+		Character->Attack( );
+		const int32 PressTicks = FMath::Max( FreeTicks - FMath::CeilToInt( PressLeadSeconds * FrameRate ), 1 );
+		for ( int32 Tick = 0; Tick < PressTicks; ++Tick )
+		{
+			TestWorld.Tick( DeltaTime );
+		}
+		TestTrue( FString::Printf( TEXT( "%.0f fps: dodge pressed mid swing" ), FrameRate ), IsAttacking( ) );
+		Character->Dodge( );
+
+		const double Start = FPlatformTime::Seconds( );
+		const int32 WaitTicks = TestWorld.TickUntil( DeltaTime, MaxTicks, IsDodging );
+		const double Elapsed = FPlatformTime::Seconds( ) - Start;
+		if ( !TestTrue( FString::Printf( TEXT( "%.0f fps: buffered dodge started" ), FrameRate ), WaitTicks != INDEX_NONE ) ) continue;
+
+		// a dodge-cancel window can start it earlier than the swing's end, never later
+		const int32 LatencyTicks = PressTicks + WaitTicks - FreeTicks;
+		AddInfo( FString::Printf( TEXT( "%.0f fps: swing frees the character on tick %d, buffered dodge started on tick %d (%+d)" ),
+			FrameRate, FreeTicks, PressTicks + WaitTicks, LatencyTicks ) );
+		TestTrue( FString::Printf( TEXT( "%.0f fps: buffered dodge started %d ticks after the swing freed the character" ), FrameRate, LatencyTicks ), LatencyTicks <= 0 );
+		SlashTests::TestWithinBudget( *this, TEXT( "Ticks until the buffered dodge" ), Elapsed, (WaitTicks + 1) * TickSeconds );
+	}
+	return true;
+}
+
+#endif
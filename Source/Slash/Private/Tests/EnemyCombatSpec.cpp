@@ -0,0 +1,273 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Tests/SlashTestWorld.h"
+#include "Enemy/Enemy.h"
+#include "Enemy/EnemyStateMachine.h"
+#include "Enemy/EnemyArchetype.h"
+#include "Components/AttributeComponent.h"
+#include "Components/CapsuleComponent.h"
+#include "Interfaces/HitInterface.h"
+#include "Engine/DamageEvents.h"
+#include "HAL/IConsoleManager.h"
+
+/*
+* Budgets are wall time, around ten times what a development build takes, so a loaded build machine stays inside them;
+* they are there to catch a refactor that makes a hit or an AI update an order of magnitude dearer
+*/
+namespace EnemyCombatBudgets
+{
+	constexpr int32 NumHits = 256;
+	constexpr double HitSeconds = 0.005;
+	constexpr double DeathSeconds = 0.02;
+	constexpr double TickSeconds = 0.05;
+}
+
+BEGIN_DEFINE_SPEC( FEnemyCombatSpec, "Slash.Combat.Enemy", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter )
+
+	TUniquePtr<FSlashTestWorld> TestWorld;
+	AEnemy* Enemy = nullptr;
+	APawn* Player = nullptr;
+	UAttributeComponent* Attributes = nullptr;
+
+	/** TakeDamage followed by the reaction the damage bus runs after it */
+	void Hit( AEnemy* Target, float Damage )
+	{
+		Target->TakeDamage( Damage, FDamageEvent( ), Player->GetController( ), nullptr );
+		IHitInterface::Execute_GetHit( Target, Target->GetActorLocation( ) );
+	}
+
+	/** Game time from the enemy entering Attacking to its attack starting, taken from the transition trace */
+	float MeasureAttackWait( float DeltaTime )
+	{
+		IConsoleVariable* TraceTransitions = IConsoleManager::Get( ).FindConsoleVariable( TEXT( "Slash.Enemy.TraceTransitions" ) );
+		TraceTransitions->Set( true );
+		EnemyStateMachine::ResetRecordedTransitions( );
+
+		const uint32 EnemyId = Enemy->GetUniqueID( );
+		double AttackingTime = -1.0;
+		double AttackStartedTime = -1.0;
+		TestWorld->TickUntil( DeltaTime, 600, [&]( )
+		{
+			TArray<FEnemyTransitionRecord> Records;
+			EnemyStateMachine::GetRecordedTransitions( Records );
+			for ( const FEnemyTransitionRecord& Record : Records )
+			{
+				if ( Record.EnemyId != EnemyId ) continue;
+				if ( Record.ToState == EEnemyState::EES_Attacking && AttackingTime < 0.0 )
+				{
+					AttackingTime = Record.Time;
+				}
+				if ( Record.Event == EEnemyEvent::EEE_AttackStarted && AttackingTime >= 0.0 && Record.Time >= AttackingTime )
+				{
+					AttackStartedTime = Record.Time;
+					return true;
+				}
+			}
+			return false;
+		} );
+
+		TraceTransitions->Set( false );
+		return AttackStartedTime >= 0.0 ? static_cast<float>( AttackStartedTime - AttackingTime ) : -1.f;
+	}
+
+END_DEFINE_SPEC( FEnemyCombatSpec )
+
+void FEnemyCombatSpec::Define( )
+{
+	BeforeEach( [this]( )
+	{
+		TestWorld = MakeUnique<FSlashTestWorld>( );
+		Player = TestWorld->SpawnPlayerPawn( FVector( 100.f, 0.f, 100.f ) );
+		Enemy = TestWorld->SpawnEnemy( FVector( 0.f, 0.f, 100.f ) );
+		Attributes = Enemy ? Enemy->FindComponentByClass<UAttributeComponent>( ) : nullptr;
+		TestNotNull( TEXT( "Player" ), Player );
+		TestNotNull( TEXT( "Enemy" ), Enemy );
+		TestNotNull( TEXT( "Attributes" ), Attributes );
+	} );
+
+	AfterEach( [this]( )
+	{
+		Enemy = nullptr;
+		Player = nullptr;
+		Attributes = nullptr;
+		TestWorld.Reset( );
+	} );
+
+	Describe( "Damage", [this]( )
+	{
+		It( "should subtract damage from health and clamp at zero", [this]( )
+		{
+			if ( Attributes == nullptr ) return;
+
+			Attributes->ReceiveDamage( 30.f );
+			TestEqual( TEXT( "Health after 30 damage" ), Attributes->GetHealth( ), 70.f );
+			Attributes->ReceiveDamage( 500.f );
+			TestEqual( TEXT( "Health after overkill" ), Attributes->GetHealth( ), 0.f );
+			TestFalse( TEXT( "Alive" ), Attributes->IsAlive( ) );
+
+			const double Start = FPlatformTime::Seconds( );
+			for ( int32 Index = 0; Index < EnemyCombatBudgets::NumHits; ++Index )
+			{
+				Attributes->ReceiveDamage( 1.f );
+			}
+			SlashTests::TestWithinBudget( *this, TEXT( "ReceiveDamage" ), FPlatformTime::Seconds( ) - Start, EnemyCombatBudgets::NumHits * EnemyCombatBudgets::HitSeconds );
+		} );
+
+		It( "should take damage from an instigator and chase it", [this]( )
+		{
+			if ( Enemy == nullptr || Attributes == nullptr ) return;
+
+			TestEqual( TEXT( "Starts patrolling" ), Enemy->GetEnemyState( ), EEnemyState::EES_Patrolling );
+
+			const double Start = FPlatformTime::Seconds( );
+			Hit( Enemy, 30.f );
+			SlashTests::TestWithinBudget( *this, TEXT( "One hit" ), FPlatformTime::Seconds( ) - Start, EnemyCombatBudgets::HitSeconds );
+
+			TestEqual( TEXT( "Health" ), Attributes->GetHealth( ), 70.f );
+			TestEqual( TEXT( "Chases its attacker" ), Enemy->GetEnemyState( ), EEnemyState::EES_Chasing );
+			TestEqual( TEXT( "Replicated health" ), Enemy->GetNetState( ).GetHealthPercent( ), 0.7f, 0.01f );
+
+			const double HitsStart = FPlatformTime::Seconds( );
+			for ( int32 Index = 0; Index < EnemyCombatBudgets::NumHits; ++Index )
+			{
+				Hit( Enemy, 0.1f );
+			}
+			SlashTests::TestWithinBudget( *this, TEXT( "Repeated hits" ), FPlatformTime::Seconds( ) - HitsStart, EnemyCombatBudgets::NumHits * EnemyCombatBudgets::HitSeconds );
+		} );
+
+		It( "should die when health runs out", [this]( )
+		{
+			if ( Enemy == nullptr ) return;
+
+			const double Start = FPlatformTime::Seconds( );
+			Hit( Enemy, 100.f );
+			SlashTests::TestWithinBudget( *this, TEXT( "Killing hit" ), FPlatformTime::Seconds( ) - Start, EnemyCombatBudgets::DeathSeconds );
+
+			TestEqual( TEXT( "State" ), Enemy->GetEnemyState( ), EEnemyState::EES_Dead );
+			TestEqual( TEXT( "Replicated state" ), Enemy->GetNetState( ).State, EEnemyState::EES_Dead );
+			TestEqual( TEXT( "Capsule collision" ), Enemy->GetCapsuleComponent( )->GetCollisionEnabled( ), ECollisionEnabled::NoCollision );
+		} );
+	} );
+
+	Describe( "DeathPose", [this]( )
+	{
+		It( "should pick a valid pose, and the same ones again for the same seed", [this]( )
+		{
+			constexpr int32 NumEnemies = 12;
+			TArray<EDeathPose> Poses[2];
+			double KillSeconds = 0.0;
+			for ( int32 Run = 0; Run < 2; ++Run )
+			{
+				TArray<AEnemy*> Enemies;
+				for ( int32 Index = 0; Index < NumEnemies; ++Index )
+				{
+					Enemies.Add( TestWorld->SpawnEnemy( FVector( 300.f * (Index + 1), 300.f * Run, 100.f ) ) );
+				}
+
+				TestWorld->Reseed( 42 );
+				for ( AEnemy* Victim : Enemies )
+				{
+					if ( Victim == nullptr ) continue;
+					const double Start = FPlatformTime::Seconds( );
+					Hit( Victim, 1000.f );
+					KillSeconds += FPlatformTime::Seconds( ) - Start;
+					Poses[Run].Add( Victim->GetNetState( ).DeathPose );
+				}
+			}
+			SlashTests::TestWithinBudget( *this, TEXT( "Deaths" ), KillSeconds, 2 * NumEnemies * EnemyCombatBudgets::DeathSeconds );
+
+			TestEqual( TEXT( "Deaths recorded" ), Poses[0].Num( ), NumEnemies );
+			for ( const EDeathPose Pose : Poses[0] )
+			{
+				TestTrue( TEXT( "Pose is one of Death1..Death6" ), Pose >= EDeathPose::EDP_Death1 && Pose <= EDeathPose::EDP_Death6 );
+			}
+			TestTrue( TEXT( "Poses vary between deaths" ), Poses[0].Num( ) > 0 && Poses[0].ContainsByPredicate( [&Poses]( EDeathPose Pose ) { return Pose != Poses[0][0]; } ) );
+			TestTrue( TEXT( "Same seed, same poses" ), Poses[0] == Poses[1] );
+		} );
+	} );
+
+	Describe( "Transitions", [this]( )
+	{
+		It( "should attack a target in reach and give up on one out of the combat radius", [this]( )
+		{
+			if ( Enemy == nullptr ) return;
+
+			Hit( Enemy, 1.f );
+			TestEqual( TEXT( "Damaged" ), Enemy->GetEnemyState( ), EEnemyState::EES_Chasing );
+
+			// the player stands inside the attack radius
+			const double Start = FPlatformTime::Seconds( );
+			Enemy->CheckCombatTarget( );
+			SlashTests::TestWithinBudget( *this, TEXT( "CheckCombatTarget" ), FPlatformTime::Seconds( ) - Start, EnemyCombatBudgets::HitSeconds );
+			TestEqual( TEXT( "In reach" ), Enemy->GetEnemyState( ), EEnemyState::EES_Attacking );
+
+			const float CombatRadius = FMath::Sqrt( Enemy->GetTuning( ).CombatRadiusSquared );
+			Player->SetActorLocation( Enemy->GetActorLocation( ) + FVector( CombatRadius + 500.f, 0.f, 0.f ) );
+			Enemy->CheckCombatTarget( );
+			TestEqual( TEXT( "Target lost" ), Enemy->GetEnemyState( ), EEnemyState::EES_Patrolling );
+		} );
+
+		It( "should ignore every event once dead", [this]( )
+		{
+			if ( Enemy == nullptr ) return;
+
+			Hit( Enemy, 1000.f );
+			const double Start = FPlatformTime::Seconds( );
+			for ( int32 Event = 0; Event < EnemyStateMachine::NumEvents; ++Event )
+			{
+				Enemy->DispatchEnemyEvent( static_cast<EEnemyEvent>( Event ) );
+				TestEqual( TEXT( "Dead stays dead" ), Enemy->GetEnemyState( ), EEnemyState::EES_Dead );
+			}
+			SlashTests::TestWithinBudget( *this, TEXT( "Dead dispatches" ), FPlatformTime::Seconds( ) - Start, EnemyStateMachine::NumEvents * EnemyCombatBudgets::HitSeconds );
+		} );
+	} );
+
+	Describe( "Timers", [this]( )
+	{
+		It( "should start the attack between AttackMin and AttackMax", [this]( )
+		{
+			if ( Enemy == nullptr ) return;
+
+			constexpr float DeltaTime = 1.f / 60.f;
+			Hit( Enemy, 1.f );
+
+			const double Start = FPlatformTime::Seconds( );
+			const float Wait = MeasureAttackWait( DeltaTime );
+			const double Elapsed = FPlatformTime::Seconds( ) - Start;
+
+			const FEnemyTuning& Row = Enemy->GetTuning( );
+			TestTrue( FString::Printf( TEXT( "Attack wait %.3f s within [%.2f, %.2f]" ), Wait, Row.AttackMin, Row.AttackMax ),
+				Wait >= Row.AttackMin - DeltaTime && Wait <= Row.AttackMax + DeltaTime );
+			const int32 NumTicks = FMath::CeilToInt( FMath::Max( Wait, Row.AttackMax ) / DeltaTime ) + 1;
+			SlashTests::TestWithinBudget( *this, TEXT( "Ticks until the attack" ), Elapsed, NumTicks * EnemyCombatBudgets::TickSeconds );
+		} );
+
+		It( "should stretch the attack wait under time dilation", [this]( )
+		{
+			if ( Enemy == nullptr ) return;
+
+			// hitstop slows the enemy through CustomTimeDilation; its waits have to slow down with it
+			constexpr float DeltaTime = 1.f / 60.f;
+			constexpr float Dilation = 0.25f;
+			Hit( Enemy, 1.f );
+			Enemy->CustomTimeDilation = Dilation;
+
+			const double Start = FPlatformTime::Seconds( );
+			const float Wait = MeasureAttackWait( DeltaTime );
+			const double Elapsed = FPlatformTime::Seconds( ) - Start;
+
+			const FEnemyTuning& Row = Enemy->GetTuning( );
+			TestTrue( FString::Printf( TEXT( "Dilated attack wait %.3f s within [%.2f, %.2f]" ), Wait, Row.AttackMin / Dilation, Row.AttackMax / Dilation ),
+				Wait >= Row.AttackMin / Dilation - DeltaTime && Wait <= Row.AttackMax / Dilation + DeltaTime );
+			const int32 NumTicks = FMath::CeilToInt( FMath::Max( Wait, Row.AttackMax / Dilation ) / DeltaTime ) + 1;
+			SlashTests::TestWithinBudget( *this, TEXT( "Ticks until the attack" ), Elapsed, NumTicks * EnemyCombatBudgets::TickSeconds );
+		} );
+	} );
+}
+
+#endif
@@ -0,0 +1,82 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Tests/SlashTestWorld.h"
+#include "Enemy/EnemyStateMachine.h"
+
+/*
+*  the table on its own, without a world: the rows an enemy with no montages never stays in long enough to observe
+*/
+IMPLEMENT_SIMPLE_AUTOMATION_TEST( FEnemyStateMachineTableTest, "Slash.Combat.Enemy.StateMachineTable", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter )
+
+bool FEnemyStateMachineTableTest::RunTest( const FString& Parameters )
+{
+	using S = EEnemyState;
+	using E = EEnemyEvent;
+	using A = EEnemyAction;
+
+	// dying works from every living state and nothing leaves Dead
+	for ( int32 State = 0; State < EnemyStateMachine::NumStates; ++State )
+	{
+		const S FromState = static_cast<S>( State );
+		const FEnemyTransition& Died = EnemyStateMachine::GetTransition( FromState, E::EEE_Died );
+		TestEqual( TEXT( "Died leads to Dead" ), Died.NextState, S::EES_Dead );
+		TestEqual( TEXT( "Only the living run Die" ), Died.Action, FromState == S::EES_Dead ? A::EEA_None : A::EEA_Die );
+
+		const FEnemyTransition& FromDead = EnemyStateMachine::GetTransition( S::EES_Dead, static_cast<E>( FMath::Min( State, EnemyStateMachine::NumEvents - 1 ) ) );
+		TestEqual( TEXT( "Dead stays dead" ), FromDead.NextState, S::EES_Dead );
+	}
+
+	// a swing in progress finishes before anything else happens
+	for ( int32 Event = 0; Event < EnemyStateMachine::NumEvents; ++Event )
+	{
+		const E InEvent = static_cast<E>( Event );
+		if ( InEvent == E::EEE_AttackEnded || InEvent == E::EEE_Died ) continue;
+
+		const FEnemyTransition& Engaged = EnemyStateMachine::GetTransition( S::EES_Engaged, InEvent );
+		TestEqual( TEXT( "Engaged holds until the attack ends" ), Engaged.NextState, S::EES_Engaged );
+		TestEqual( TEXT( "Engaged runs nothing until the attack ends" ), Engaged.Action, A::EEA_None );
+	}
+	TestEqual( TEXT( "Attack end chases again" ), EnemyStateMachine::GetTransition( S::EES_Engaged, E::EEE_AttackEnded ).NextState, S::EES_Chasing );
+	TestEqual( TEXT( "Attack start swings" ), EnemyStateMachine::GetTransition( S::EES_Attacking, E::EEE_AttackStarted ).Action, A::EEA_Attack );
+	TestEqual( TEXT( "Out of reach while waiting to attack" ), EnemyStateMachine::GetTransition( S::EES_Attacking, E::EEE_TargetOutOfReach ).NextState, S::EES_Chasing );
+	TestEqual( TEXT( "Lost while chasing" ), EnemyStateMachine::GetTransition( S::EES_Chasing, E::EEE_TargetLost ).Action, A::EEA_LoseInterest );
+
+	// every enemy runs one lookup per update, keep it a flat array read: timed against the same loop over a plain copy of the table
+	constexpr int32 NumLookups = 1 << 20;
+	TArray<uint8> NextStates;
+	for ( int32 Index = 0; Index < EnemyStateMachine::NumStates * EnemyStateMachine::NumEvents; ++Index )
+	{
+		NextStates.Add( static_cast<uint8>( EnemyStateMachine::GetTransition( static_cast<S>( Index / EnemyStateMachine::NumEvents ), static_cast<E>( Index % EnemyStateMachine::NumEvents ) ).NextState ) );
+	}
+
+	int32 BaselineChecksum = 0;
+	const double BaselineStart = FPlatformTime::Seconds( );
+	for ( int32 Index = 0; Index < NumLookups; ++Index )
+	{
+		const int32 State = Index % EnemyStateMachine::NumStates;
+		const int32 Event = (Index >> 3) % EnemyStateMachine::NumEvents;
+		BaselineChecksum += NextStates[State * EnemyStateMachine::NumEvents + Event];
+	}
+	const double BaselineSeconds = FPlatformTime::Seconds( ) - BaselineStart;
+
+	int32 Checksum = 0;
+	const double Start = FPlatformTime::Seconds( );
+	for ( int32 Index = 0; Index < NumLookups; ++Index )
+	{
+		const S State = static_cast<S>( Index % EnemyStateMachine::NumStates );
+		const E Event = static_cast<E>( (Index >> 3) % EnemyStateMachine::NumEvents );
+		Checksum += static_cast<int32>( EnemyStateMachine::GetTransition( State, Event ).NextState );
+	}
+	SlashTests::TestWithinRatio( *this, TEXT( "Transition lookups" ), FPlatformTime::Seconds( ) - Start, BaselineSeconds, 4.0 );
+	TestTrue( TEXT( "Lookups ran" ), Checksum > 0 );
+	TestEqual( TEXT( "Lookups match the plain table" ), Checksum, BaselineChecksum );
+
+	return true;
+}
+
+#endif
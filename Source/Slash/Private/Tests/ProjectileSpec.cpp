@@ -0,0 +1,125 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Tests/SlashTestWorld.h"
+#include "Enemy/Enemy.h"
+#include "Items/Weapons/ProjectileSubsystem.h"
+#include "Components/AttributeComponent.h"
+#include "Components/CapsuleComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+
+BEGIN_DEFINE_SPEC( FProjectileSpec, "Slash.Combat.Projectile", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter )
+
+	TUniquePtr<FSlashTestWorld> TestWorld;
+	UProjectileSubsystem* Projectiles = nullptr;
+	UProjectileType* Type = nullptr;
+	AEnemy* Enemy = nullptr;
+	APawn* Player = nullptr;
+	UAttributeComponent* Attributes = nullptr;
+
+	static constexpr float DeltaTime = 1.f / 60.f;
+
+END_DEFINE_SPEC( FProjectileSpec )
+
+void FProjectileSpec::Define( )
+{
+	BeforeEach( [this]( )
+	{
+		TestWorld = MakeUnique<FSlashTestWorld>( );
+		Projectiles = TestWorld->GetWorld( )->GetSubsystem<UProjectileSubsystem>( );
+		Player = TestWorld->SpawnPlayerPawn( FVector( -1500.f, 0.f, 100.f ) );
+		Enemy = TestWorld->SpawnEnemy( FVector( 0.f, 0.f, 100.f ) );
+		Attributes = Enemy ? Enemy->FindComponentByClass<UAttributeComponent>( ) : nullptr;
+		TestNotNull( TEXT( "Projectile subsystem" ), Projectiles );
+		TestNotNull( TEXT( "Player" ), Player );
+		TestNotNull( TEXT( "Enemy" ), Enemy );
+		TestNotNull( TEXT( "Attributes" ), Attributes );
+
+		// a straight, fast bolt that pawns block
+		Type = NewObject<UProjectileType>( );
+		Type->Mesh = LoadObject<UStaticMesh>( nullptr, TEXT( "/Engine/BasicShapes/Sphere.Sphere" ) );
+		Type->Speed = 3000.f;
+		Type->GravityScale = 0.f;
+		Type->Lifetime = 1.f;
+		Type->CollisionChannel = ECollisionChannel::ECC_Pawn;
+		Type->Damage = 25.f;
+		Type->AddToRoot( );
+
+		// let the pawns land before anything is fired at them
+		TestWorld->TickUntil( DeltaTime, 10, []( ) { return false; } );
+	} );
+
+	AfterEach( [this]( )
+	{
+		if ( Type )
+		{
+			Type->RemoveFromRoot( );
+		}
+		Type = nullptr;
+		Projectiles = nullptr;
+		Enemy = nullptr;
+		Player = nullptr;
+		Attributes = nullptr;
+		TestWorld.Reset( );
+	} );
+
+	It( "should fly at the type's speed and damage what it hits", [this]( )
+	{
+		if ( Projectiles == nullptr || Enemy == nullptr || Attributes == nullptr ) return;
+
+		const float FullHealth = Attributes->GetHealth( );
+		const FVector Target = Enemy->GetActorLocation( );
+		const FVector Origin = Target - FVector( 1000.f, 0.f, 0.f );
+		TestTrue( TEXT( "Fired" ), Projectiles->Fire( Type, Origin, FVector::ForwardVector, Player, Player->GetController( ) ) );
+		TestEqual( TEXT( "In flight" ), Projectiles->GetNumProjectiles( ), 1 );
+
+		// the capsule's near side is reached no sooner than distance / speed
+		const float Distance = 1000.f - Enemy->GetCapsuleComponent( )->GetScaledCapsuleRadius( ) - Type->Radius;
+		const int32 MinTicks = FMath::FloorToInt( Distance / ( Type->Speed * DeltaTime ) );
+		const int32 HitTicks = TestWorld->TickUntil( DeltaTime, 120, [this, FullHealth]( ) { return Attributes->GetHealth( ) < FullHealth; } );
+
+		if ( !TestTrue( TEXT( "The projectile hit" ), HitTicks != INDEX_NONE ) ) return;
+		TestTrue( FString::Printf( TEXT( "Hit after %d ticks, not before %d" ), HitTicks, MinTicks ), HitTicks >= MinTicks );
+		TestEqual( TEXT( "Health" ), Attributes->GetHealth( ), FullHealth - Type->Damage );
+		TestEqual( TEXT( "Spent on the hit" ), Projectiles->GetNumProjectiles( ), 0 );
+	} );
+
+	It( "should never hit the actor that fired it", [this]( )
+	{
+		if ( Projectiles == nullptr || Player == nullptr || Attributes == nullptr ) return;
+
+		// fired from inside the shooter's own capsule, away from the enemy
+		const float FullHealth = Attributes->GetHealth( );
+		Projectiles->Fire( Type, Player->GetActorLocation( ), -FVector::ForwardVector, Player, Player->GetController( ) );
+		TestWorld->Tick( DeltaTime );
+		TestWorld->Tick( DeltaTime );
+		TestEqual( TEXT( "Still flying" ), Projectiles->GetNumProjectiles( ), 1 );
+		TestEqual( TEXT( "Enemy untouched" ), Attributes->GetHealth( ), FullHealth );
+	} );
+
+	It( "should expire after its lifetime", [this]( )
+	{
+		if ( Projectiles == nullptr || Player == nullptr ) return;
+
+		Projectiles->Fire( Type, Player->GetActorLocation( ) + FVector( 0.f, 0.f, 200.f ), FVector::UpVector, Player, Player->GetController( ) );
+		const int32 LifetimeTicks = FMath::CeilToInt( Type->Lifetime / DeltaTime );
+		const int32 ExpireTicks = TestWorld->TickUntil( DeltaTime, 2 * LifetimeTicks, [this]( ) { return Projectiles->GetNumProjectiles( ) == 0; } );
+		TestTrue( FString::Printf( TEXT( "Expired after %d ticks, lifetime %d" ), ExpireTicks, LifetimeTicks ),
+			ExpireTicks != INDEX_NONE && ExpireTicks >= LifetimeTicks - 1 && ExpireTicks <= LifetimeTicks + 1 );
+	} );
+
+	It( "should refuse an empty type", [this]( )
+	{
+		if ( Projectiles == nullptr ) return;
+
+		TestFalse( TEXT( "Fired without a type" ), Projectiles->Fire( nullptr, FVector::ZeroVector, FVector::ForwardVector, nullptr, nullptr ) );
+		TestEqual( TEXT( "Nothing in flight" ), Projectiles->GetNumProjectiles( ), 0 );
+	} );
+}
+
+#endif
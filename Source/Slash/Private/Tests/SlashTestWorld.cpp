@@ -0,0 +1,148 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Tests/SlashTestWorld.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Enemy/Enemy.h"
+#include "Items/Weapons/Weapon.h"
+#include "Components/AttributeComponent.h"
+#include "World/SlashRandomSubsystem.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/StaticMeshActor.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "Misc/App.h"
+#include "Misc/AutomationTest.h"
+
+FSlashTestWorld::FSlashTestWorld( int32 Seed )
+{
+	const UWorld::InitializationValues InitValues = UWorld::InitializationValues( ).AllowAudioPlayback( false ).RequiresHitProxies( false );
+	World = UWorld::CreateWorld( EWorldType::Game, false, TEXT( "SlashTestWorld" ), nullptr, true, ERHIFeatureLevel::Num, &InitValues );
+
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext( EWorldType::Game );
+	WorldContext.SetCurrentWorld( World );
+	Reseed( Seed );
+
+	const FURL URL;
+	World->InitializeActorsForPlay( URL );
+	World->BeginPlay( );
+
+	// a 100m slab with its top at z = 0, so characters land and dodges aren't blocked by falling
+	AStaticMeshActor* Floor = World->SpawnActor<AStaticMeshActor>( FVector( 0.f, 0.f, -50.f ), FRotator::ZeroRotator );
+	if ( Floor )
+	{
+		Floor->GetStaticMeshComponent( )->SetMobility( EComponentMobility::Movable );
+		Floor->GetStaticMeshComponent( )->SetStaticMesh( LoadObject<UStaticMesh>( nullptr, TEXT( "/Engine/BasicShapes/Cube.Cube" ) ) );
+		Floor->SetActorScale3D( FVector( 100.f, 100.f, 1.f ) );
+	}
+}
+
+FSlashTestWorld::~FSlashTestWorld( )
+{
+	World->BeginTearingDown( );
+	for ( FActorIterator It( World ); It; ++It )
+	{
+		It->RouteEndPlay( EEndPlayReason::Quit );
+	}
+
+	GEngine->DestroyWorldContext( World );
+	World->DestroyWorld( false );
+	World->RemoveFromRoot( );
+	CollectGarbage( GARBAGE_COLLECTION_KEEPFLAGS );
+}
+
+void FSlashTestWorld::Tick( float DeltaTime )
+{
+	FApp::SetDeltaTime( DeltaTime );
+	FApp::SetCurrentTime( FApp::GetCurrentTime( ) + DeltaTime );
+	World->Tick( LEVELTICK_All, DeltaTime );
+	++GFrameCounter;
+}
+
+int32 FSlashTestWorld::TickUntil( float DeltaTime, int32 MaxTicks, TFunctionRef<bool( )> Predicate )
+{
+	for ( int32 Ticks = 0; Ticks < MaxTicks; ++Ticks )
+	{
+		if ( Predicate( ) ) return Ticks;
+		Tick( DeltaTime );
+	}
+	return Predicate( ) ? MaxTicks : INDEX_NONE;
+}
+
+void FSlashTestWorld::Reseed( int32 Seed )
+{
+	if ( USlashRandomSubsystem* Random = World->GetSubsystem<USlashRandomSubsystem>( ) )
+	{
+		Random->SetMasterSeed( Seed );
+	}
+}
+
+AEnemy* FSlashTestWorld::SpawnEnemy( const FVector& Location, float MaxHealth )
+{
+	const FTransform SpawnTransform( Location );
+	AEnemy* Enemy = World->SpawnActorDeferred<AEnemy>( AEnemy::StaticClass( ), SpawnTransform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn );
+	if ( Enemy == nullptr ) return nullptr;
+
+	// the native class leaves health to the blueprint
+	if ( UAttributeComponent* Attributes = Enemy->FindComponentByClass<UAttributeComponent>( ) )
+	{
+		SlashTests::SetFloatProperty( Attributes, TEXT( "MaxHealth" ), MaxHealth );
+		SlashTests::SetFloatProperty( Attributes, TEXT( "Health" ), MaxHealth );
+	}
+	Enemy->FinishSpawning( SpawnTransform );
+	return Enemy;
+}
+
+APawn* FSlashTestWorld::SpawnPlayerPawn( const FVector& Location, UClass* PawnClass )
+{
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+	APawn* Pawn = World->SpawnActor<APawn>( PawnClass ? PawnClass : ACharacter::StaticClass( ), Location, FRotator::ZeroRotator, SpawnParams );
+	if ( Pawn == nullptr ) return nullptr;
+
+	// enemies only chase what carries the player tag
+	Pawn->Tags.Add( FName( "SlashCharacter" ) );
+	if ( APlayerController* PlayerController = World->SpawnActor<APlayerController>( ) )
+	{
+		PlayerController->Possess( Pawn );
+	}
+	return Pawn;
+}
+
+AWeapon* FSlashTestWorld::SpawnWeapon( const FVector& Location, UClass* WeaponClass )
+{
+	return World->SpawnActor<AWeapon>( WeaponClass ? WeaponClass : AWeapon::StaticClass( ), Location, FRotator::ZeroRotator );
+}
+
+namespace SlashTests
+{
+	void SetFloatProperty( UObject* Object, FName PropertyName, float Value )
+	{
+		FFloatProperty* Property = FindFProperty<FFloatProperty>( Object->GetClass( ), PropertyName );
+		check( Property );
+		Property->SetPropertyValue_InContainer( Object, Value );
+	}
+
+	bool TestWithinBudget( FAutomationTestBase& Test, const TCHAR* What, double Seconds, double BudgetSeconds )
+	{
+		return Test.TestTrue(
+			FString::Printf( TEXT( "%s took %.3f ms, budget %.3f ms" ), What, Seconds * 1000.0, BudgetSeconds * 1000.0 ),
+			Seconds <= BudgetSeconds );
+	}
+
+	bool TestWithinRatio( FAutomationTestBase& Test, const TCHAR* What, double Seconds, double BaselineSeconds, double MaxRatio )
+	{
+		// below the timer's resolution both are noise; only a real gap between them means anything
+		const double Baseline = FMath::Max( BaselineSeconds, FPlatformTime::GetSecondsPerCycle( ) * 1000.0 );
+		return Test.TestTrue(
+			FString::Printf( TEXT( "%s took %.3f ms, %.1fx the %.3f ms baseline, limit %.1fx" ), What, Seconds * 1000.0, Seconds / Baseline, BaselineSeconds * 1000.0, MaxRatio ),
+			Seconds <= Baseline * MaxRatio );
+	}
+}
+
+#endif
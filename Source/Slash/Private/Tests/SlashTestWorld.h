@@ -0,0 +1,62 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+class AEnemy;
+class AWeapon;
+class APawn;
+class FAutomationTestBase;
+
+/*
+* Bare game world for automation tests: no map and no game mode, just a floor to stand on.
+* Ticked by hand at whatever timestep the test asks for; everything spawned into it goes away with it.
+*/
+class FSlashTestWorld
+{
+public:
+
+	explicit FSlashTestWorld( int32 Seed = 1337 );
+	~FSlashTestWorld( );
+
+	UE_NONCOPYABLE( FSlashTestWorld );
+
+	void Tick( float DeltaTime );
+
+	/** Ticks until Predicate holds; returns how many ticks that took, or INDEX_NONE if it still fails after MaxTicks */
+	int32 TickUntil( float DeltaTime, int32 MaxTicks, TFunctionRef<bool( )> Predicate );
+
+	/** Reseeds every gameplay random stream, so two runs roll the same numbers */
+	void Reseed( int32 Seed );
+
+	/** Native enemy with the default tuning row and full health; no montages, so attacks end as soon as they start */
+	AEnemy* SpawnEnemy( const FVector& Location, float MaxHealth = 100.f );
+
+	/** Character possessed by a player controller, standing in for the player as viewer and damage instigator; a plain ACharacter by default */
+	APawn* SpawnPlayerPawn( const FVector& Location, UClass* PawnClass = nullptr );
+
+	AWeapon* SpawnWeapon( const FVector& Location, UClass* WeaponClass = nullptr );
+
+	FORCEINLINE UWorld* GetWorld( ) const { return World; }
+
+private:
+
+	UWorld* World = nullptr;
+};
+
+namespace SlashTests
+{
+	/** Sets a private UPROPERTY float the way a blueprint default would */
+	void SetFloatProperty( UObject* Object, FName PropertyName, float Value );
+
+	/** Fails Test if Seconds of wall time went over BudgetSeconds */
+	bool TestWithinBudget( FAutomationTestBase& Test, const TCHAR* What, double Seconds, double BudgetSeconds );
+
+	/** Fails Test if Seconds came to more than MaxRatio times a baseline measured on the same machine in the same run */
+	bool TestWithinRatio( FAutomationTestBase& Test, const TCHAR* What, double Seconds, double BaselineSeconds, double MaxRatio );
+}
+
+#endif
@@ -0,0 +1,108 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Tests/SlashTestWorld.h"
+#include "Enemy/Enemy.h"
+#include "Items/Weapons/Weapon.h"
+#include "Components/AttributeComponent.h"
+#include "Components/BoxComponent.h"
+#include "Components/CapsuleComponent.h"
+
+namespace WeaponHitBudgets
+{
+	constexpr int32 NumOverlaps = 64;
+
+	/* one box trace plus the dedup check, with the same tenfold headroom as the enemy budgets */
+	constexpr double OverlapSeconds = 0.01;
+}
+
+BEGIN_DEFINE_SPEC( FWeaponHitSpec, "Slash.Combat.Weapon", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter )
+
+	TUniquePtr<FSlashTestWorld> TestWorld;
+	AEnemy* Enemy = nullptr;
+	AWeapon* Weapon = nullptr;
+	UAttributeComponent* Attributes = nullptr;
+
+	/** Fires the weapon box's overlap NumOverlaps times against the enemy, the way a swing through it would; returns the wall time */
+	double Overlap( int32 NumOverlaps )
+	{
+		UBoxComponent* WeaponBox = Weapon->GetWeaponBox( );
+		const double Start = FPlatformTime::Seconds( );
+		for ( int32 Index = 0; Index < NumOverlaps; ++Index )
+		{
+			WeaponBox->OnComponentBeginOverlap.Broadcast( WeaponBox, Enemy, Enemy->GetCapsuleComponent( ), 0, false, FHitResult( ) );
+		}
+		return FPlatformTime::Seconds( ) - Start;
+	}
+
+END_DEFINE_SPEC( FWeaponHitSpec )
+
+void FWeaponHitSpec::Define( )
+{
+	BeforeEach( [this]( )
+	{
+		TestWorld = MakeUnique<FSlashTestWorld>( );
+		Enemy = TestWorld->SpawnEnemy( FVector( 0.f, 0.f, 100.f ) );
+		Attributes = Enemy ? Enemy->FindComponentByClass<UAttributeComponent>( ) : nullptr;
+		TestNotNull( TEXT( "Enemy" ), Enemy );
+		if ( Enemy == nullptr ) return;
+
+		// the weapon's trace looks for visibility blockers; the native enemy has no skeletal mesh to be one
+		Enemy->GetCapsuleComponent( )->SetCollisionResponseToChannel( ECollisionChannel::ECC_Visibility, ECollisionResponse::ECR_Block );
+		Weapon = TestWorld->SpawnWeapon( Enemy->GetActorLocation( ) );
+		TestNotNull( TEXT( "Weapon" ), Weapon );
+	} );
+
+	AfterEach( [this]( )
+	{
+		Enemy = nullptr;
+		Weapon = nullptr;
+		Attributes = nullptr;
+		TestWorld.Reset( );
+	} );
+
+	It( "should hit a target once per swing", [this]( )
+	{
+		if ( Weapon == nullptr || Attributes == nullptr ) return;
+
+		const float FullHealth = Attributes->GetHealth( );
+		const double Seconds = Overlap( WeaponHitBudgets::NumOverlaps );
+		SlashTests::TestWithinBudget( *this, TEXT( "Overlaps" ), Seconds, WeaponHitBudgets::NumOverlaps * WeaponHitBudgets::OverlapSeconds );
+
+		// damage is applied by the damage bus on the next tick
+		TestEqual( TEXT( "Nothing applied on the overlap's call stack" ), Attributes->GetHealth( ), FullHealth );
+		TestWorld->Tick( 1.f / 60.f );
+		const float HitHealth = Attributes->GetHealth( );
+		TestTrue( TEXT( "The first overlap hit" ), HitHealth < FullHealth );
+
+		Overlap( 1 );
+		TestWorld->Tick( 1.f / 60.f );
+		TestEqual( TEXT( "Later overlaps of the same swing are ignored" ), Attributes->GetHealth( ), HitHealth );
+
+		// SetWeaponCollisionEnabled clears the list when the next swing opens its collision window
+		Weapon->IgnoreActors.Empty( );
+		Overlap( 1 );
+		TestWorld->Tick( 1.f / 60.f );
+		TestEqual( TEXT( "The next swing hits again" ), Attributes->GetHealth( ), 2.f * HitHealth - FullHealth, 0.01f );
+	} );
+
+	It( "should drop hits on an invulnerable target", [this]( )
+	{
+		if ( Weapon == nullptr || Attributes == nullptr ) return;
+
+		const float FullHealth = Attributes->GetHealth( );
+		Enemy->SetInvulnerable( true );
+		const double Seconds = Overlap( 1 );
+		TestWorld->Tick( 1.f / 60.f );
+		SlashTests::TestWithinBudget( *this, TEXT( "Overlap" ), Seconds, WeaponHitBudgets::OverlapSeconds );
+
+		TestEqual( TEXT( "Health" ), Attributes->GetHealth( ), FullHealth );
+		TestEqual( TEXT( "State" ), Enemy->GetEnemyState( ), EEnemyState::EES_Patrolling );
+	} );
+}
+
+#endif
@@ -0,0 +1,189 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "World/AreaDamageSubsystem.h"
+#include "World/DamageEventSubsystem.h"
+#include "Enemy/Enemy.h"
+#include "GameFramework/Controller.h"
+#include "Engine/World.h"
+#include "Slash/SlashStats.h"
+
+void UAreaDamageSubsystem::RegisterTarget( AActor* Target )
+{
+	if ( Target == nullptr ) return;
+
+	Targets.AddUnique( Target );
+	GridFrame = MAX_uint64;
+}
+
+void UAreaDamageSubsystem::UnregisterTarget( AActor* Target )
+{
+	Targets.RemoveSingleSwap( Target );
+	GridFrame = MAX_uint64;
+}
+
+void UAreaDamageSubsystem::RebuildGrid( )
+{
+	for ( TPair<FIntPoint, TArray<int32>>& Cell : Cells )
+	{
+		Cell.Value.Reset( );
+	}
+	Entries.Reset( Targets.Num( ) );
+	MaxTargetRadius = 0.f;
+
+	for ( int32 Index = 0; Index < Targets.Num( ); )
+	{
+		const AActor* Target = Targets[Index].Get( );
+		if ( Target == nullptr )
+		{
+			Targets.RemoveAtSwap( Index );
+			continue;
+		}
+
+		FTargetEntry& Entry = Entries.AddDefaulted_GetRef( );
+		Entry.Location = Target->GetActorLocation( );
+		Entry.Radius = Target->GetSimpleCollisionRadius( );
+		MaxTargetRadius = FMath::Max( MaxTargetRadius, Entry.Radius );
+		Cells.FindOrAdd( GetCell( Entry.Location ) ).Add( Index );
+		++Index;
+	}
+
+	// cells whose last target unregistered or moved on; otherwise the map grows with every cell anyone ever crossed
+	for ( TMap<FIntPoint, TArray<int32>>::TIterator It = Cells.CreateIterator( ); It; ++It )
+	{
+		if ( It.Value( ).Num( ) == 0 )
+		{
+			It.RemoveCurrent( );
+		}
+	}
+	GridFrame = GFrameCounter;
+}
+
+void UAreaDamageSubsystem::RebuildGridIfStale( )
+{
+	if ( GridFrame != GFrameCounter )
+	{
+		RebuildGrid( );
+	}
+}
+
+FIntPoint UAreaDamageSubsystem::GetCell( const FVector& Location ) const
+{
+	return FIntPoint( FMath::FloorToInt( Location.X / CellSize ), FMath::FloorToInt( Location.Y / CellSize ) );
+}
+
+int32 UAreaDamageSubsystem::ApplyAreaDamage( const FSlashAreaDamage& Area, AActor* Causer, AController* Instigator )
+{
+	SLASH_SCOPE_CYCLE_COUNTER( STAT_SlashAreaDamage );
+
+	// health is server owned; a client's blast would only desync it
+	if ( GetWorld( )->GetNetMode( ) == NM_Client ) return 0;
+
+	UDamageEventSubsystem* DamageEvents = GetWorld( )->GetSubsystem<UDamageEventSubsystem>( );
+	if ( DamageEvents == nullptr || Area.Radius <= 0.f ) return 0;
+
+	RebuildGridIfStale( );
+
+	// cells under the shape's bounds, grown by the largest target so edge straddlers are found
+	FBox Bounds( Area.Origin, Area.Origin );
+	if ( Area.Shape == EAreaDamageShape::EADS_CapsuleSweep )
+	{
+		Bounds += Area.SweepEnd;
+	}
+	Bounds = Bounds.ExpandBy( Area.Radius + MaxTargetRadius );
+	const FIntPoint MinCell = GetCell( Bounds.Min );
+	const FIntPoint MaxCell = GetCell( Bounds.Max );
+
+	const AActor* CauserOwner = Causer ? Causer->GetOwner( ) : nullptr;
+	const APawn* InstigatorPawn = Instigator ? Instigator->GetPawn( ) : nullptr;
+	const double CosHalfAngle = FMath::Cos( FMath::DegreesToRadians( Area.ConeHalfAngle ) );
+
+	int32 NumHits = 0;
+	for ( int32 CellX = MinCell.X; CellX <= MaxCell.X; ++CellX )
+	{
+		for ( int32 CellY = MinCell.Y; CellY <= MaxCell.Y; ++CellY )
+		{
+			const TArray<int32>* Cell = Cells.Find( FIntPoint( CellX, CellY ) );
+			if ( Cell == nullptr ) continue;
+
+			for ( const int32 Index : *Cell )
+			{
+				AActor* Target = Targets[Index].Get( );
+				if ( Target == nullptr || Target == Causer || Target == CauserOwner || Target == InstigatorPawn || !IsLiveTarget( Target ) ) continue;
+
+				const FTargetEntry& Entry = Entries[Index];
+				FVector Closest;
+				const float DamageScale = GetDamageScale( Area, Entry, CosHalfAngle, Closest );
+				if ( DamageScale <= 0.f ) continue;
+
+				// impact on the side of the target facing the blast, for the hit react direction
+				FSlashDamageEvent Event;
+				Event.Target = Target;
+				Event.Causer = Causer;
+				Event.Instigator = Instigator;
+				Event.ImpactPoint = Entry.Location + (Closest - Entry.Location).GetSafeNormal2D( ) * Entry.Radius;
+				Event.Damage = Area.Damage * DamageScale;
+				DamageEvents->QueueDamage( Event );
+				++NumHits;
+			}
+		}
+	}
+	return NumHits;
+}
+
+void UAreaDamageSubsystem::GatherTargets( const FVector& Center, float Radius, TArray<AActor*>& OutTargets )
+{
+	RebuildGridIfStale( );
+
+	const FIntPoint MinCell = GetCell( Center - FVector( Radius ) );
+	const FIntPoint MaxCell = GetCell( Center + FVector( Radius ) );
+	const double RadiusSquared = FMath::Square( Radius );
+	for ( int32 CellX = MinCell.X; CellX <= MaxCell.X; ++CellX )
+	{
+		for ( int32 CellY = MinCell.Y; CellY <= MaxCell.Y; ++CellY )
+		{
+			const TArray<int32>* Cell = Cells.Find( FIntPoint( CellX, CellY ) );
+			if ( Cell == nullptr ) continue;
+
+			for ( const int32 Index : *Cell )
+			{
+				AActor* Target = Targets[Index].Get( );
+				if ( Target && IsLiveTarget( Target ) && FVector::DistSquared( Entries[Index].Location, Center ) <= RadiusSquared )
+				{
+					OutTargets.Add( Target );
+				}
+			}
+		}
+	}
+}
+
+bool UAreaDamageSubsystem::IsLiveTarget( AActor* Target )
+{
+	if ( const AEnemy* Enemy = Cast<AEnemy>( Target ) )
+	{
+		return Enemy->GetEnemyState( ) != EEnemyState::EES_Dead;
+	}
+	ABaseCharacter* Character = Cast<ABaseCharacter>( Target );
+	return Character == nullptr || Character->IsAlive( );
+}
+
+float UAreaDamageSubsystem::GetDamageScale( const FSlashAreaDamage& Area, const FTargetEntry& Entry, double CosHalfAngle, FVector& OutClosest ) const
+{
+	OutClosest = Area.Shape == EAreaDamageShape::EADS_CapsuleSweep ?
+		FMath::ClosestPointOnSegment( Entry.Location, Area.Origin, Area.SweepEnd ) :
+		Area.Origin;
+
+	const double ReachSquared = FMath::Square( Area.Radius + Entry.Radius );
+	const double DistanceSquared = FVector::DistSquared( Entry.Location, OutClosest );
+	if ( DistanceSquared > ReachSquared ) return 0.f;
+
+	const double Distance = FMath::Sqrt( DistanceSquared );
+	if ( Area.Shape == EAreaDamageShape::EADS_Cone && Distance > UE_KINDA_SMALL_NUMBER )
+	{
+		const FVector ToTarget = Entry.Location - Area.Origin;
+		if ( FVector::DotProduct( ToTarget, Area.Direction.GetSafeNormal( ) ) < Distance * CosHalfAngle ) return 0.f;
+	}
+
+	const double Alpha = FMath::Clamp( (Distance - Entry.Radius) / Area.Radius, 0.0, 1.0 );
+	return FMath::Lerp( 1.f, Area.MinDamageScale, static_cast<float>( Alpha ) );
+}
@@ -0,0 +1,91 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "World/CombatAssetSubsystem.h"
+#include "Interfaces/CombatAssetInterface.h"
+#include "GameFramework/Actor.h"
+
+void UCombatAssetSubsystem::AcquireBundle( const AActor* Actor, FSimpleDelegate OnLoaded )
+{
+	if ( Actor == nullptr ) return;
+
+	UClass* Class = Actor->GetClass( );
+	const ICombatAssetInterface* Source = Cast<ICombatAssetInterface>( Class->GetDefaultObject( ) );
+	if ( Source == nullptr )
+	{
+		// nothing to stream, so nothing to wait for
+		OnLoaded.ExecuteIfBound( );
+		return;
+	}
+
+	FCombatAssetBundle& Bundle = Bundles.FindOrAdd( Class );
+	if ( Bundle.Users.Num( ) == 0 )
+	{
+		TArray<FSoftObjectPath> Assets;
+		Source->GatherCombatAssets( Assets );
+		if ( Assets.Num( ) > 0 )
+		{
+			Bundle.Handle = StreamableManager.RequestAsyncLoad( Assets, FStreamableDelegate::CreateUObject( this, &UCombatAssetSubsystem::OnBundleLoaded, TObjectKey<UClass>( Class ) ) );
+		}
+	}
+	Bundle.Users.Add( Actor );
+
+	if ( !OnLoaded.IsBound( ) ) return;
+	if ( Bundle.Handle.IsValid( ) && Bundle.Handle->IsLoadingInProgress( ) )
+	{
+		Bundle.PendingCallbacks.Emplace( Actor, MoveTemp( OnLoaded ) );
+		return;
+	}
+	OnLoaded.Execute( );
+}
+
+void UCombatAssetSubsystem::OnBundleLoaded( TObjectKey<UClass> ClassKey )
+{
+	FCombatAssetBundle* Bundle = Bundles.Find( ClassKey );
+	if ( Bundle == nullptr || (Bundle->Handle.IsValid( ) && Bundle->Handle->IsLoadingInProgress( )) ) return;
+
+	// a callback may acquire or release bundles itself, so run them off a local list
+	TArray<TPair<TObjectKey<AActor>, FSimpleDelegate>> Callbacks = MoveTemp( Bundle->PendingCallbacks );
+	for ( TPair<TObjectKey<AActor>, FSimpleDelegate>& Callback : Callbacks )
+	{
+		Callback.Value.ExecuteIfBound( );
+	}
+}
+
+void UCombatAssetSubsystem::LoadAsync( const FSoftObjectPath& Asset, FStreamableDelegate OnLoaded )
+{
+	StreamableManager.RequestAsyncLoad( Asset, MoveTemp( OnLoaded ) );
+}
+
+void UCombatAssetSubsystem::ReleaseBundle( const AActor* Actor )
+{
+	if ( Actor == nullptr ) return;
+
+	const TObjectKey<UClass> ClassKey( Actor->GetClass( ) );
+	FCombatAssetBundle* Bundle = Bundles.Find( ClassKey );
+	if ( Bundle == nullptr || Bundle->Users.Remove( Actor ) == 0 ) return;
+
+	const TObjectKey<AActor> ActorKey( Actor );
+	Bundle->PendingCallbacks.RemoveAll( [&ActorKey]( const TPair<TObjectKey<AActor>, FSimpleDelegate>& Callback ) { return Callback.Key == ActorKey; } );
+	if ( Bundle->Users.Num( ) > 0 ) return;
+
+	if ( Bundle->Handle.IsValid( ) )
+	{
+		Bundle->Handle->ReleaseHandle( );
+	}
+	Bundles.Remove( ClassKey );
+}
+
+void UCombatAssetSubsystem::Deinitialize( )
+{
+	for ( TPair<TObjectKey<UClass>, FCombatAssetBundle>& Pair : Bundles )
+	{
+		if ( Pair.Value.Handle.IsValid( ) )
+		{
+			Pair.Value.Handle->ReleaseHandle( );
+		}
+	}
+	Bundles.Empty( );
+
+	Super::Deinitialize( );
+}
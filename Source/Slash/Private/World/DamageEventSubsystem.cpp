@@ -0,0 +1,126 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "World/DamageEventSubsystem.h"
+#include "Interfaces/HitInterface.h"
+#include "Characters/HitDirection.h"
+#include "Items/Weapons/Weapon.h"
+#include "Kismet/GameplayStatics.h"
+#include "GameFramework/DamageType.h"
+#include "Slash/SlashStats.h"
+
+void UDamageEventSubsystem::QueueDamage( const FSlashDamageEvent& Event )
+{
+	PendingEvents.Enqueue( Event );
+}
+
+void UDamageEventSubsystem::Tick( float DeltaTime )
+{
+	SLASH_SCOPE_CYCLE_COUNTER( STAT_SlashDamageEvents );
+
+	FrameEvents.Reset( );
+	FSlashDamageEvent Event;
+	while ( PendingEvents.Dequeue( Event ) )
+	{
+		FrameEvents.Add( Event );
+	}
+	if ( FrameEvents.Num( ) == 0 ) return;
+
+	ApplyHealthPhase( );
+
+	// i-frame drops were reset by the health phase; nothing later should see them
+	FrameEvents.RemoveAll( []( const FSlashDamageEvent& Dropped ) { return !Dropped.Target.IsValid( ); } );
+	if ( FrameEvents.Num( ) == 0 ) return;
+
+	ApplyReactionPhase( );
+	ApplyEffectsPhase( );
+	ApplyAudioPhase( );
+}
+
+void UDamageEventSubsystem::ApplyHealthPhase( )
+{
+	for ( FSlashDamageEvent& Event : FrameEvents )
+	{
+		AActor* Target = Event.Target.Get( );
+		if ( Target == nullptr ) continue;
+
+		// i-frames: drop the whole hit, so the later phases skip it too
+		const IHitInterface* HitInterface = Cast<IHitInterface>( Target );
+		if ( HitInterface && HitInterface->IsInvulnerable( ) )
+		{
+			Event.Target.Reset( );
+			continue;
+		}
+		INC_DWORD_STAT( STAT_SlashHitsApplied );
+
+		UGameplayStatics::ApplyDamage(
+			Target,
+			Event.Damage,
+			Event.Instigator.Get( ),
+			Event.Causer.Get( ),
+			UDamageType::StaticClass( )
+		);
+	}
+}
+
+void UDamageEventSubsystem::ApplyReactionPhase( )
+{
+	for ( const FSlashDamageEvent& Event : FrameEvents )
+	{
+		AActor* Target = Event.Target.Get( );
+		if ( Target && Target->Implements<UHitInterface>( ) )
+		{
+			IHitInterface::Execute_GetHit( Target, Event.ImpactPoint );
+		}
+	}
+}
+
+void UDamageEventSubsystem::ApplyEffectsPhase( )
+{
+	// classify every hit of the frame in one pass, so a cleave through a crowd is one batch
+	const int32 NumEvents = FrameEvents.Num( );
+	HitForwards.SetNumUninitialized( NumEvents, false );
+	HitLocations.SetNumUninitialized( NumEvents, false );
+	HitImpactPoints.SetNumUninitialized( NumEvents, false );
+	HitDirections.SetNumUninitialized( NumEvents, false );
+	for ( int32 Index = 0; Index < NumEvents; ++Index )
+	{
+		const AActor* Target = FrameEvents[Index].Target.Get( );
+		HitForwards[Index] = Target ? Target->GetActorForwardVector( ) : FVector::ForwardVector;
+		HitLocations[Index] = Target ? Target->GetActorLocation( ) : FVector::ZeroVector;
+		HitImpactPoints[Index] = FrameEvents[Index].ImpactPoint;
+	}
+	HitDirection::Classify( HitForwards, HitLocations, HitImpactPoints, HitDirections );
+
+	for ( int32 Index = 0; Index < NumEvents; ++Index )
+	{
+		const FSlashDamageEvent& Event = FrameEvents[Index];
+		AActor* Target = Event.Target.Get( );
+		if ( Target == nullptr ) continue;
+
+		if ( IHitInterface* HitInterface = Cast<IHitInterface>( Target ) )
+		{
+			HitInterface->PlayHitEffects( Event.ImpactPoint, HitDirections[Index] );
+		}
+		if ( AWeapon* Weapon = Cast<AWeapon>( Event.Causer.Get( ) ) )
+		{
+			Weapon->MulticastHitConfirmed( Event.ImpactPoint, Target );
+		}
+	}
+}
+
+void UDamageEventSubsystem::ApplyAudioPhase( )
+{
+	for ( const FSlashDamageEvent& Event : FrameEvents )
+	{
+		if ( IHitInterface* HitInterface = Cast<IHitInterface>( Event.Target.Get( ) ) )
+		{
+			HitInterface->PlayHitAudio( Event.ImpactPoint );
+		}
+	}
+}
+
+TStatId UDamageEventSubsystem::GetStatId( ) const
+{
+	return GET_STATID( STAT_SlashDamageEvents );
+}
@@ -0,0 +1,154 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "World/FootPlacementSubsystem.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/PlayerController.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+#include "Engine/Engine.h"
+#include "Slash/SlashStats.h"
+
+bool UFootPlacementSubsystem::ShouldCreateSubsystem( UObject* Outer ) const
+{
+	// nothing is rendered on a dedicated server, so there are no feet to place
+	return !IsRunningDedicatedServer( ) && Super::ShouldCreateSubsystem( Outer );
+}
+
+void UFootPlacementSubsystem::RegisterCharacter( ACharacter* Character, FName LeftFootSocket, FName RightFootSocket )
+{
+	if ( Character == nullptr || PlacementIndices.Contains( Character ) ) return;
+
+	PlacementIndices.Add( Character );
+	FFootPlacement& Placement = Placements.AddDefaulted_GetRef( );
+	Placement.Character = Character;
+	Placement.Feet[Left].Socket = LeftFootSocket;
+	Placement.Feet[Right].Socket = RightFootSocket;
+}
+
+void UFootPlacementSubsystem::UnregisterCharacter( ACharacter* Character )
+{
+	const int32 Index = PlacementIndices.Find( Character );
+	if ( Index != INDEX_NONE )
+	{
+		RemoveAtSwap( Index );
+	}
+}
+
+bool UFootPlacementSubsystem::GetFootGround( const ACharacter* Character, FSlashFootGround& OutLeft, FSlashFootGround& OutRight ) const
+{
+	const int32 Index = PlacementIndices.Find( Character );
+	if ( Index == INDEX_NONE ) return false;
+
+	const FFootPlacement& Placement = Placements[Index];
+	const float BaseZ = Character->GetActorLocation( ).Z - Character->GetCapsuleComponent( )->GetScaledCapsuleHalfHeight( );
+	FSlashFootGround* Out[NumFeet] = { &OutLeft, &OutRight };
+	for ( int32 Foot = 0; Foot < NumFeet; ++Foot )
+	{
+		const FFootProbe& Probe = Placement.Feet[Foot];
+		Out[Foot]->Offset = Probe.bValid ? Probe.GroundZ - BaseZ : 0.f;
+		Out[Foot]->Normal = Probe.Normal;
+		Out[Foot]->bValid = Probe.bValid;
+	}
+	return true;
+}
+
+void UFootPlacementSubsystem::Tick( float DeltaTime )
+{
+	SLASH_SCOPE_CYCLE_COUNTER( STAT_SlashFootPlacement );
+
+	ReadProbes( );
+	IssueProbes( DeltaTime );
+}
+
+void UFootPlacementSubsystem::ReadProbes( )
+{
+	UWorld* World = GetWorld( );
+	FTraceDatum Datum;
+	for ( FFootPlacement& Placement : Placements )
+	{
+		for ( FFootProbe& Probe : Placement.Feet )
+		{
+			if ( !Probe.Trace.IsValid( ) || !World->QueryTraceData( Probe.Trace, Datum ) ) continue;
+			Probe.Trace = FTraceHandle( );
+
+			const FHitResult* Hit = Datum.OutHits.FindByPredicate( []( const FHitResult& Result ) { return Result.bBlockingHit; } );
+			Probe.bValid = Hit != nullptr;
+			if ( Hit )
+			{
+				Probe.GroundZ = Hit->ImpactPoint.Z;
+				Probe.Normal = Hit->ImpactNormal;
+			}
+		}
+	}
+}
+
+void UFootPlacementSubsystem::IssueProbes( float DeltaTime )
+{
+	FVector ViewLocation;
+	const bool bHasView = GetViewLocation( ViewLocation );
+	const float NearDistanceSquared = FMath::Square( NearDistance );
+	const float MaxDistanceSquared = FMath::Square( MaxDistance );
+
+	UWorld* World = GetWorld( );
+	FCollisionQueryParams Params( SCENE_QUERY_STAT( SlashFootPlacement ), false );
+	for ( int32 Index = Placements.Num( ) - 1; Index >= 0; --Index )
+	{
+		FFootPlacement& Placement = Placements[Index];
+		ACharacter* Character = Placement.Character.Get( );
+		if ( Character == nullptr )
+		{
+			RemoveAtSwap( Index );
+			continue;
+		}
+
+		// significance: unseen or far characters keep no ground, so their IK blends out instead of holding stale data
+		const USkeletalMeshComponent* Mesh = Character->GetMesh( );
+		const float DistanceSquared = bHasView ? FVector::DistSquared( ViewLocation, Character->GetActorLocation( ) ) : 0.f;
+		if ( Mesh == nullptr || !Mesh->WasRecentlyRendered( 0.2f ) || DistanceSquared > MaxDistanceSquared )
+		{
+			for ( FFootProbe& Probe : Placement.Feet )
+			{
+				Probe.bValid = false;
+			}
+			continue;
+		}
+
+		Placement.TimeUntilProbe -= DeltaTime;
+		if ( DistanceSquared > NearDistanceSquared && Placement.TimeUntilProbe > 0.f ) continue;
+		Placement.TimeUntilProbe = FarProbeInterval;
+
+		const float BaseZ = Character->GetActorLocation( ).Z - Character->GetCapsuleComponent( )->GetScaledCapsuleHalfHeight( );
+		Params.ClearIgnoredActors( );
+		Params.AddIgnoredActor( Character );
+		for ( FFootProbe& Probe : Placement.Feet )
+		{
+			const FVector Foot = Mesh->GetSocketLocation( Probe.Socket );
+			const FVector Start( Foot.X, Foot.Y, BaseZ + TraceUp );
+			const FVector End( Foot.X, Foot.Y, BaseZ - TraceDown );
+			Probe.Trace = World->AsyncLineTraceByChannel( EAsyncTraceType::Single, Start, End, ECollisionChannel::ECC_Visibility, Params );
+		}
+	}
+}
+
+bool UFootPlacementSubsystem::GetViewLocation( FVector& OutLocation ) const
+{
+	const APlayerController* PlayerController = GEngine ? GEngine->GetFirstLocalPlayerController( GetWorld( ) ) : nullptr;
+	if ( PlayerController == nullptr || PlayerController->PlayerCameraManager == nullptr ) return false;
+
+	OutLocation = PlayerController->PlayerCameraManager->GetCameraLocation( );
+	return true;
+}
+
+void UFootPlacementSubsystem::RemoveAtSwap( int32 Index )
+{
+	PlacementIndices.RemoveAtSwap( Index );
+	Placements.RemoveAtSwap( Index, 1, false );
+}
+
+TStatId UFootPlacementSubsystem::GetStatId( ) const
+{
+	return GET_STATID( STAT_SlashFootPlacement );
+}
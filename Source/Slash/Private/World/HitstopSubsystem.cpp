@@ -0,0 +1,103 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "World/HitstopSubsystem.h"
+#include "GameFramework/Actor.h"
+#include "GameFramework/Pawn.h"
+#include "Slash/SlashStats.h"
+
+void UHitstopSubsystem::Deinitialize( )
+{
+	for ( const FHitstop& Hitstop : Hitstops )
+	{
+		if ( AActor* Actor = Hitstop.Actor.Get( ) )
+		{
+			Actor->CustomTimeDilation = Hitstop.BaseDilation;
+		}
+	}
+	Hitstops.Reset( );
+	HitstopIndices.Reset( );
+
+	Super::Deinitialize( );
+}
+
+void UHitstopSubsystem::AddPulse( AActor* Actor, float Duration, float Dilation )
+{
+	if ( Actor == nullptr || Duration <= 0.f || !CanDilate( Actor ) ) return;
+	Dilation = FMath::Clamp( Dilation, 0.f, 1.f );
+
+	const int32 Index = HitstopIndices.Find( Actor );
+	if ( Index != INDEX_NONE )
+	{
+		FHitstop& Hitstop = Hitstops[Index];
+		Hitstop.Dilation = FMath::Min( Hitstop.Dilation, Dilation );
+		Hitstop.Remaining = FMath::Min( Hitstop.Remaining + Duration, MaxDuration );
+		return;
+	}
+
+	HitstopIndices.Add( Actor );
+	FHitstop& Hitstop = Hitstops.AddDefaulted_GetRef( );
+	Hitstop.Actor = Actor;
+	Hitstop.Dilation = Dilation;
+	Hitstop.Remaining = FMath::Min( Duration, MaxDuration );
+	Hitstop.BaseDilation = Actor->CustomTimeDilation;
+	Actor->CustomTimeDilation = Hitstop.BaseDilation * Dilation;
+}
+
+void UHitstopSubsystem::AddHitPulse( AActor* Attacker, AActor* Victim, float Duration, float Dilation )
+{
+	// a dedicated server has no viewer, and nobody else's exchange of blows should stutter on this screen
+	const bool bStandalone = GetWorld( )->GetNetMode( ) == NM_Standalone;
+	if ( !bStandalone && !IsLocallyControlled( Attacker ) && !IsLocallyControlled( Victim ) ) return;
+
+	AddPulse( Attacker, Duration, Dilation );
+	AddPulse( Victim, Duration, Dilation );
+}
+
+bool UHitstopSubsystem::IsLocallyControlled( const AActor* Actor )
+{
+	const APawn* Pawn = Cast<APawn>( Actor );
+	return Pawn && Pawn->IsLocallyControlled( );
+}
+
+bool UHitstopSubsystem::CanDilate( const AActor* Actor )
+{
+	// CustomTimeDilation isn't replicated; on the server it would slow the AI and movement every client sees
+	return Actor->GetNetMode( ) == NM_Standalone || !Actor->HasAuthority( ) || IsLocallyControlled( Actor );
+}
+
+void UHitstopSubsystem::Tick( float DeltaTime )
+{
+	SLASH_SCOPE_CYCLE_COUNTER( STAT_SlashHitstop );
+
+	for ( int32 Index = Hitstops.Num( ) - 1; Index >= 0; --Index )
+	{
+		FHitstop& Hitstop = Hitstops[Index];
+		AActor* Actor = Hitstop.Actor.Get( );
+		Hitstop.Remaining -= DeltaTime;
+		if ( Actor == nullptr || Hitstop.Remaining <= 0.f )
+		{
+			if ( Actor )
+			{
+				Actor->CustomTimeDilation = Hitstop.BaseDilation;
+			}
+			RemoveAtSwap( Index );
+			continue;
+		}
+
+		// full stop until the decay, then ease back so the swing resumes without a pop
+		const float Alpha = DecayTime > 0.f ? FMath::Min( Hitstop.Remaining / DecayTime, 1.f ) : 1.f;
+		Actor->CustomTimeDilation = Hitstop.BaseDilation * FMath::Lerp( 1.f, Hitstop.Dilation, Alpha );
+	}
+}
+
+void UHitstopSubsystem::RemoveAtSwap( int32 Index )
+{
+	HitstopIndices.RemoveAtSwap( Index );
+	Hitstops.RemoveAtSwap( Index, 1, false );
+}
+
+TStatId UHitstopSubsystem::GetStatId( ) const
+{
+	return GET_STATID( STAT_SlashHitstop );
+}
@@ -0,0 +1,99 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "World/LagCompensationSubsystem.h"
+#include "Engine/World.h"
+#include "GameFramework/GameStateBase.h"
+#include "Slash/SlashStats.h"
+
+void ULagCompensationSubsystem::RegisterActor( AActor* Actor )
+{
+	if ( Actor == nullptr ) return;
+
+	FLocationHistory& History = Histories.FindOrAdd( Actor );
+	FLocationSample Sample;
+	Sample.Time = GetWorld( )->GetTimeSeconds( );
+	Sample.Location = Actor->GetActorLocation( );
+	History.Samples.Init( Sample, GetHistoryLength( ) );
+	History.Head = 0;
+}
+
+void ULagCompensationSubsystem::UnregisterActor( AActor* Actor )
+{
+	Histories.Remove( Actor );
+}
+
+FVector ULagCompensationSubsystem::GetLocationAtTime( const AActor* Actor, double Time ) const
+{
+	const FLocationHistory* History = Histories.Find( Actor );
+	if ( History == nullptr || History->Samples.Num( ) == 0 ) return Actor ? Actor->GetActorLocation( ) : FVector::ZeroVector;
+
+	const int32 NumSamples = History->Samples.Num( );
+	const FLocationSample* Older = &History->Samples[History->Head];
+	if ( Time <= Older->Time ) return Older->Location;
+
+	// walk forward from the oldest sample to the pair that brackets Time
+	for ( int32 Offset = 1; Offset < NumSamples; ++Offset )
+	{
+		const FLocationSample& Newer = History->Samples[(History->Head + Offset) % NumSamples];
+		if ( Time <= Newer.Time )
+		{
+			const double Span = Newer.Time - Older->Time;
+			const double Alpha = Span > UE_SMALL_NUMBER ? (Time - Older->Time) / Span : 1.0;
+			return FMath::Lerp( Older->Location, Newer.Location, Alpha );
+		}
+		Older = &Newer;
+	}
+	return Actor->GetActorLocation( );
+}
+
+double ULagCompensationSubsystem::GetClientViewTime( ) const
+{
+	const AGameStateBase* GameState = GetWorld( )->GetGameState( );
+	const double ServerTime = GameState ? GameState->GetServerWorldTimeSeconds( ) : GetWorld( )->GetTimeSeconds( );
+	return ServerTime - InterpolationDelay;
+}
+
+void ULagCompensationSubsystem::Tick( float DeltaTime )
+{
+	SLASH_SCOPE_TRACE( STAT_SlashLagCompensationTick );
+
+	TimeSinceSample += DeltaTime;
+	if ( Histories.Num( ) == 0 || TimeSinceSample < 1.0 / SampleRate ) return;
+	TimeSinceSample = 0.0;
+
+	const double Now = GetWorld( )->GetTimeSeconds( );
+	for ( auto It = Histories.CreateIterator( ); It; ++It )
+	{
+		const AActor* Actor = It.Key( ).Get( );
+		if ( Actor == nullptr )
+		{
+			It.RemoveCurrent( );
+			continue;
+		}
+
+		// overwrite the oldest sample, which moves the head on by one
+		FLocationHistory& History = It.Value( );
+		FLocationSample& Sample = History.Samples[History.Head];
+		Sample.Time = Now;
+		Sample.Location = Actor->GetActorLocation( );
+		History.Head = (History.Head + 1) % History.Samples.Num( );
+	}
+}
+
+TStatId ULagCompensationSubsystem::GetStatId( ) const
+{
+	return GET_STATID( STAT_SlashLagCompensationTick );
+}
+
+void ULagCompensationSubsystem::Deinitialize( )
+{
+	Histories.Empty( );
+
+	Super::Deinitialize( );
+}
+
+int32 ULagCompensationSubsystem::GetHistoryLength( ) const
+{
+	return FMath::Max( FMath::CeilToInt( MaxRewindTime * SampleRate ) + 1, 2 );
+}
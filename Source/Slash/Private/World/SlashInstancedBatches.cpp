@@ -0,0 +1,105 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "World/SlashInstancedBatches.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/World.h"
+
+int32 FSlashInstancedBatches::AddBatch( UWorld* World, UStaticMesh* Mesh )
+{
+	// batch indices are stored as uint16; MAX_uint16 itself is never handed out
+	if ( World == nullptr || Batches.Num( ) >= MAX_uint16 ) return INDEX_NONE;
+
+	AActor* Owner = InstanceOwner.Get( );
+	if ( Owner == nullptr )
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.ObjectFlags |= RF_Transient;
+		Owner = World->SpawnActor<AActor>( AActor::StaticClass( ), FTransform::Identity, SpawnParams );
+		if ( Owner == nullptr ) return INDEX_NONE;
+		Owner->SetRootComponent( NewObject<USceneComponent>( Owner, TEXT( "Root" ) ) );
+		Owner->GetRootComponent( )->RegisterComponent( );
+		InstanceOwner = Owner;
+	}
+
+	UInstancedStaticMeshComponent* Instances = NewObject<UInstancedStaticMeshComponent>( Owner );
+	Instances->SetStaticMesh( Mesh );
+	Instances->SetCollisionEnabled( ECollisionEnabled::NoCollision );
+	Instances->SetCanEverAffectNavigation( false );
+	Instances->SetupAttachment( Owner->GetRootComponent( ) );
+	Instances->RegisterComponent( );
+
+	FBatch& Batch = Batches.AddDefaulted_GetRef( );
+	Batch.Instances = Instances;
+	return Batches.Num( ) - 1;
+}
+
+void FSlashInstancedBatches::AddEntry( int32 BatchIndex, const FTransform& Transform )
+{
+	FBatch& Batch = Batches[BatchIndex];
+	EntryBatches.Add( static_cast<uint16>( BatchIndex ) );
+	EntryInstances.Add( Batch.Entries.Add( EntryBatches.Num( ) - 1 ) );
+
+	if ( UInstancedStaticMeshComponent* Instances = Batch.Instances.Get( ) )
+	{
+		Instances->AddInstance( Transform, true );
+	}
+}
+
+void FSlashInstancedBatches::RemoveAtSwap( int32 Index )
+{
+	FBatch& Batch = Batches[EntryBatches[Index]];
+	UInstancedStaticMeshComponent* Instances = Batch.Instances.Get( );
+	const int32 Instance = EntryInstances[Index];
+
+	// the batch's last instance fills the hole, so only the tail is ever removed and no other instance shifts
+	const int32 LastInstance = Batch.Entries.Num( ) - 1;
+	if ( Instance != LastInstance )
+	{
+		const int32 MovedEntry = Batch.Entries[LastInstance];
+		Batch.Entries[Instance] = MovedEntry;
+		EntryInstances[MovedEntry] = Instance;
+
+		FTransform Transform;
+		if ( Instances && Instances->GetInstanceTransform( LastInstance, Transform, true ) )
+		{
+			Instances->UpdateInstanceTransform( Instance, Transform, true, false, true );
+		}
+	}
+	Batch.Entries.Pop( false );
+	if ( Instances )
+	{
+		Instances->RemoveInstance( LastInstance );
+	}
+
+	// then the owner's last entry moves into slot Index
+	const int32 LastEntry = EntryBatches.Num( ) - 1;
+	if ( Index != LastEntry )
+	{
+		Batches[EntryBatches[LastEntry]].Entries[EntryInstances[LastEntry]] = Index;
+	}
+	EntryBatches.RemoveAtSwap( Index, 1, false );
+	EntryInstances.RemoveAtSwap( Index, 1, false );
+}
+
+void FSlashInstancedBatches::Reset( )
+{
+	InstanceOwner.Reset( );
+	Batches.Empty( );
+	EntryBatches.Empty( );
+	EntryInstances.Empty( );
+	Transforms.Empty( );
+}
+
+UInstancedStaticMeshComponent* FSlashInstancedBatches::GetInstances( int32 BatchIndex ) const
+{
+	return Batches[BatchIndex].Instances.Get( );
+}
+
+void FSlashInstancedBatches::FlushTransforms( FBatch& Batch )
+{
+	UInstancedStaticMeshComponent* Instances = Batch.Instances.Get( );
+	if ( Instances == nullptr || Transforms.Num( ) == 0 ) return;
+
+	Instances->BatchUpdateInstancesTransforms( 0, Transforms, true, true );
+}
@@ -0,0 +1,49 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "World/SlashRandomSubsystem.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Misc/CommandLine.h"
+
+void USlashRandomSubsystem::Initialize( FSubsystemCollectionBase& Collection )
+{
+	Super::Initialize( Collection );
+
+	int32 Seed = DefaultSeed;
+	FParse::Value( FCommandLine::Get( ), TEXT( "SlashSeed=" ), Seed );
+	if ( Seed == 0 )
+	{
+		Seed = static_cast<int32>( FPlatformTime::Cycles( ) );
+	}
+	SetMasterSeed( Seed );
+}
+
+void USlashRandomSubsystem::SetMasterSeed( int32 Seed )
+{
+	MasterSeed = Seed;
+	for ( int32 Index = 0; Index < UE_ARRAY_COUNT( Streams ); ++Index )
+	{
+		Streams[Index].Initialize( static_cast<int32>( HashCombine( GetTypeHash( MasterSeed ), GetTypeHash( Index + 1 ) ) ) );
+	}
+
+	UE_LOG( LogTemp, Log, TEXT( "Slash random seed %d (rerun with -SlashSeed=%d)" ), MasterSeed, MasterSeed );
+}
+
+FRandomStream& USlashRandomSubsystem::GetStream( ESlashRandomStream Stream )
+{
+	check( Stream < ESlashRandomStream::ESRS_MAX );
+	return Streams[static_cast<int32>( Stream )];
+}
+
+FRandomStream& USlashRandomSubsystem::GetStream( const UObject* WorldContextObject, ESlashRandomStream Stream )
+{
+	const UWorld* World = GEngine ? GEngine->GetWorldFromContextObject( WorldContextObject, EGetWorldErrorMode::ReturnNull ) : nullptr;
+	if ( USlashRandomSubsystem* Random = World ? World->GetSubsystem<USlashRandomSubsystem>( ) : nullptr )
+	{
+		return Random->GetStream( Stream );
+	}
+
+	static FRandomStream Fallback( static_cast<int32>( FPlatformTime::Cycles( ) ) );
+	return Fallback;
+}
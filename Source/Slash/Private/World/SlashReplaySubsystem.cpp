@@ -0,0 +1,208 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "World/SlashReplaySubsystem.h"
+#include "World/SlashRandomSubsystem.h"
+#include "Characters/SlashCharacter.h"
+#include "Kismet/GameplayStatics.h"
+#include "Engine/World.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace SlashReplay
+{
+	constexpr uint32 Magic = 0x504C5253; // "SRLP"
+	constexpr uint16 Version = 1;
+
+	bool HasAxisValue( ESlashInputAction Action )
+	{
+		return Action == ESlashInputAction::ESIA_Move || Action == ESlashInputAction::ESIA_Look || Action == ESlashInputAction::ESIA_SwitchTarget;
+	}
+}
+
+bool USlashReplaySubsystem::DoesSupportWorldType( const EWorldType::Type WorldType ) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void USlashReplaySubsystem::Initialize( FSubsystemCollectionBase& Collection )
+{
+	Super::Initialize( Collection );
+
+	USlashRandomSubsystem* Random = Cast<USlashRandomSubsystem>( Collection.InitializeDependency( USlashRandomSubsystem::StaticClass( ) ) );
+
+	const TCHAR* CommandLine = FCommandLine::Get( );
+	bFixedStep |= FParse::Param( CommandLine, TEXT( "SlashFixedStep" ) );
+	bExitWhenFinished = FParse::Param( CommandLine, TEXT( "SlashReplayExit" ) );
+	FixedDeltaTime = 1.f / FMath::Max( FixedStepRate, 1.f );
+
+	if ( FParse::Value( CommandLine, TEXT( "SlashReplay=" ), ReplayName ) )
+	{
+		TArray<uint8> Bytes;
+		if ( FFileHelper::LoadFileToArray( Bytes, *GetReplayPath( ) ) )
+		{
+			FMemoryReader Reader( Bytes );
+			SerializeReplay( Reader );
+			bPlayingBack = !Reader.IsError( );
+		}
+		if ( !bPlayingBack )
+		{
+			UE_LOG( LogTemp, Error, TEXT( "Could not read replay %s" ), *GetReplayPath( ) );
+		}
+		else if ( Random )
+		{
+			// same seed, same rolls
+			Random->SetMasterSeed( Seed );
+		}
+	}
+	else if ( FParse::Value( CommandLine, TEXT( "SlashRecord=" ), ReplayName ) )
+	{
+		bRecording = true;
+		Seed = Random ? Random->GetMasterSeed( ) : 0;
+	}
+
+	// input is applied per frame, so a replay only lines up when every frame advances by the same step
+	if ( bFixedStep || bRecording || bPlayingBack )
+	{
+		FApp::SetUseFixedTimeStep( true );
+		FApp::SetFixedDeltaTime( FixedDeltaTime );
+	}
+
+	if ( bRecording || bPlayingBack )
+	{
+		TickStartHandle = FWorldDelegates::OnWorldTickStart.AddUObject( this, &USlashReplaySubsystem::OnWorldTickStart );
+	}
+}
+
+void USlashReplaySubsystem::Deinitialize( )
+{
+	FWorldDelegates::OnWorldTickStart.Remove( TickStartHandle );
+
+	if ( bRecording )
+	{
+		TArray<uint8> Bytes;
+		FMemoryWriter Writer( Bytes );
+		SerializeReplay( Writer );
+		FFileHelper::SaveArrayToFile( Bytes, *GetReplayPath( ) );
+		UE_LOG( LogTemp, Log, TEXT( "Recorded %d inputs over %u frames to %s" ), Records.Num( ), Frame, *GetReplayPath( ) );
+	}
+
+	Records.Empty( );
+	Super::Deinitialize( );
+}
+
+bool USlashReplaySubsystem::AcceptInput( ESlashInputAction Action, const FVector2D& Value )
+{
+	if ( bPlayingBack ) return bDispatching;
+
+	if ( bRecording )
+	{
+		FInputRecord& Record = Records.AddDefaulted_GetRef( );
+		Record.Frame = Frame;
+		Record.Action = Action;
+		Record.Value = FVector2f( Value );
+	}
+	return true;
+}
+
+void USlashReplaySubsystem::OnWorldTickStart( UWorld* World, ELevelTick TickType, float DeltaSeconds )
+{
+	if ( World != GetWorld( ) ) return;
+
+	// inputs are stamped and replayed against the same counter, before any actor ticks this frame
+	++Frame;
+	if ( bPlayingBack )
+	{
+		DispatchFrame( );
+	}
+}
+
+void USlashReplaySubsystem::DispatchFrame( )
+{
+	ASlashCharacter* Character = Cast<ASlashCharacter>( UGameplayStatics::GetPlayerPawn( GetWorld( ), 0 ) );
+
+	bDispatching = true;
+	while ( Records.IsValidIndex( PlaybackIndex ) && Records[PlaybackIndex].Frame <= Frame )
+	{
+		const FInputRecord& Record = Records[PlaybackIndex++];
+		if ( Character )
+		{
+			Character->ReplayInput( Record.Action, FVector2D( Record.Value ) );
+		}
+	}
+	bDispatching = false;
+
+	if ( PlaybackIndex == Records.Num( ) )
+	{
+		++PlaybackIndex;
+		UE_LOG( LogTemp, Log, TEXT( "Replay %s finished at frame %u" ), *ReplayName, Frame );
+		if ( bExitWhenFinished )
+		{
+			FPlatformMisc::RequestExit( false );
+		}
+	}
+}
+
+/*
+*  header, then one entry per input: packed frame delta, action, and the axis value for move and look
+*/
+void USlashReplaySubsystem::SerializeReplay( FArchive& Ar )
+{
+	uint32 Magic = SlashReplay::Magic;
+	uint16 Version = SlashReplay::Version;
+	Ar << Magic;
+	Ar << Version;
+	if ( Magic != SlashReplay::Magic || Version != SlashReplay::Version )
+	{
+		Ar.SetError( );
+		return;
+	}
+
+	Ar << Seed;
+	Ar << FixedDeltaTime;
+
+	int32 NumRecords = Records.Num( );
+	Ar << NumRecords;
+	if ( Ar.IsLoading( ) )
+	{
+		if ( NumRecords < 0 || NumRecords > Ar.TotalSize( ) )
+		{
+			Ar.SetError( );
+			return;
+		}
+		Records.SetNum( NumRecords );
+	}
+
+	uint32 PreviousFrame = 0;
+	for ( FInputRecord& Record : Records )
+	{
+		uint32 FrameDelta = Record.Frame - PreviousFrame;
+		Ar.SerializeIntPacked( FrameDelta );
+		Record.Frame = PreviousFrame + FrameDelta;
+		PreviousFrame = Record.Frame;
+
+		uint8 Action = static_cast<uint8>( Record.Action );
+		Ar << Action;
+		Record.Action = static_cast<ESlashInputAction>( FMath::Min<uint8>( Action, static_cast<uint8>( ESlashInputAction::ESIA_MAX ) ) );
+
+		if ( SlashReplay::HasAxisValue( Record.Action ) )
+		{
+			Ar << Record.Value;
+		}
+	}
+}
+
+FString USlashReplaySubsystem::GetReplayPath( ) const
+{
+	FString FileName = ReplayName + TEXT( "_" ) + GetWorld( )->GetMapName( );
+	const int32 PIEInstance = GetWorld( )->GetOutermost( )->GetPIEInstanceID( );
+	if ( PIEInstance > 0 )
+	{
+		FileName += FString::Printf( TEXT( "_%d" ), PIEInstance );
+	}
+	return FPaths::ProjectSavedDir( ) / TEXT( "Replays" ) / FileName + TEXT( ".slashreplay" );
+}
@@ -0,0 +1,376 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "World/SlashSaveSubsystem.h"
+#include "World/StreamingDormancySubsystem.h"
+#include "Enemy/EnemyCrowdSubsystem.h"
+#include "Characters/SlashCharacter.h"
+#include "Components/AttributeComponent.h"
+#include "Items/Weapons/Weapon.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Async/Async.h"
+#include "Slash/SlashStats.h"
+
+namespace SlashSave
+{
+	static const uint32 Magic = 0x534C5356; // 'SLSV'
+
+	enum EVersion : int32
+	{
+		Initial = 1,
+
+		Latest = Initial
+	};
+
+	static const FName PlayerChunk( TEXT( "$Player" ) );
+
+	/* a corrupt count must fail the read instead of reserving more than the file could ever hold */
+	static bool IsCountPlausible( FArchive& Ar, int32 Count, int64 MinElementSize )
+	{
+		if ( Count >= 0 && Count <= ( Ar.TotalSize( ) - Ar.Tell( ) ) / MinElementSize ) return true;
+		Ar.SetError( );
+		return false;
+	}
+}
+
+void FSlashCellSaveData::Load( FArchive& Ar )
+{
+	int32 NumEnemies = 0;
+	Ar << NumEnemies;
+	if ( !SlashSave::IsCountPlausible( Ar, NumEnemies, sizeof( FGuid ) ) ) return;
+	Enemies.Reserve( NumEnemies );
+	for ( int32 Index = 0; Index < NumEnemies && !Ar.IsError( ); ++Index )
+	{
+		FGuid PersistentId;
+		FEnemyCompactState State;
+		Ar << PersistentId;
+		Ar << State;
+		Enemies.Add( PersistentId, State );
+	}
+
+	int32 NumRemoved = 0;
+	Ar << NumRemoved;
+	if ( !SlashSave::IsCountPlausible( Ar, NumRemoved, sizeof( FGuid ) ) ) return;
+	RemovedActors.Reserve( NumRemoved );
+	for ( int32 Index = 0; Index < NumRemoved && !Ar.IsError( ); ++Index )
+	{
+		FGuid PersistentId;
+		Ar << PersistentId;
+		RemovedActors.Add( PersistentId );
+	}
+}
+
+static FAutoConsoleCommandWithWorld SlashSaveCommand(
+	TEXT( "Slash.Save" ),
+	TEXT( "Writes the Slash save file in the background" ),
+	FConsoleCommandWithWorldDelegate::CreateLambda( []( UWorld* World )
+	{
+		if ( USlashSaveSubsystem* Save = USlashSaveSubsystem::Get( World ) )
+		{
+			Save->SaveGameAsync( );
+		}
+	} ) );
+
+void USlashSaveSubsystem::Initialize( FSubsystemCollectionBase& Collection )
+{
+	Super::Initialize( Collection );
+
+	if ( bLoadOnStart )
+	{
+		const FString Path = GetSavePath( );
+		PendingLoad = Async( EAsyncExecution::ThreadPool, [Path]( )
+		{
+			TArray<uint8> Bytes;
+			FFileHelper::LoadFileToArray( Bytes, *Path, FILEREAD_Silent );
+			return Bytes;
+		} );
+	}
+
+	TickerHandle = FTSTicker::GetCoreTicker( ).AddTicker( FTickerDelegate::CreateUObject( this, &USlashSaveSubsystem::Tick ) );
+}
+
+void USlashSaveSubsystem::Deinitialize( )
+{
+	FTSTicker::GetCoreTicker( ).RemoveTicker( TickerHandle );
+
+	if ( PendingLoad.IsValid( ) )
+	{
+		PendingLoad.Wait( );
+	}
+	if ( PendingWrite.IsValid( ) )
+	{
+		PendingWrite.Wait( );
+	}
+
+	Super::Deinitialize( );
+}
+
+USlashSaveSubsystem* USlashSaveSubsystem::Get( const UObject* WorldContextObject )
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld( ) : nullptr;
+	const UGameInstance* GameInstance = World ? World->GetGameInstance( ) : nullptr;
+	return GameInstance ? GameInstance->GetSubsystem<USlashSaveSubsystem>( ) : nullptr;
+}
+
+void USlashSaveSubsystem::RecordEnemy( const AActor* Enemy, const FEnemyCompactState& State )
+{
+	FGuid PersistentId;
+	if ( FSlashCellSaveData* CellData = FindCell( Enemy, PersistentId, true ) )
+	{
+		CellData->Enemies.Add( PersistentId, State );
+	}
+}
+
+void USlashSaveSubsystem::RecordEnemy( const ULevel* Level, const FGuid& PersistentId, const FEnemyCompactState& State )
+{
+	if ( Level == nullptr || !PersistentId.IsValid( ) ) return;
+	if ( FSlashCellSaveData* CellData = FindCell( GetCellName( Level ), true ) )
+	{
+		CellData->Enemies.Add( PersistentId, State );
+	}
+}
+
+bool USlashSaveSubsystem::ConsumeEnemyState( const AActor* Enemy, FEnemyCompactState& OutState )
+{
+	FGuid PersistentId;
+	FSlashCellSaveData* CellData = FindCell( Enemy, PersistentId, false );
+	const FEnemyCompactState* SavedState = CellData ? CellData->Enemies.Find( PersistentId ) : nullptr;
+	if ( SavedState == nullptr ) return false;
+
+	OutState = *SavedState;
+	if ( OutState.State != EEnemyState::EES_Dead )
+	{
+		CellData->Enemies.Remove( PersistentId );
+		DirtyCells.Add( GetCellName( Enemy->GetLevel( ) ) );
+	}
+	return true;
+}
+
+void USlashSaveSubsystem::RecordRemoved( const AActor* Actor )
+{
+	FGuid PersistentId;
+	if ( FSlashCellSaveData* CellData = FindCell( Actor, PersistentId, true ) )
+	{
+		CellData->RemovedActors.Add( PersistentId );
+	}
+}
+
+bool USlashSaveSubsystem::WasRemoved( const AActor* Actor )
+{
+	FGuid PersistentId;
+	const FSlashCellSaveData* CellData = FindCell( Actor, PersistentId, false );
+	return CellData && CellData->RemovedActors.Contains( PersistentId );
+}
+
+void USlashSaveSubsystem::CapturePlayer( const ASlashCharacter* Character )
+{
+	if ( Character == nullptr ) return;
+	WaitForLoad( );
+
+	const UAttributeComponent* Attributes = Character->FindComponentByClass<UAttributeComponent>( );
+	const AWeapon* Weapon = Character->GetEquippedWeapon( );
+	PlayerData.Health = Attributes ? Attributes->GetHealth( ) : 0.f;
+	PlayerData.WeaponClass = Weapon ? Weapon->GetClass( )->GetPathName( ) : FString( );
+	bHasPlayerData = true;
+}
+
+const FSlashPlayerSaveData* USlashSaveSubsystem::GetPlayerData( )
+{
+	WaitForLoad( );
+	return bHasPlayerData ? &PlayerData : nullptr;
+}
+
+FSlashCellSaveData* USlashSaveSubsystem::FindCell( const AActor* Actor, FGuid& OutId, bool bCreate )
+{
+	OutId = UStreamingDormancySubsystem::GetPersistentId( Actor );
+	if ( !OutId.IsValid( ) ) return nullptr;
+	return FindCell( GetCellName( Actor->GetLevel( ) ), bCreate );
+}
+
+FSlashCellSaveData* USlashSaveSubsystem::FindCell( FName CellName, bool bCreate )
+{
+	WaitForLoad( );
+
+	FSlashCellSaveData* CellData = Cells.Find( CellName );
+	if ( CellData == nullptr )
+	{
+		// first time this cell streamed in since the file was read: decode its chunk now
+		const TArray<uint8>* Blob = ChunkBlobs.Find( CellName );
+		if ( Blob == nullptr && !bCreate ) return nullptr;
+
+		CellData = &Cells.Add( CellName );
+		if ( Blob )
+		{
+			FMemoryReader Reader( *Blob );
+			Reader << *CellData;
+			if ( Reader.IsError( ) )
+			{
+				UE_LOG( LogTemp, Warning, TEXT( "Save chunk for %s is corrupt, starting the cell fresh" ), *CellName.ToString( ) );
+				*CellData = FSlashCellSaveData( );
+			}
+		}
+	}
+
+	if ( bCreate )
+	{
+		DirtyCells.Add( CellName );
+	}
+	return CellData;
+}
+
+FName USlashSaveSubsystem::GetCellName( const ULevel* Level )
+{
+	// World Partition cells and sublevels each live in their own package
+	return Level ? FName( *UWorld::RemovePIEPrefix( Level->GetOutermost( )->GetName( ) ) ) : NAME_None;
+}
+
+void USlashSaveSubsystem::WaitForLoad( )
+{
+	if ( !PendingLoad.IsValid( ) ) return;
+
+	const TArray<uint8>& Bytes = PendingLoad.Get( );
+	ParseSaveFile( Bytes );
+	PendingLoad.Reset( );
+}
+
+void USlashSaveSubsystem::ParseSaveFile( const TArray<uint8>& Bytes )
+{
+	if ( Bytes.Num( ) == 0 ) return;
+
+	FMemoryReader Reader( Bytes );
+	// bounds every string and chunk array read below to the size of the file
+	Reader.ArMaxSerializeSize = Bytes.Num( );
+	uint32 Magic = 0;
+	int32 Version = 0;
+	int32 NumChunks = 0;
+	Reader << Magic;
+	Reader << Version;
+	Reader << NumChunks;
+	if ( Reader.IsError( ) || Magic != SlashSave::Magic || Version < SlashSave::Initial || Version > SlashSave::Latest || NumChunks < 0 )
+	{
+		UE_LOG( LogTemp, Warning, TEXT( "Ignoring save %s: not a save file or written by a newer version (%d)" ), *GetSavePath( ), Version );
+		return;
+	}
+
+	for ( int32 Index = 0; Index < NumChunks && !Reader.IsError( ) && !Reader.AtEnd( ); ++Index )
+	{
+		FString ChunkName;
+		Reader << ChunkName;
+		TArray<uint8>& Blob = ChunkBlobs.Add( FName( *ChunkName ) );
+		Reader << Blob;
+	}
+	if ( Reader.IsError( ) )
+	{
+		UE_LOG( LogTemp, Warning, TEXT( "Save %s is truncated, keeping the chunks read so far" ), *GetSavePath( ) );
+	}
+
+	if ( const TArray<uint8>* PlayerBlob = ChunkBlobs.Find( SlashSave::PlayerChunk ) )
+	{
+		FMemoryReader PlayerReader( *PlayerBlob );
+		PlayerReader.ArMaxSerializeSize = PlayerBlob->Num( );
+		PlayerReader << PlayerData;
+		bHasPlayerData = !PlayerReader.IsError( );
+	}
+}
+
+void USlashSaveSubsystem::SaveGameAsync( )
+{
+	SLASH_SCOPE_CYCLE_COUNTER( STAT_SlashSaveSnapshot );
+	WaitForLoad( );
+	if ( IsSaving( ) )
+	{
+		UE_LOG( LogTemp, Warning, TEXT( "Previous save still writing, skipping this one" ) );
+		return;
+	}
+
+	const APlayerController* PlayerController = GetGameInstance( )->GetFirstLocalPlayerController( );
+	CapturePlayer( PlayerController ? Cast<ASlashCharacter>( PlayerController->GetPawn( ) ) : nullptr );
+
+	// enemies only record themselves when their cell unloads, so anything still loaded is captured as it is now
+	if ( const UWorld* World = GetGameInstance( )->GetWorld( ) )
+	{
+		if ( const UStreamingDormancySubsystem* Dormancy = World->GetSubsystem<UStreamingDormancySubsystem>( ) )
+		{
+			Dormancy->RecordLiveEnemies( *this );
+		}
+		if ( const UEnemyCrowdSubsystem* Crowd = World->GetSubsystem<UEnemyCrowdSubsystem>( ) )
+		{
+			Crowd->RecordProxies( *this );
+		}
+	}
+
+	// clean cells keep the encoding they were loaded or last saved with
+	for ( const FName& CellName : DirtyCells )
+	{
+		TArray<uint8>& Blob = ChunkBlobs.FindOrAdd( CellName );
+		Blob.Reset( );
+		FMemoryWriter Writer( Blob );
+		Writer << Cells.FindChecked( CellName );
+	}
+	DirtyCells.Reset( );
+
+	if ( bHasPlayerData )
+	{
+		TArray<uint8>& PlayerBlob = ChunkBlobs.FindOrAdd( SlashSave::PlayerChunk );
+		PlayerBlob.Reset( );
+		FMemoryWriter PlayerWriter( PlayerBlob );
+		PlayerWriter << PlayerData;
+	}
+
+	TArray<uint8> FileBytes;
+	FMemoryWriter Writer( FileBytes );
+	uint32 Magic = SlashSave::Magic;
+	int32 Version = SlashSave::Latest;
+	int32 NumChunks = ChunkBlobs.Num( );
+	Writer << Magic;
+	Writer << Version;
+	Writer << NumChunks;
+	for ( TPair<FName, TArray<uint8>>& Chunk : ChunkBlobs )
+	{
+		FString ChunkName = Chunk.Key.ToString( );
+		Writer << ChunkName;
+		Writer << Chunk.Value;
+	}
+
+	// written next to the old file and swapped in, so a crash mid-write never leaves a broken save
+	PendingWrite = Async( EAsyncExecution::ThreadPool, [Path = GetSavePath( ), Bytes = MoveTemp( FileBytes )]( )
+	{
+		const FString TempPath = Path + TEXT( ".tmp" );
+		return FFileHelper::SaveArrayToFile( Bytes, *TempPath ) && IFileManager::Get( ).Move( *Path, *TempPath, true );
+	} );
+}
+
+bool USlashSaveSubsystem::IsSaving( ) const
+{
+	return PendingWrite.IsValid( ) && !PendingWrite.IsReady( );
+}
+
+bool USlashSaveSubsystem::Tick( float DeltaTime )
+{
+	if ( PendingLoad.IsValid( ) && PendingLoad.IsReady( ) )
+	{
+		WaitForLoad( );
+	}
+
+	if ( AutosaveInterval > 0.f )
+	{
+		TimeSinceAutosave += DeltaTime;
+		if ( TimeSinceAutosave >= AutosaveInterval && !IsSaving( ) )
+		{
+			TimeSinceAutosave = 0.f;
+			SaveGameAsync( );
+		}
+	}
+	return true;
+}
+
+FString USlashSaveSubsystem::GetSavePath( ) const
+{
+	return FPaths::ProjectSavedDir( ) / TEXT( "SaveGames" ) / SlotName + TEXT( ".slashsave" );
+}
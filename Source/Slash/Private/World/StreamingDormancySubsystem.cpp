@@ -0,0 +1,172 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "World/StreamingDormancySubsystem.h"
+#include "Enemy/Enemy.h"
+#include "Breakables/BreakableActor.h"
+#include "World/SlashSaveSubsystem.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/World.h"
+#include "Slash/SlashStats.h"
+
+void UStreamingDormancySubsystem::RegisterEnemy( AEnemy* Enemy )
+{
+	if ( Enemy == nullptr ) return;
+	Enemies.AddUnique( Enemy );
+
+	GatherViewerLocations( );
+	const bool bRelevant = GetDistanceSquaredToNearestViewer( Enemy->GetActorLocation( ) ) <= FMath::Square( WakeRadius );
+	Enemy->SetDormant( !bRelevant );
+}
+
+void UStreamingDormancySubsystem::UnregisterEnemy( AEnemy* Enemy, const FEnemyCompactState& FinalState, EEndPlayReason::Type EndPlayReason )
+{
+	Enemies.RemoveSwap( Enemy );
+
+	// the cell is streaming out, or the enemy died for good; either way it must not come back as it was
+	const bool bKeepState = EndPlayReason == EEndPlayReason::RemovedFromWorld || FinalState.State == EEnemyState::EES_Dead;
+	USlashSaveSubsystem* Save = USlashSaveSubsystem::Get( this );
+	if ( bKeepState && Save )
+	{
+		Save->RecordEnemy( Enemy, FinalState );
+	}
+}
+
+void UStreamingDormancySubsystem::ReleaseEnemy( AEnemy* Enemy )
+{
+	Enemies.RemoveSwap( Enemy );
+}
+
+void UStreamingDormancySubsystem::RecordLiveEnemies( USlashSaveSubsystem& Save ) const
+{
+	// parked pool actors are released on demotion, so only enemies that are really in the world get here
+	FEnemyCompactState State;
+	for ( const TWeakObjectPtr<AEnemy>& Enemy : Enemies )
+	{
+		if ( Enemy.IsValid( ) && !Enemy->IsActorBeingDestroyed( ) )
+		{
+			Enemy->ExportCompactState( State );
+			Save.RecordEnemy( Enemy.Get( ), State );
+		}
+	}
+}
+
+void UStreamingDormancySubsystem::RegisterBreakable( ABreakableActor* Breakable )
+{
+	if ( Breakable == nullptr ) return;
+	Breakables.AddUnique( Breakable );
+
+	GatherViewerLocations( );
+	const bool bRelevant = GetDistanceSquaredToNearestViewer( Breakable->GetActorLocation( ) ) <= FMath::Square( WakeRadius );
+	Breakable->SetDormant( !bRelevant );
+}
+
+void UStreamingDormancySubsystem::UnregisterBreakable( ABreakableActor* Breakable )
+{
+	Breakables.RemoveSwap( Breakable );
+}
+
+FGuid UStreamingDormancySubsystem::GetPersistentId( const AActor* Actor )
+{
+	// a crowd proxy promoted back into a fresh actor keeps the id of the placed enemy it was demoted from
+	const AEnemy* Enemy = Cast<AEnemy>( Actor );
+	if ( Enemy && Enemy->GetInheritedPersistentId( ).IsValid( ) ) return Enemy->GetInheritedPersistentId( );
+
+	// only actors loaded with their level come back under the same name
+	if ( Actor == nullptr || !Actor->HasAnyFlags( RF_WasLoaded ) || Actor->GetWorld( ) == nullptr ) return FGuid( );
+
+	const FString MapName = UWorld::RemovePIEPrefix( Actor->GetWorld( )->GetMapName( ) );
+	return FGuid::NewDeterministicGuid( MapName + TEXT( "." ) + Actor->GetName( ) );
+}
+
+void UStreamingDormancySubsystem::Tick( float DeltaTime )
+{
+	SLASH_SCOPE_TRACE( STAT_SlashDormancyTick );
+	TimeSinceUpdate += DeltaTime;
+	if ( TimeSinceUpdate < UpdateInterval ) return;
+	TimeSinceUpdate = 0.f;
+
+	GatherViewerLocations( );
+	if ( ViewerLocations.Num( ) == 0 ) return;
+
+	const double WakeRadiusSquared = FMath::Square( WakeRadius );
+	const double SleepRadiusSquared = FMath::Square( SleepRadius );
+
+	for ( int32 Index = Enemies.Num( ) - 1; Index >= 0; --Index )
+	{
+		AEnemy* Enemy = Enemies[Index].Get( );
+		if ( Enemy == nullptr )
+		{
+			Enemies.RemoveAtSwap( Index );
+			continue;
+		}
+		const double DistanceSquared = GetDistanceSquaredToNearestViewer( Enemy->GetActorLocation( ) );
+		if ( Enemy->IsDormant( ) && DistanceSquared <= WakeRadiusSquared )
+		{
+			Enemy->SetDormant( false );
+		}
+		else if ( !Enemy->IsDormant( ) && DistanceSquared > SleepRadiusSquared && Enemy->CanSleep( ) )
+		{
+			Enemy->SetDormant( true );
+		}
+	}
+
+	for ( int32 Index = Breakables.Num( ) - 1; Index >= 0; --Index )
+	{
+		ABreakableActor* Breakable = Breakables[Index].Get( );
+		if ( Breakable == nullptr )
+		{
+			Breakables.RemoveAtSwap( Index );
+			continue;
+		}
+
+		const double DistanceSquared = GetDistanceSquaredToNearestViewer( Breakable->GetActorLocation( ) );
+		if ( Breakable->IsDormant( ) && DistanceSquared <= WakeRadiusSquared )
+		{
+			Breakable->SetDormant( false );
+		}
+		else if ( !Breakable->IsDormant( ) && DistanceSquared > SleepRadiusSquared )
+		{
+			Breakable->SetDormant( true );
+		}
+	}
+}
+
+TStatId UStreamingDormancySubsystem::GetStatId( ) const
+{
+	return GET_STATID( STAT_SlashDormancyTick );
+}
+
+void UStreamingDormancySubsystem::Deinitialize( )
+{
+	Enemies.Empty( );
+	Breakables.Empty( );
+
+	Super::Deinitialize( );
+}
+
+void UStreamingDormancySubsystem::GatherViewerLocations( )
+{
+	ViewerLocations.Reset( );
+	for ( FConstPlayerControllerIterator It = GetWorld( )->GetPlayerControllerIterator( ); It; ++It )
+	{
+		const APlayerController* PlayerController = It->Get( );
+		if ( PlayerController && PlayerController->GetPawn( ) )
+		{
+			ViewerLocations.Add( PlayerController->GetPawn( )->GetActorLocation( ) );
+		}
+	}
+}
+
+double UStreamingDormancySubsystem::GetDistanceSquaredToNearestViewer( const FVector& Location ) const
+{
+	// nobody to measure against yet (pawn not possessed), treat everything as relevant
+	if ( ViewerLocations.Num( ) == 0 ) return 0.0;
+
+	double Nearest = TNumericLimits<double>::Max( );
+	for ( const FVector& ViewerLocation : ViewerLocations )
+	{
+		Nearest = FMath::Min( Nearest, FVector::DistSquared( ViewerLocation, Location ) );
+	}
+	return Nearest;
+}
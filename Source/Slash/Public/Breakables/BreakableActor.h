@@ -5,12 +5,14 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "Interfaces/HitInterface.h"
+#include "Interfaces/CombatAssetInterface.h"
 #include "BreakableActor.generated.h"
 
 class UGeometryCollectionComponent;
+class UStreamingDormancySubsystem;
 
 UCLASS()
-class SLASH_API ABreakableActor : public AActor, public IHitInterface
+class SLASH_API ABreakableActor : public AActor, public IHitInterface, public ICombatAssetInterface
 {
 	GENERATED_BODY()
 	
@@ -22,10 +24,17 @@ public:
 
 	virtual void GetHit_Implementation( const FVector& ImpactPoint ) override;
 
+	void SetDormant( bool bDormant );
+
+	/** The treasure it can drop, so the pickup sound is resident before anything breaks */
+	virtual void GatherCombatAssets( TArray<FSoftObjectPath>& OutAssets ) const override;
+
 protected:
 
 	virtual void BeginPlay() override;
 
+	virtual void EndPlay( const EEndPlayReason::Type EndPlayReason ) override;
+
 	UPROPERTY( VisibleAnywhere, BlueprintReadWrite )
 	UGeometryCollectionComponent* GeometryCollection;
 
@@ -38,4 +47,14 @@ private:
 	TArray<TSubclassOf<class ATreasure>> TreasureClasses;
 
 	bool bBroken = false; 
+
+	bool bIsDormant = false;
+
+	UPROPERTY( )
+	UStreamingDormancySubsystem* Dormancy;
+
+public:
+
+	FORCEINLINE bool IsBroken( ) const { return bBroken; }
+	FORCEINLINE bool IsDormant( ) const { return bIsDormant; }
 };
@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
 #include "Interfaces/HitInterface.h"	
+#include "Interfaces/CombatAssetInterface.h"
 #include "BaseCharacter.generated.h"
 
 class AWeapon;
@@ -12,7 +13,7 @@ class UAttributeComponent;
 class UAnimMontage;
 
 UCLASS()
-class SLASH_API ABaseCharacter : public ACharacter, public IHitInterface
+class SLASH_API ABaseCharacter : public ACharacter, public IHitInterface, public ICombatAssetInterface
 {
 	GENERATED_BODY()
 
@@ -23,10 +24,25 @@ public:
 	UFUNCTION( BlueprintCallable )
 	void SetWeaponCollisionEnabled( ECollisionEnabled::Type CollisionEnabled );
 
+	virtual void GatherCombatAssets( TArray<FSoftObjectPath>& OutAssets ) const override;
+
+	virtual void GetLifetimeReplicatedProps( TArray<FLifetimeProperty>& OutLifetimeProps ) const override;
+
+	virtual bool IsInvulnerable( ) const override { return bInvulnerable; }
+
+	/** Driven by UInvulnerabilityNotifyState windows on montages */
+	void SetInvulnerable( bool bNewInvulnerable ) { bInvulnerable = bNewInvulnerable; }
+
 protected:
 
 	virtual void BeginPlay() override;
 
+	virtual void EndPlay( const EEndPlayReason::Type EndPlayReason ) override;
+
+	/** Hittable grid and foot IK; enemies parked in the crowd pool leave both without ending play */
+	void RegisterWithSubsystems( );
+	void UnregisterFromSubsystems( );
+
 	virtual void Attack( );
 
 	
@@ -34,7 +50,7 @@ protected:
 
 	virtual void PlayAttackMontage( );
 	void PlayHitReactMontage( const FName SectionName );
-	void DirectionalHitReact( const FVector& ImpactPoint );
+	void DirectionalHitReact( EHitDirection Direction );
 	void PlayHitSound( const FVector& ImpactPoint );
 	void SpawnJHitParticles( const FVector& ImpactPoint );
 	virtual void HandleDamage( float DamageAmount );
@@ -45,20 +61,24 @@ protected:
 	UFUNCTION( BlueprintCallable )
 	virtual void AttackEnd( );
 
-	UPROPERTY( VisibleAnywhere, Category = Weapon )
+	UPROPERTY( VisibleAnywhere, ReplicatedUsing = OnRep_EquippedWeapon, Category = Weapon )
 	AWeapon* EquippedWeapon;
 
+	/** The weapon actor's attachment replicates on its own; this switches it from pickup to held on this machine */
+	UFUNCTION( )
+	virtual void OnRep_EquippedWeapon( );
+
   /*
   *Animation Montages
   */
 	UPROPERTY( EditDefaultsOnly, Category = Montages )
-	 UAnimMontage* AttackMontage;
+	 TSoftObjectPtr<UAnimMontage> AttackMontage;
 
 	UPROPERTY( EditDefaultsOnly, Category = Montages )
-	UAnimMontage* HitReactMontage;
+	TSoftObjectPtr<UAnimMontage> HitReactMontage;
 
 	UPROPERTY( EditDefaultsOnly, Category = Montages )
-	UAnimMontage* DeathMontage;
+	TSoftObjectPtr<UAnimMontage> DeathMontage;
 
  /*
  * COMPONENTS
@@ -68,10 +88,25 @@ protected:
 
 private:
 
+	bool bInvulnerable = false;
+
 	UPROPERTY( EditAnywhere, Category = Sounds )
-	USoundBase* HitSound;
+	TSoftObjectPtr<USoundBase> HitSound;
 
 	UPROPERTY( EditAnywhere, Category = VisualEffects )
-	UParticleSystem* HitParticles;
-  
+	TSoftObjectPtr<UParticleSystem> HitParticles;
+
+	/** Ground probes for the foot IK control rig; off for characters whose anim blueprint doesn't use it */
+	UPROPERTY( EditDefaultsOnly, Category = FootIK )
+	bool bFootPlacement = true;
+
+	UPROPERTY( EditDefaultsOnly, Category = FootIK )
+	FName LeftFootSocket = TEXT( "foot_l" );
+
+	UPROPERTY( EditDefaultsOnly, Category = FootIK )
+	FName RightFootSocket = TEXT( "foot_r" );
+
+public:
+
+	FORCEINLINE AWeapon* GetEquippedWeapon( ) const { return EquippedWeapon; }
 };
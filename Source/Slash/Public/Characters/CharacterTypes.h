@@ -13,7 +13,8 @@ enum class EActionState : uint8
 {
 	EAS_Unoccupied UMETA(DisplayName = "Unoccupied" ),
 	EAS_Attacking UMETA(DisplayName = "Attacking" ),
-	EAS_EquippingWeapon UMETA( DisplayName = "EquippingWeapon" )
+	EAS_EquippingWeapon UMETA( DisplayName = "EquippingWeapon" ),
+	EAS_Dodge UMETA( DisplayName = "Dodge" )
 };
 
 UENUM( BlueprintType )
@@ -36,4 +37,13 @@ enum class EEnemyState : uint8
 	EES_Chasing UMETA( DisplayName = "Chasing" ),
 	EES_Attacking UMETA( DisplayName = "Attacking" ),
 	EES_Engaged UMETA( DisplayName = "Engaged" )
-};
\ No newline at end of file
+};
+
+UENUM( BlueprintType )
+enum class EHitDirection : uint8
+{
+	EHD_Front UMETA( DisplayName = "Front" ),
+	EHD_Left UMETA( DisplayName = "Left" ),
+	EHD_Right UMETA( DisplayName = "Right" ),
+	EHD_Back UMETA( DisplayName = "Back" )
+};
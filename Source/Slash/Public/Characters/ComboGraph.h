@@ -0,0 +1,46 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "ComboGraph.generated.h"
+
+USTRUCT( )
+struct FComboNode
+{
+	GENERATED_BODY()
+
+	/** Section of the character's attack montage */
+	UPROPERTY( EditDefaultsOnly )
+	FName Section;
+
+	/** Node an attack pressed inside this node's combo window chains into, -1 to end the combo here */
+	UPROPERTY( EditDefaultsOnly )
+	int32 NextOnAttack = INDEX_NONE;
+
+	/** Whether a dodge may cut this swing short inside its combo window */
+	UPROPERTY( EditDefaultsOnly )
+	bool bDodgeCancel = true;
+};
+
+/**
+ * Attack chains for a character: node 0 starts every combo, and each node names the node its follow-up attack
+ * leads to. The windows in which a follow-up or a dodge may cancel the swing are UComboWindowNotifyState on the montage.
+ */
+UCLASS( )
+class SLASH_API UComboGraph : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+
+	static constexpr int32 EntryNode = 0;
+
+	FORCEINLINE const FComboNode* GetNode( int32 Node ) const { return Nodes.IsValidIndex( Node ) ? &Nodes[Node] : nullptr; }
+
+private:
+
+	UPROPERTY( EditDefaultsOnly, Category = Combo )
+	TArray<FComboNode> Nodes;
+};
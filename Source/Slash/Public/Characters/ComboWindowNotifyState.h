@@ -0,0 +1,22 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Animation/AnimNotifies/AnimNotifyState.h"
+#include "ComboWindowNotifyState.generated.h"
+
+/**
+ * Cancel window on an attack montage: while it is open a buffered attack chains into the next combo node
+ * and a buffered dodge may cut the swing short.
+ */
+UCLASS( meta = (DisplayName = "Combo Window") )
+class SLASH_API UComboWindowNotifyState : public UAnimNotifyState
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void NotifyBegin( USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, float TotalDuration, const FAnimNotifyEventReference& EventReference ) override;
+	virtual void NotifyEnd( USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, const FAnimNotifyEventReference& EventReference ) override;
+};
@@ -0,0 +1,34 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Characters/CharacterTypes.h"
+
+/*
+* Which side of a character a hit came from, worked out with sign tests on the dot and cross products
+* of its forward vector and the direction to the impact. Same 90 degree quadrants as the old
+* acos based angle, without normalizing or any trig.
+*/
+namespace HitDirection
+{
+	inline EHitDirection Classify( const FVector& Forward, const FVector& Location, const FVector& ImpactPoint )
+	{
+		// impact lowered to the character's height, so only the horizontal direction counts
+		const double ToHitX = ImpactPoint.X - Location.X;
+		const double ToHitY = ImpactPoint.Y - Location.Y;
+		const double Dot = Forward.X * ToHitX + Forward.Y * ToHitY;
+		const double Cross = Forward.X * ToHitY - Forward.Y * ToHitX;
+
+		// |angle| < 45 exactly when cos > |sin|, and both carry the same |ToHit| scale
+		if ( Dot >= FMath::Abs( Cross ) ) return EHitDirection::EHD_Front;
+		if ( -Dot > FMath::Abs( Cross ) ) return EHitDirection::EHD_Back;
+		return Cross > 0.0 ? EHitDirection::EHD_Right : EHitDirection::EHD_Left;
+	}
+
+	/** Batched version for AoE and cleave hits; large batches are split across worker threads */
+	SLASH_API void Classify( TConstArrayView<FVector> Forwards, TConstArrayView<FVector> Locations, TConstArrayView<FVector> ImpactPoints, TArrayView<EHitDirection> OutDirections );
+
+	/** Hit react montage section for Direction, resolved once rather than built from a string per hit */
+	SLASH_API const FName& GetSectionName( EHitDirection Direction );
+}
@@ -0,0 +1,22 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Animation/AnimNotifies/AnimNotifyState.h"
+#include "InvulnerabilityNotifyState.generated.h"
+
+/**
+ * I-frames: the owning character ignores hits between this window's begin and end.
+ * Placed on the dodge montage so the invulnerable frames line up with the animation.
+ */
+UCLASS( meta = (DisplayName = "Invulnerable") )
+class SLASH_API UInvulnerabilityNotifyState : public UAnimNotifyState
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void NotifyBegin( USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, float TotalDuration, const FAnimNotifyEventReference& EventReference ) override;
+	virtual void NotifyEnd( USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, const FAnimNotifyEventReference& EventReference ) override;
+};
@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "Animation/AnimInstance.h"
 #include "CharacterTypes.h"
+#include "World/FootPlacementSubsystem.h"
 #include "SlashAnimInstance.generated.h"
 
 /**
@@ -33,4 +34,19 @@ public:
 
 	UPROPERTY( BlueprintReadOnly, Category = "Movement | Character State" )
 	ECharacterState CharacterState;
+
+	/*
+	* Foot IK: copied from the foot placement cache on the game thread, read by the thread safe graph and CR_PlayerFootIK
+	*/
+
+	UPROPERTY( BlueprintReadOnly, Category = FootIK )
+	FSlashFootGround LeftFootGround;
+
+	UPROPERTY( BlueprintReadOnly, Category = FootIK )
+	FSlashFootGround RightFootGround;
+
+private:
+
+	UPROPERTY( )
+	UFootPlacementSubsystem* FootPlacement;
 };
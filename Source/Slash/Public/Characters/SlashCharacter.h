@@ -6,14 +6,21 @@
 #include "BaseCharacter.h" 
 #include "InputActionValue.h"
 #include "CharacterTypes.h"
+#include "SlashInputBuffer.h"
 #include "SlashCharacter.generated.h"
 
 class UInputMappingContext;
 class UInputAction;
 class USpringArmComponent;
 class UCameraComponent;
+class ULockOnComponent;
+class UCameraOcclusionComponent;
 class AItem;
+class AWeapon;
+class USlashReplaySubsystem;
+enum class ESlashInputAction : uint8;
 class UAnimMontage;
+class UComboGraph;
 
 UCLASS()
 class SLASH_API ASlashCharacter : public ABaseCharacter
@@ -37,18 +44,47 @@ public:
 
 	void EKeyPressed( );
 
-	
+	void EquipWeapon( AWeapon* Weapon );
+
+	/** Attacks now if possible; pressed while busy it is buffered and chains into the combo inside the next combo window */
+	virtual void Attack( ) override;
+
+	/** Dodges now if possible; pressed while busy it is buffered and starts on the first frame it is allowed */
+	void Dodge( );
+
+	/** Driven by UComboWindowNotifyState on the attack montage */
+	void SetComboWindowOpen( bool bOpen );
+
+	/** Re-runs a recorded input through the same handler the live binding uses */
+	void ReplayInput( ESlashInputAction Action, const FVector2D& Value );
+
+	/** Client side of a hit found by this character's own weapon; the server decides whether it counts */
+	void RequestHit( AActor* HitActor, const FVector& ImpactPoint );
+
+	virtual void GatherCombatAssets( TArray<FSoftObjectPath>& OutAssets ) const override;
+
+	virtual void GetLifetimeReplicatedProps( TArray<FLifetimeProperty>& OutLifetimeProps ) const override;
 
 protected:
 
 	virtual void BeginPlay() override;
 
+	virtual void EndPlay( const EEndPlayReason::Type EndPlayReason ) override;
+
+	virtual void PossessedBy( AController* NewController ) override;
+
 	UPROPERTY( VisibleAnywhere )
 	USpringArmComponent* CameraBoom;
 
 	UPROPERTY( VisibleAnywhere )
 	UCameraComponent* ViewCamera;
 
+	UPROPERTY( VisibleAnywhere )
+	ULockOnComponent* LockOn;
+
+	UPROPERTY( VisibleAnywhere )
+	UCameraOcclusionComponent* CameraOcclusion;
+
 	/**
 	 * Callback for Input
 	 */
@@ -74,21 +110,30 @@ protected:
 	UPROPERTY( EditAnywhere, Category = Input )
 	TObjectPtr<UInputAction> DodgeAction;
 
+	UPROPERTY( EditAnywhere, Category = Input )
+	TObjectPtr<UInputAction> LockOnAction;
+
+	/** 1D axis: positive switches to the target on the right, negative to the left */
+	UPROPERTY( EditAnywhere, Category = Input )
+	TObjectPtr<UInputAction> SwitchTargetAction;
+
 	void Move( const FInputActionValue& Value );
 	void Look( const FInputActionValue& Value );
-
-	virtual void Attack( ) override;
+	void ToggleLockOn( );
+	void SwitchLockOnTarget( const FInputActionValue& Value );
 
 	/*
 	* Play Montage Functions
 	*/
 	 
 	virtual void PlayAttackMontage( ) override;
+	void PlayAttackSection( FName SectionName );
 
 	virtual void AttackEnd( ) override ;
 	virtual bool CanAttack( ) override; 
 
 	void PlayEqipMontage(const FName SectionName);
+	void BeginEquip( FName SectionName, ECharacterState NewState );
 	bool CanDisarm();
 	bool CanArm( );
 
@@ -100,11 +145,39 @@ protected:
 
 	UFUNCTION( BlueprintCallable )
 	void FinishEquipping( );
+
+	virtual void OnRep_EquippedWeapon( ) override;
+
+	/** bRequireWindow is off on the server, whose copy of the combo window may trail the client's by a frame */
+	bool CanDodge( bool bRequireWindow = true ) const;
+	bool CanCancelIntoDodge( bool bRequireWindow ) const;
+	void BeginDodge( );
+	void StartDodge( const FRotator& Facing );
+	void PlayDodgeMontage( );
+	void OnDodgeMontageEnded( UAnimMontage* Montage, bool bInterrupted );
+
+	/** Back to Unoccupied, then starts whatever input is still buffered */
+	void EndAction( );
+
+	/** Starts a buffered dodge or attack if the current state allows it; called whenever the state may have freed up */
+	void ConsumeBufferedInput( );
+
+	/* Combo */
+	int32 GetNextComboNode( bool bRequireWindow );
+	void BeginAttack( int32 Node, FName SectionName );
+	FName PickRandomAttackSection( );
 	 
 private:
 
+	UPROPERTY( ReplicatedUsing = OnRep_CharacterState )
 	ECharacterState CharacterState = ECharacterState::ECS_Unequipped;
 
+	UFUNCTION( )
+	void OnRep_CharacterState( );
+
+	/** Where the weapon sits for the current CharacterState */
+	FName GetWeaponSocket( ) const;
+
 	UPROPERTY(BlueprintReadWrite, meta = (AllowPrivateAccess = "true") )
 	EActionState ActionState = EActionState::EAS_Unoccupied;
 
@@ -116,10 +189,79 @@ private:
 
 
 	UPROPERTY( EditDefaultsOnly, Category = Montages )
-	UAnimMontage* EquipMontage; // Arm and Disarm
+	TSoftObjectPtr<UAnimMontage> EquipMontage; // Arm and Disarm
+
+	/** Root motion roll; carries the Invulnerable notify window */
+	UPROPERTY( EditDefaultsOnly, Category = Montages )
+	TSoftObjectPtr<UAnimMontage> DodgeMontage;
+
+	/** Attack chains and their dodge cancels; without one every swing is a random Attack1 or Attack2 */
+	UPROPERTY( EditDefaultsOnly, Category = Combat )
+	UComboGraph* ComboGraph;
+
+	int32 ComboNode = INDEX_NONE;
+	bool bComboWindowOpen = false;
+
+	/** How long an attack or dodge pressed during another action stays buffered */
+	UPROPERTY( EditAnywhere, Category = Combat )
+	float InputBufferTime = 0.4f;
+
+	FSlashInputBuffer InputBuffer;
+
+	UPROPERTY( )
+	USlashReplaySubsystem* Replay;
+
+	bool AcceptInput( ESlashInputAction Action, const FVector2D& Value = FVector2D::ZeroVector );
+
+	/** Health and weapon from the save, applied once when the local player takes control; the weapon follows once its class streams in */
+	void RestoreSavedState( );
+	void EquipSavedWeapon( FSoftObjectPath WeaponPath );
+
+	/** Montages are streamed in after BeginPlay; nothing starts an action before they are resident, but presses stay buffered */
+	void OnCombatAssetsLoaded( );
+	bool bCombatAssetsLoaded = false;
+
+	/*
+	* Networking
+	*/
+
+	FName AttackSection;
+
+	/** How far from the attacker a rewound target may be for a client's hit to be accepted */
+	UPROPERTY( EditAnywhere, Category = Combat )
+	float MaxHitDistance = 400.f;
+
+	UFUNCTION( Server, Reliable )
+	void ServerAttack( FName SectionName );
+
+	UFUNCTION( Server, Reliable )
+	void ServerEKeyPressed( );
+
+	UFUNCTION( Server, Reliable )
+	void ServerDodge( FRotator Facing );
+
+	UFUNCTION( NetMulticast, Unreliable )
+	void MulticastDodge( FRotator Facing );
+
+	/** ViewTime is the server time of what the attacker saw when it swung, see ULagCompensationSubsystem::GetClientViewTime */
+	UFUNCTION( Server, Reliable )
+	void ServerRequestHit( AActor* HitActor, FVector_NetQuantize ImpactPoint, double ViewTime );
+
+	UFUNCTION( NetMulticast, Unreliable )
+	void MulticastPlayAttackSection( FName SectionName );
+
+	UFUNCTION( NetMulticast, Unreliable )
+	void MulticastPlayEquipMontage( FName SectionName );
+
+	/** The server turned down an action the owner already started; sends back what the server has instead */
+	void RejectAction( );
+
+	UFUNCTION( Client, Reliable )
+	void ClientRejectAction( EActionState ServerActionState, ECharacterState ServerCharacterState, float ServerStamina );
 
 public:
 
 	FORCEINLINE void SetOverlappingItem( AItem* Item ) { OverlappingItem = Item; }
 	FORCEINLINE ECharacterState GetCharacterState( ) const { return CharacterState; }
+	FORCEINLINE EActionState GetActionState( ) const { return ActionState; }
 };
@@ -0,0 +1,50 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+enum class ESlashBufferedAction : uint8
+{
+	ESBA_Attack,
+	ESBA_Dodge,
+
+	ESBA_MAX
+};
+
+/*
+* Last press time per action. Fixed size, so pressing, checking and consuming never allocate;
+* a press counts for Window seconds of game time, whatever the frame rate.
+*/
+struct FSlashInputBuffer
+{
+	void Press( ESlashBufferedAction Action, double Time )
+	{
+		PressTimes[static_cast<uint8>( Action )] = Time;
+	}
+
+	bool IsBuffered( ESlashBufferedAction Action, double Now, float Window ) const
+	{
+		const double PressTime = PressTimes[static_cast<uint8>( Action )];
+		return PressTime >= 0.0 && Now - PressTime <= Window;
+	}
+
+	/** Whether any action is still inside its window */
+	bool HasAny( double Now, float Window ) const
+	{
+		for ( const double PressTime : PressTimes )
+		{
+			if ( PressTime >= 0.0 && Now - PressTime <= Window ) return true;
+		}
+		return false;
+	}
+
+	void Consume( ESlashBufferedAction Action )
+	{
+		PressTimes[static_cast<uint8>( Action )] = -1.0;
+	}
+
+private:
+
+	double PressTimes[static_cast<uint8>( ESlashBufferedAction::ESBA_MAX )] = { -1.0, -1.0 };
+};
@@ -0,0 +1,85 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "SlashBenchmarkCommandlet.generated.h"
+
+class ASlashCharacter;
+
+/**
+ * Headless combat stress run:
+ * UnrealEditor-Cmd Slash.uproject -run=SlashBenchmark -nullrhi -Enemies=64 -Breakables=32 -Treasures=64 -Frames=3600 -Label=MyChange
+ *
+ * Spawns enemies, breakables and treasure around an auto-attacking SlashCharacter, ticks the world at a fixed timestep
+ * and appends one summary row to Saved/Profiling/SlashBenchmark.csv. Per-stat game thread timings go to a CSV profiler capture.
+ */
+UCLASS( Config = Game )
+class SLASH_API USlashBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	USlashBenchmarkCommandlet( );
+
+	virtual int32 Main( const FString& Params ) override;
+
+private:
+
+	UWorld* LoadBenchmarkWorld( const FString& MapName );
+	void DestroyBenchmarkWorld( UWorld* World );
+
+	ASlashCharacter* SpawnPlayer( UWorld* World );
+	void SpawnActorsAround( UWorld* World, const FVector& Center, UClass* ActorClass, int32 Count, double MinRadius, double MaxRadius, TArray<AActor*>& OutActors );
+	void DriveCharacter( ASlashCharacter* Character, const TArray<AActor*>& Enemies );
+
+	void WriteSummary( const FString& Label, const TArray<double>& FrameTimes, double GCSeconds, int32 GCCount ) const;
+
+	UPROPERTY( Config )
+	FString MapName = TEXT( "/Game/Maps/TestMap" );
+
+	UPROPERTY( Config )
+	FSoftClassPath CharacterClass;
+
+	UPROPERTY( Config )
+	FSoftClassPath PlayerWeaponClass;
+
+	UPROPERTY( Config )
+	FSoftClassPath EnemyClass;
+
+	UPROPERTY( Config )
+	FSoftClassPath BreakableClass;
+
+	UPROPERTY( Config )
+	FSoftClassPath TreasureClass;
+
+	UPROPERTY( Config )
+	int32 NumEnemies = 64;
+
+	UPROPERTY( Config )
+	int32 NumBreakables = 32;
+
+	UPROPERTY( Config )
+	int32 NumTreasures = 64;
+
+	UPROPERTY( Config )
+	int32 WarmupFrames = 120;
+
+	UPROPERTY( Config )
+	int32 NumFrames = 3600;
+
+	UPROPERTY( Config )
+	float FixedDeltaTime = 1.f / 60.f;
+
+	/** Frames between forced garbage collections, roughly the engine's default interval at 60 fps */
+	UPROPERTY( Config )
+	int32 GCIntervalFrames = 3600;
+
+	UPROPERTY( Config )
+	double SpawnRadius = 2500.0;
+
+	UPROPERTY( Config )
+	uint32 RandomSeed = 1337;
+};
@@ -6,6 +6,7 @@
 #include "Components/ActorComponent.h"
 #include "AttributeComponent.generated.h"
 
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam( FOnAttributeChanged, float, NewValue );
 
 UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
 class SLASH_API UAttributeComponent : public UActorComponent
@@ -18,22 +19,61 @@ public:
 
 	virtual void TickComponent( float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction ) override;
 
+	virtual void GetLifetimeReplicatedProps( TArray<FLifetimeProperty>& OutLifetimeProps ) const override;
+
+	/** On the server when health changes, on clients when the new value arrives */
+	UPROPERTY( BlueprintAssignable )
+	FOnAttributeChanged OnHealthChanged;
+
+	UPROPERTY( BlueprintAssignable )
+	FOnAttributeChanged OnStaminaChanged;
+
 protected:
 
 	virtual void BeginPlay() override;
 
 private:
 
-	UPROPERTY(EditAnywhere, Category = ActorAttributes )
+	UPROPERTY( EditAnywhere, ReplicatedUsing = OnRep_Health, Category = ActorAttributes )
 	float Health;
 
 	UPROPERTY( EditAnywhere, Category = ActorAttributes )
 	float MaxHealth;
 
+	/** Only the owner needs it, to decide whether it can dodge */
+	UPROPERTY( EditAnywhere, ReplicatedUsing = OnRep_Stamina, Category = ActorAttributes )
+	float Stamina = 100.f;
+
+	UPROPERTY( EditAnywhere, Category = ActorAttributes )
+	float MaxStamina = 100.f;
+
+	/** Per second */
+	UPROPERTY( EditAnywhere, Category = ActorAttributes )
+	float StaminaRegenRate = 8.f;
+
+	UPROPERTY( EditAnywhere, Category = ActorAttributes )
+	float DodgeCost = 14.f;
+
+	UFUNCTION( )
+	void OnRep_Health( );
+
+	UFUNCTION( )
+	void OnRep_Stamina( );
+
 public:
 
 	void ReceiveDamage( float Damage );
 	float GetHealthPercent( );
 	bool IsAlive( );
+
+	FORCEINLINE float GetHealth( ) const { return Health; }
+	void SetHealth( float NewHealth );
+
+	void UseStamina( float StaminaCost );
+	void SetStamina( float NewStamina );
+	float GetStaminaPercent( ) const;
+
+	FORCEINLINE float GetStamina( ) const { return Stamina; }
+	FORCEINLINE float GetDodgeCost( ) const { return DodgeCost; }
 		
 };
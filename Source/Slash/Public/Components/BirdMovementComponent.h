@@ -0,0 +1,72 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/PawnMovementComponent.h"
+#include "BirdMovementComponent.generated.h"
+
+/**
+ * Flight for ABird without physics simulation. Input along the nose is thrust, the heading eases toward the
+ * control rotation, and the bird banks into turns. Airspeed under thrust and quadratic drag, the sink rate
+ * below stall speed and the bank are all integrated in closed form, so the flight is the same at any frame rate.
+ * Collision is one sweep per step: speed into a blocking surface is lost instead of sliding along it.
+ */
+UCLASS( ClassGroup = Movement, meta = (BlueprintSpawnableComponent) )
+class SLASH_API UBirdMovementComponent : public UPawnMovementComponent
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void TickComponent( float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction ) override;
+
+	virtual float GetMaxSpeed( ) const override;
+
+private:
+
+	/** Exact airspeed after DeltaTime of dv/dt = Acceleration - DragCoefficient * v^2 */
+	float IntegrateAirspeed( float Speed, float Acceleration, float DeltaTime ) const;
+
+	float Airspeed = 0.f;
+	float ClimbRate = 0.f;
+	float Bank = 0.f;
+
+	/** Acceleration along the nose at full input, cm/s^2 */
+	UPROPERTY( EditAnywhere, Category = Flight )
+	float MaxThrust = 1200.f;
+
+	/** Quadratic drag, per cm; top speed in level flight is sqrt( MaxThrust / DragCoefficient ) */
+	UPROPERTY( EditAnywhere, Category = Flight )
+	float DragCoefficient = 0.002f;
+
+	/** Lift per (cm/s)^2 of airspeed; below sqrt( gravity / LiftCoefficient ) the bird starts to sink */
+	UPROPERTY( EditAnywhere, Category = Flight )
+	float LiftCoefficient = 0.0016f;
+
+	/** How quickly the sink rate settles, per second */
+	UPROPERTY( EditAnywhere, Category = Flight )
+	float VerticalDamping = 2.f;
+
+	/** How quickly the heading follows the control rotation, per second */
+	UPROPERTY( EditAnywhere, Category = Flight )
+	float TurnResponse = 4.f;
+
+	UPROPERTY( EditAnywhere, Category = Flight )
+	float MaxPitch = 60.f;
+
+	/** Degrees of bank per degree per second of turn */
+	UPROPERTY( EditAnywhere, Category = Flight )
+	float BankPerYawRate = 0.4f;
+
+	UPROPERTY( EditAnywhere, Category = Flight )
+	float MaxBank = 50.f;
+
+	UPROPERTY( EditAnywhere, Category = Flight )
+	float BankResponse = 5.f;
+
+public:
+
+	FORCEINLINE float GetAirspeed( ) const { return Airspeed; }
+	FORCEINLINE float GetBank( ) const { return Bank; }
+};
@@ -0,0 +1,89 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "WorldCollision.h"
+#include "UObject/ObjectKey.h"
+#include "Containers/SlashKeyIndex.h"
+#include "CameraOcclusionComponent.generated.h"
+
+class UMaterialParameterCollection;
+class UPrimitiveComponent;
+class UCameraComponent;
+
+/**
+ * Fades whatever stands between the locally controlled player's camera and the character.
+ * Only meshes that opt in by overlapping the CameraFade trace channel can fade; everything else ignores it by default.
+ * An async multi trace per frame finds the occluders, and each one's fade amount is written to its
+ * custom primitive data, so no dynamic material is created and mesh draw batching is kept. The camera
+ * and character locations go to one material parameter collection that every fading material reads,
+ * which makes the per-frame cost the same however many meshes are fading.
+ */
+UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
+class SLASH_API UCameraOcclusionComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+
+	UCameraOcclusionComponent( );
+
+	virtual void TickComponent( float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction ) override;
+
+protected:
+
+	virtual void BeginPlay( ) override;
+
+	virtual void EndPlay( const EEndPlayReason::Type EndPlayReason ) override;
+
+private:
+
+	struct FFadingPrimitive
+	{
+		TWeakObjectPtr<UPrimitiveComponent> Primitive;
+		float Fade = 0.f;
+		bool bOccluding = false;
+	};
+
+	void ReadOcclusion( );
+	void UpdateFades( float DeltaTime );
+	void IssueOcclusion( const FVector& CameraLocation, const FVector& TargetLocation );
+	void RemoveAtSwap( int32 Index );
+
+	UPROPERTY( )
+	UCameraComponent* Camera;
+
+	FTraceHandle OcclusionTrace;
+
+	/* the owner's weapon and anything else attached to it; kept so the per-frame gather reuses its allocation */
+	TArray<AActor*> AttachedActors;
+
+	TArray<FFadingPrimitive> Fading;
+	TSlashKeyIndex<TObjectKey<UPrimitiveComponent>> FadingIndices;
+
+	UPROPERTY( EditAnywhere, Category = Occlusion )
+	UMaterialParameterCollection* OcclusionCollection;
+
+	UPROPERTY( EditAnywhere, Category = Occlusion )
+	FName CameraLocationParameter = TEXT( "OcclusionCamera" );
+
+	UPROPERTY( EditAnywhere, Category = Occlusion )
+	FName TargetLocationParameter = TEXT( "OcclusionTarget" );
+
+	/** Custom primitive data slot the fading materials read their fade amount from */
+	UPROPERTY( EditAnywhere, Category = Occlusion )
+	int32 FadeDataIndex = 0;
+
+	/** Fade amount per second, in and out */
+	UPROPERTY( EditAnywhere, Category = Occlusion )
+	float FadeSpeed = 6.f;
+
+	UPROPERTY( EditAnywhere, Category = Occlusion )
+	float TraceRadius = 20.f;
+
+	/** CameraFade in DefaultEngine.ini; fadeable meshes set their response to it to Overlap */
+	UPROPERTY( EditAnywhere, Category = Occlusion )
+	TEnumAsByte<ECollisionChannel> OcclusionChannel = ECollisionChannel::ECC_GameTraceChannel1;
+};
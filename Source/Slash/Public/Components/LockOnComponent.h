@@ -0,0 +1,129 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "WorldCollision.h"
+#include "UObject/ObjectKey.h"
+#include "Containers/SlashKeyIndex.h"
+#include "LockOnComponent.generated.h"
+
+class UAreaDamageSubsystem;
+
+/**
+ * Lock-on for the locally controlled player. Candidates are pulled from the hittable actor grid on a cadence
+ * and merged into the existing set, line of sight is refreshed with async traces, and the visible candidates
+ * are kept sorted by their angle from the camera so switching left or right is a binary search.
+ * While locked the control rotation, and with it the camera boom, eases toward the target.
+ */
+UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
+class SLASH_API ULockOnComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:	
+
+	ULockOnComponent();
+
+	virtual void TickComponent( float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction ) override;
+
+	/** Locks onto the best scored candidate, or releases the current lock */
+	void ToggleLock( );
+
+	/** Next visible candidate to the right (Direction > 0) or left of the current target */
+	void SwitchTarget( float Direction );
+
+protected:
+
+	virtual void BeginPlay() override;
+
+private:
+
+	struct FLockOnCandidate
+	{
+		TWeakObjectPtr<AActor> Actor;
+		FTraceHandle SightTrace;
+		float Angle = 0.f;		// signed yaw from the camera's forward, degrees
+		float Score = 0.f;		// lower is better
+		bool bVisible = false;
+		bool bInRange = false;
+	};
+
+	void RefreshCandidates( );
+	void ResolveSightTraces( );
+	void IssueSightTraces( );
+	void ScoreCandidates( );
+	void FollowTarget( float DeltaTime );
+	void ReleaseLock( );
+
+	bool IsValidTarget( const AActor* Actor ) const;
+	bool HasLineOfSight( const FVector& ViewLocation, const AActor* Actor ) const;
+	bool GetViewPoint( FVector& OutLocation, FRotator& OutRotation ) const;
+
+	FLockOnCandidate* FindCandidate( const AActor* Actor );
+	void AddCandidate( AActor* Actor );
+	void RemoveCandidateAt( int32 Index );
+	void ResetCandidates( );
+
+	UPROPERTY( )
+	UAreaDamageSubsystem* TargetIndex;
+
+	TArray<FLockOnCandidate> Candidates;
+
+	/* actor to slot in Candidates, swap-removed alongside it */
+	TSlashKeyIndex<TObjectKey<AActor>> CandidateIndices;
+
+	/* slots of Candidates in the order ToggleLock tries them, so sorting doesn't move the candidates under the index */
+	TArray<int32> PickOrder;
+
+	struct FSortedTarget
+	{
+		float Angle = 0.f;
+		TWeakObjectPtr<AActor> Actor;
+	};
+
+	/* visible candidates by ascending Angle, rebuilt when they are scored */
+	TArray<FSortedTarget> SortedTargets;
+
+	TArray<AActor*> GatheredTargets;
+
+	TWeakObjectPtr<AActor> LockedTarget;
+
+	float TimeSinceRefresh = 0.f;
+	float TimeSinceSightCheck = 0.f;
+	float TimeOutOfSight = 0.f;
+
+	UPROPERTY( EditAnywhere, Category = LockOn )
+	float LockOnRadius = 2000.f;
+
+	UPROPERTY( EditAnywhere, Category = LockOn )
+	float RefreshInterval = 0.25f;
+
+	UPROPERTY( EditAnywhere, Category = LockOn )
+	float SightCheckInterval = 0.1f;
+
+	/** Only candidates within this angle of the camera's forward can be picked */
+	UPROPERTY( EditAnywhere, Category = LockOn )
+	float MaxScreenAngle = 60.f;
+
+	/** How much being off center counts against distance when picking a target */
+	UPROPERTY( EditAnywhere, Category = LockOn )
+	float AngleWeight = 2.f;
+
+	/** The lock breaks once the target has been hidden this long */
+	UPROPERTY( EditAnywhere, Category = LockOn )
+	float LoseSightTime = 1.5f;
+
+	UPROPERTY( EditAnywhere, Category = LockOn )
+	float CameraInterpSpeed = 8.f;
+
+	/** Pitch applied on top of the look-at rotation, so the player stays in frame */
+	UPROPERTY( EditAnywhere, Category = LockOn )
+	float CameraPitchOffset = -15.f;
+
+public:
+
+	FORCEINLINE bool IsLocked( ) const { return LockedTarget.IsValid( ); }
+	FORCEINLINE AActor* GetLockedTarget( ) const { return LockedTarget.Get( ); }
+};
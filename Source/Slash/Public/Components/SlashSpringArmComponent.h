@@ -0,0 +1,58 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/SpringArmComponent.h"
+#include "WorldCollision.h"
+#include "SlashSpringArmComponent.generated.h"
+
+/**
+ * Spring arm whose collision probe is an async sweep instead of a blocking one. Each frame reads the sweep
+ * issued the frame before, which was cast from where the pivot and the view were predicted to be, and eases
+ * the arm toward that length: in quickly so nothing clips, out slowly so thin props don't make it pop.
+ */
+UCLASS( ClassGroup = Camera, meta = (BlueprintSpawnableComponent) )
+class SLASH_API USlashSpringArmComponent : public USpringArmComponent
+{
+	GENERATED_BODY()
+
+public:
+
+	USlashSpringArmComponent( );
+
+protected:
+
+	virtual void UpdateDesiredArmLocation( bool bDoTrace, bool bDoLocationLag, bool bDoRotationLag, float DeltaTime ) override;
+
+private:
+
+	void ReadProbe( );
+	void IssueProbe( float DeltaTime );
+
+	FTraceHandle Probe;
+
+	/** Length the last probe allowed, negative when it hit nothing */
+	float BlockedArmLength = -1.f;
+
+	/** Length actually used this frame */
+	float CurrentArmLength = -1.f;
+
+	FRotator LastProbeRotation = FRotator::ZeroRotator;
+
+	/* where the pending probe started and which way the arm pointed, back toward the camera */
+	FVector ProbeOrigin = FVector::ZeroVector;
+	FVector ProbeDirection = FVector::BackwardVector;
+
+	/** How far the socket offset alone moved the probe's end along ProbeDirection */
+	float ProbeOffsetDepth = 0.f;
+
+	UPROPERTY( EditAnywhere, Category = CameraCollision )
+	float PullInSpeed = 20.f;
+
+	UPROPERTY( EditAnywhere, Category = CameraCollision )
+	float LetOutSpeed = 4.f;
+
+	UPROPERTY( EditAnywhere, Category = CameraCollision )
+	float MinArmLength = 30.f;
+};
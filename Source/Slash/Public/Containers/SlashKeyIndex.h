@@ -0,0 +1,61 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/*
+* Key to slot lookup kept beside one or more packed arrays that are removed from with swaps.
+* The owner adds a key whenever it appends an element, and calls RemoveAtSwap with the same index
+* when it swap-removes its own arrays, which re-points the key of the element moved into the hole.
+* Keys are usually TObjectKeys, which can still be removed after their object is gone.
+*/
+template <typename KeyType>
+class TSlashKeyIndex
+{
+public:
+
+	/** Key goes at the end, where the owner is appending its element */
+	int32 Add( const KeyType& Key )
+	{
+		const int32 Index = Keys.Add( Key );
+		Indices.Add( Key, Index );
+		return Index;
+	}
+
+	int32 Find( const KeyType& Key ) const
+	{
+		const int32* Index = Indices.Find( Key );
+		return Index ? *Index : INDEX_NONE;
+	}
+
+	bool Contains( const KeyType& Key ) const
+	{
+		return Indices.Contains( Key );
+	}
+
+	void RemoveAtSwap( int32 Index )
+	{
+		Indices.Remove( Keys[Index] );
+		const int32 LastIndex = Keys.Num( ) - 1;
+		if ( Index != LastIndex )
+		{
+			Indices[Keys[LastIndex]] = Index;
+		}
+		Keys.RemoveAtSwap( Index, 1, false );
+	}
+
+	void Reset( )
+	{
+		Keys.Reset( );
+		Indices.Reset( );
+	}
+
+	FORCEINLINE const KeyType& GetKey( int32 Index ) const { return Keys[Index]; }
+	FORCEINLINE int32 Num( ) const { return Keys.Num( ); }
+
+private:
+
+	TArray<KeyType> Keys;
+	TMap<KeyType, int32> Indices;
+};
@@ -3,13 +3,29 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Misc/Optional.h"
 #include "Characters/BaseCharacter.h"
 #include "Interfaces/HitInterface.h"
 #include "Characters/CharacterTypes.h"
+#include "Enemy/EnemyNetState.h"
+#include "Enemy/EnemyCompactState.h"
 #include "Enemy.generated.h"
 
 class UHealthBarComponent;
 class UPawnSensingComponent;
+class UEngagementSubsystem;
+class UEnemyCrowdSubsystem;
+class UStreamingDormancySubsystem;
+class UWeaponSpawnSubsystem;
+class ULagCompensationSubsystem;
+class UEnemyArchetype;
+class UEnemyTuningSubsystem;
+struct FEnemyTuning;
+class UStaticMesh;
+class UStaticMeshComponent;
+class UAnimMontage;
+enum class EEnemyEvent : uint8;
+enum class EEnemyAction : uint8;
  
 UCLASS()
 class SLASH_API AEnemy : public ABaseCharacter
@@ -26,11 +42,40 @@ public:
 
 	void CheckCombatTarget( );
 
+	/** Feeds an event through the enemy transition table */
+	void DispatchEnemyEvent( EEnemyEvent Event );
+
 	virtual void GetHit_Implementation( const FVector& ImpactPoint ) override;
 
+	virtual void PlayHitEffects( const FVector& ImpactPoint, EHitDirection Direction ) override;
+
+	virtual void PlayHitAudio( const FVector& ImpactPoint ) override;
+
 	virtual float TakeDamage( float DamageAmount, struct FDamageEvent const& DamageEvent, class AController* EventInstigator, AActor* DamageCauser ) override;
 
-	virtual void Destroyed( ) override;
+	virtual void GatherCombatAssets( TArray<FSoftObjectPath>& OutAssets ) const override;
+
+	virtual void GetLifetimeReplicatedProps( TArray<FLifetimeProperty>& OutLifetimeProps ) const override;
+
+	/** Called by the weapon spawner once the deferred default weapon is attached */
+	void OnDefaultWeaponReady( class AWeapon* Weapon );
+
+	/* Crowd proxies */
+	void ExportCompactState( FEnemyCompactState& OutState ) const;
+	bool CanBecomeProxy( ) const;
+
+	/** Before BeginPlay: the actor stands in for a promoted crowd proxy and resumes from its state */
+	void PrepareRespawn( const FEnemyCompactState& CompactState, const FGuid& PersistentId );
+
+	/** Parks the actor in the crowd's pool: out of every subsystem, weapon released, hidden and not ticking */
+	void Deactivate( );
+
+	/** Takes a pooled actor back out for a promoted crowd proxy, as if it had been spawned for it */
+	void Reactivate( const FEnemyCompactState& CompactState, const FGuid& PersistentId, const TArray<AActor*>& NewPatrolTargets );
+
+	/* Streaming dormancy */
+	void SetDormant( bool bDormant );
+	bool CanSleep( ) const;
 
 private:
 
@@ -46,11 +91,14 @@ private:
 	UPROPERTY()
 	AActor* CombatTarget;
 
-	UPROPERTY(EditAnywhere )
-	double CombatRadius = 750.f;
+	/** Radii, speeds and timings; baked into the tuning table and read back by row. Soft, so the archetype asset itself never loads at runtime */
+	UPROPERTY( EditDefaultsOnly, Category = Archetype )
+	TSoftObjectPtr<UEnemyArchetype> Archetype;
 
-	UPROPERTY( EditAnywhere )
-	double AttackRadius = 150.f;
+	UPROPERTY( )
+	UEnemyTuningSubsystem* Tuning;
+
+	uint16 TuningRow = MAX_uint16;
 
 	/*
 	* Navigation
@@ -66,72 +114,144 @@ private:
 	UPROPERTY( EditInstanceOnly, Category = AINavigation )
 	TArray<AActor*> PatrolTargets;
 
-	UPROPERTY( EditAnywhere )
-	double PatrolRadius = 200.f;
+	/** How far the ring position may drift before a waiting enemy re-paths */
+	UPROPERTY( EditAnywhere, Category = AINavigation )
+	double RingRepathDistance = 100.f;
+
+	FVector RingGoal;
 
-	FTimerHandle PatrolTimer;
+	/* AI waits count down in Tick rather than on the world timer manager, so hitstop and other dilation stretch them; negative when idle */
+	float PatrolTimeRemaining = -1.f;
+	float AttackTimeRemaining = -1.f;
+	void TickTimers( float DeltaTime );
 	void PatrolTimerFinished( );
 	
-	UPROPERTY(EditAnywhere, Category = AINavigation )
-	float WaitMin = 5.f;
-	UPROPERTY( EditAnywhere, Category = AINavigation )
-	float WaitMax = 10.f;
-	UPROPERTY( EditAnywhere, Category = AINavigation )
-	float WalkSpeed = 150.f;
-	UPROPERTY( EditAnywhere, Category = AINavigation )
-	float RunSpeed = 300.f;
-	
 	/**AI Behavior*/
 	void HideHealthBar();
 	void ShowHealthBar( );
 	void LoseInterest( );
-	void StartPatrolling( );
 	void ChaseTarget( );
+	void HoldRingPosition( );
 
+	/* State machine hooks */
+	void EnterState( EEnemyState State );
+	void ExitState( EEnemyState State );
+	void RunEnemyAction( EEnemyAction Action );
+	EEnemyEvent SenseCombatEvent( );
 
-	bool IsOutsideCombatRadius( );
-	bool IsOutsideAttackRadius( );
-	bool IsInsideAttackRadius( );
+	double GetDistanceSquaredToTarget( AActor* Target ) const;
 	bool IsChasing( );
-	bool IsAttacking( );
 	bool IsDead( );
-	bool IsEngaged( );
+	bool HasAttackSlot( ) const;
+	bool CanApproachTarget( ) const;
+
+	/** Only called once the target is inside the attack radius */
+	bool TryAcquireAttackSlot( );
+	bool IsWaitingOnRing( );
 
 	void ClearPatrolTimer( );
 
 	/* Combat */
 	void StartAttackTimer( );
 	void ClearAttackTimer( );
+	void AttackTimerFinished( );
+
+	void OnAttackMontageEnded( UAnimMontage* Montage, bool bInterrupted );
+
+	UPROPERTY( )
+	UEngagementSubsystem* Engagement;
+
+	/** Instanced or vertex-animated stand-in drawn while the enemy is a distant crowd proxy */
+	UPROPERTY( EditDefaultsOnly, Category = Crowd )
+	UStaticMesh* ProxyMesh;
+
+	UPROPERTY( )
+	UEnemyCrowdSubsystem* Crowd;
 
-	FTimerHandle AttackTimer;
+	UPROPERTY( )
+	UStreamingDormancySubsystem* Dormancy;
 
-	UPROPERTY(EditAnywhere, Category = Combat )
-	float AttackMin = 0.5f;
-	UPROPERTY( EditAnywhere, Category = Combat )
-	float AttackMax = 1.f;
+	UPROPERTY( )
+	UWeaponSpawnSubsystem* WeaponSpawner;
 
-	UPROPERTY(EditAnywhere, Category = Combat )
-	float PatrollingSpeed = 125.f;
-	UPROPERTY( EditAnywhere, Category = Combat )
-	float chaseSpeed = 300.f;
+	/** Static mesh stand-in carried until the real weapon actor is needed */
+	UPROPERTY( )
+	UStaticMeshComponent* LightweightWeapon;
+
+	bool bIsDormant = false;
+	bool bIsPooled = false;
+
+	TOptional<FEnemyCompactState> RespawnState;
+
+	/** Save id of the placed enemy this actor was respawned for */
+	FGuid InheritedPersistentId;
+
+	/** BeginPlay work deferred until the enemy first becomes relevant */
+	bool bInitialized = false;
+
+	UPROPERTY( EditAnywhere, Category = Crowd )
+	float DormantAnimTickInterval = 1.f;
+
+	/*
+	* Networking
+	*/
+
+	UPROPERTY( ReplicatedUsing = OnRep_NetState )
+	FEnemyNetState NetState;
+
+	UFUNCTION( )
+	void OnRep_NetState( );
+
+	/** Server only: repacks NetState and marks it for push replication when it changed */
+	void UpdateNetState( );
+
+	UFUNCTION( NetMulticast, Unreliable )
+	void MulticastHitEffects( const FVector_NetQuantize& ImpactPoint, EHitDirection Direction, bool bAlive );
+
+	UFUNCTION( NetMulticast, Unreliable )
+	void MulticastHitAudio( const FVector_NetQuantize& ImpactPoint );
+
+	UPROPERTY( EditDefaultsOnly, Category = Network )
+	float PatrolNetUpdateFrequency = 5.f;
+
+	UPROPERTY( EditDefaultsOnly, Category = Network )
+	float CombatNetUpdateFrequency = 30.f;
+
+	UPROPERTY( )
+	ULagCompensationSubsystem* LagCompensation;
+
+	void InitializeEnemy( );
+
+	/** Crowd, lag compensation and dormancy; dormancy wakes or initializes the enemy from there */
+	void RegisterWithEnemySubsystems( );
+	void SpawnDefaultWeapon( );
+	void ReleaseDefaultWeapon( );
+	void ApplyCompactState( const FEnemyCompactState& CompactState );
+	void RefreshSimulation( );
 
 protected:
 
 	virtual void BeginPlay() override;
+
+	virtual void EndPlay( const EEndPlayReason::Type EndPlayReason ) override;
 	 
 	virtual void Die( ) override;
+
+	void PlayDeathMontage( );
 	
-	bool InTargetRange( AActor* Target, double Radius );
+	bool InTargetRange( AActor* Target, double RadiusSquared );
 
 	void MoveToTarget( AActor* Target );
 
+	void MoveToLocation( const FVector& Location );
+
 	AActor* ChoosePatrolTarget( );
 
 	virtual void Attack( ) override;
 
 	virtual void PlayAttackMontage( ) override;
 
-	virtual bool CanAttack( ) override; 
+	virtual void AttackEnd( ) override;
 
 	virtual void HandleDamage( float DamageAmount ) override ;
 
@@ -146,6 +266,13 @@ protected:
 
 public:	
 
-	
-
+	FORCEINLINE EEnemyState GetEnemyState( ) const { return EnemyState; }
+	FORCEINLINE const FEnemyNetState& GetNetState( ) const { return NetState; }
+	FORCEINLINE bool IsDormant( ) const { return bIsDormant; }
+	FORCEINLINE bool IsPooled( ) const { return bIsPooled; }
+	FORCEINLINE const FGuid& GetInheritedPersistentId( ) const { return InheritedPersistentId; }
+	FORCEINLINE UStaticMesh* GetProxyMesh( ) const { return ProxyMesh; }
+	FORCEINLINE const TArray<AActor*>& GetPatrolTargets( ) const { return PatrolTargets; }
+	FORCEINLINE void SetPatrolTargets( const TArray<AActor*>& NewPatrolTargets ) { PatrolTargets = NewPatrolTargets; }
+	const FEnemyTuning& GetTuning( ) const;
 };
@@ -0,0 +1,36 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AIController.h"
+#include "EnemyAIController.generated.h"
+
+/**
+ * AI controller for enemies that swaps the default path following for detour crowd
+ * following, so enemies converging on the same target steer around each other
+ */
+UCLASS()
+class SLASH_API AEnemyAIController : public AAIController
+{
+	GENERATED_BODY()
+
+public:
+
+	AEnemyAIController( const FObjectInitializer& ObjectInitializer );
+
+protected:
+
+	virtual void BeginPlay( ) override;
+
+private:
+
+	UPROPERTY( EditDefaultsOnly, Category = Crowd )
+	bool bEnableSeparation = true;
+
+	UPROPERTY( EditDefaultsOnly, Category = Crowd )
+	float SeparationWeight = 2.f;
+
+	UPROPERTY( EditDefaultsOnly, Category = Crowd )
+	float CollisionQueryRange = 600.f;
+};
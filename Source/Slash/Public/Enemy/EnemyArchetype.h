@@ -0,0 +1,89 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "EnemyArchetype.generated.h"
+
+/*
+* One row of the baked tuning table: what an enemy reads at runtime, with derived values precomputed
+*/
+USTRUCT( )
+struct FEnemyTuning
+{
+	GENERATED_BODY()
+
+	UPROPERTY( VisibleAnywhere )
+	float CombatRadiusSquared = 750.f * 750.f;
+
+	UPROPERTY( VisibleAnywhere )
+	float AttackRadiusSquared = 150.f * 150.f;
+
+	UPROPERTY( VisibleAnywhere )
+	float PatrolRadius = 200.f;
+
+	UPROPERTY( VisibleAnywhere )
+	float PatrolRadiusSquared = 200.f * 200.f;
+
+	UPROPERTY( VisibleAnywhere )
+	float WaitMin = 5.f;
+
+	UPROPERTY( VisibleAnywhere )
+	float WaitMax = 10.f;
+
+	UPROPERTY( VisibleAnywhere )
+	float AttackMin = 0.5f;
+
+	UPROPERTY( VisibleAnywhere )
+	float AttackMax = 1.f;
+
+	UPROPERTY( VisibleAnywhere )
+	float PatrollingSpeed = 125.f;
+
+	UPROPERTY( VisibleAnywhere )
+	float ChaseSpeed = 300.f;
+};
+
+/**
+ * Designer-facing tuning for one kind of enemy. Only used in the editor:
+ * UEnemyTuningTable bakes every archetype into a packed row when it is saved or cooked.
+ */
+UCLASS( )
+class SLASH_API UEnemyArchetype : public UPrimaryDataAsset
+{
+	GENERATED_BODY()
+
+public:
+
+	FEnemyTuning Bake( ) const;
+
+private:
+
+	UPROPERTY( EditDefaultsOnly, Category = Combat )
+	float CombatRadius = 750.f;
+
+	UPROPERTY( EditDefaultsOnly, Category = Combat )
+	float AttackRadius = 150.f;
+
+	UPROPERTY( EditDefaultsOnly, Category = Combat )
+	float AttackMin = 0.5f;
+
+	UPROPERTY( EditDefaultsOnly, Category = Combat )
+	float AttackMax = 1.f;
+
+	UPROPERTY( EditDefaultsOnly, Category = Combat )
+	float ChaseSpeed = 300.f;
+
+	UPROPERTY( EditDefaultsOnly, Category = AINavigation )
+	float PatrolRadius = 200.f;
+
+	UPROPERTY( EditDefaultsOnly, Category = AINavigation )
+	float WaitMin = 5.f;
+
+	UPROPERTY( EditDefaultsOnly, Category = AINavigation )
+	float WaitMax = 10.f;
+
+	UPROPERTY( EditDefaultsOnly, Category = AINavigation )
+	float PatrollingSpeed = 125.f;
+};
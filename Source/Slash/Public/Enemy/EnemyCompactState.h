@@ -0,0 +1,29 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Characters/CharacterTypes.h"
+
+/*
+* Everything an enemy needs to resume where it left off, without the actor.
+* Written by AEnemy::ExportCompactState, and read back in BeginPlay from the save or a promoted crowd proxy.
+*/
+struct FEnemyCompactState
+{
+	FVector Location = FVector::ZeroVector;
+	float Yaw = 0.f;
+	int32 PatrolIndex = INDEX_NONE;
+	EEnemyState State = EEnemyState::EES_Patrolling;
+	float Health = 0.f;
+
+	friend FArchive& operator<<( FArchive& Ar, FEnemyCompactState& CompactState )
+	{
+		Ar << CompactState.Location;
+		Ar << CompactState.Yaw;
+		Ar << CompactState.PatrolIndex;
+		Ar << CompactState.State;
+		Ar << CompactState.Health;
+		return Ar;
+	}
+};
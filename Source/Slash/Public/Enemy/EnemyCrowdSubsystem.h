@@ -0,0 +1,137 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "EnemyCompactState.h"
+#include "EnemyNetState.h"
+#include "World/SlashInstancedBatches.h"
+#include "UObject/ObjectKey.h"
+#include "EnemyCrowdSubsystem.generated.h"
+
+class AEnemy;
+class AEnemyRoster;
+class ULevel;
+class USlashSaveSubsystem;
+
+/**
+ * Keeps distant enemies as packed proxies instead of full AEnemy actors.
+ * Demoting an enemy keeps only its compact state; the actor releases its weapon and is parked in a small
+ * per-class pool, or destroyed once the pool is full. Proxies walk their patrol routes on the navmesh in one
+ * loop and render through one instanced mesh per enemy class. Inside PromotionRadius of a player the proxy
+ * takes a parked actor of its class and cell back out, and only spawns a new one when there is none.
+ */
+UCLASS( Config = Game )
+class SLASH_API UEnemyCrowdSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	void RegisterEnemy( AEnemy* Enemy );
+	void UnregisterEnemy( AEnemy* Enemy );
+
+	/** Mirrors an enemy's net state into the always-relevant roster; does nothing outside networked games */
+	void UpdateRoster( AEnemy* Enemy, const FEnemyNetState& State );
+
+	int32 GetNumProxies( ) const { return Proxies.Num( ); }
+
+	/** Hands the current state of every proxy of a placed enemy to the save */
+	void RecordProxies( USlashSaveSubsystem& Save ) const;
+
+	virtual void Initialize( FSubsystemCollectionBase& Collection ) override;
+	virtual void Tick( float DeltaTime ) override;
+	virtual TStatId GetStatId( ) const override;
+	virtual void Deinitialize( ) override;
+
+private:
+
+	/* structure of arrays, one entry per proxy, removed with swaps; the batch of each lives in Instances */
+	struct FEnemyProxies
+	{
+		TArray<FEnemyCompactState> States;
+		TArray<uint16> Routes;
+
+		/** Save id and level of the placed enemy, so the respawned actor and the save still know it */
+		TArray<FGuid> PersistentIds;
+		TArray<TWeakObjectPtr<ULevel>> Levels;
+
+		int32 Num( ) const { return States.Num( ); }
+		void RemoveAtSwap( int32 Index );
+	};
+
+	struct FEnemyProxyBatch
+	{
+		TSubclassOf<AEnemy> EnemyClass;
+		FTransform MeshOffset;
+		float Speed = 0.f;
+		double AcceptanceRadius = 0.0;
+		float HalfHeight = 0.f;
+	};
+
+	void GatherViewerLocations( );
+	bool IsNearViewer( const FVector& Location, double Radius ) const;
+
+	void DemoteDistantEnemies( );
+	void PromoteNearbyProxies( );
+	void AdvanceProxies( float DeltaTime );
+	void ProjectProxiesToNavigation( );
+	void UpdateInstances( );
+
+	void Demote( AEnemy* Enemy );
+	void Promote( int32 ProxyIndex );
+	void RemoveProxy( int32 ProxyIndex );
+	bool FindGround( const FVector& Location, float HalfHeight, FVector& OutLocation ) const;
+	FTransform GetProxyTransform( int32 ProxyIndex ) const;
+
+	/** Proxies of a streamed out cell leave their state with the save, as their actors would have */
+	void OnLevelRemoved( ULevel* Level, UWorld* World );
+
+	/** A parked actor of Class in Level, taken out of the pool; null when there is none to reuse */
+	AEnemy* TakePooledEnemy( UClass* Class, const ULevel* Level );
+
+	int32 FindOrAddBatch( AEnemy* Enemy );
+	int32 AddRoute( const TArray<AActor*>& PatrolTargets );
+
+	FEnemyProxies Proxies;
+	TArray<FEnemyProxyBatch> ProxyBatches;
+	FSlashInstancedBatches Instances;
+	TArray<TArray<TWeakObjectPtr<AActor>>> Routes;
+	TArray<TWeakObjectPtr<AEnemy>> LiveEnemies;
+	TArray<FVector> ViewerLocations;
+
+	/* deactivated actors by class; an actor can't change level, so reuse also has to match the proxy's cell */
+	TMap<TObjectKey<UClass>, TArray<TWeakObjectPtr<AEnemy>>> EnemyPool;
+
+	UPROPERTY( )
+	AEnemyRoster* Roster;
+
+	FDelegateHandle LevelRemovedHandle;
+
+	float TimeSinceUpdate = 0.f;
+
+	UPROPERTY( Config )
+	bool bEnableProxies = true;
+
+	UPROPERTY( Config )
+	double PromotionRadius = 5000.0;
+
+	/** Larger than PromotionRadius so enemies near the edge don't flip back and forth */
+	UPROPERTY( Config )
+	double DemotionRadius = 6000.0;
+
+	UPROPERTY( Config )
+	float UpdateInterval = 0.25f;
+
+	UPROPERTY( Config )
+	int32 MaxPromotionsPerFrame = 4;
+
+	/** Parked actors kept per enemy class for promotions to reuse; demotions past this destroy the actor */
+	UPROPERTY( Config )
+	int32 MaxPooledPerClass = 16;
+
+	/** How far from a proxy the navmesh and the ground are looked for */
+	UPROPERTY( Config )
+	FVector NavProjectionExtent = FVector( 200.0, 200.0, 500.0 );
+};
@@ -0,0 +1,57 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Characters/CharacterTypes.h"
+#include "EnemyNetState.generated.h"
+
+/**
+ * What clients need to present an enemy's combat state: state, death pose and health, packed into 14 bits
+ */
+USTRUCT( )
+struct FEnemyNetState
+{
+	GENERATED_BODY()
+
+	EEnemyState State = EEnemyState::EES_Patrolling;
+	EDeathPose DeathPose = EDeathPose::EDP_Death1;
+
+	/** Health percent quantized to 0..255 */
+	uint8 Health = 255;
+
+	FORCEINLINE float GetHealthPercent( ) const { return Health / 255.f; }
+	FORCEINLINE void SetHealthPercent( float Percent ) { Health = static_cast<uint8>( FMath::RoundToInt( FMath::Clamp( Percent, 0.f, 1.f ) * 255.f ) ); }
+
+	bool NetSerialize( FArchive& Ar, UPackageMap* Map, bool& bOutSuccess )
+	{
+		uint32 StateValue = static_cast<uint32>( State );
+		uint32 PoseValue = static_cast<uint32>( DeathPose );
+		Ar.SerializeInt( StateValue, 8 );
+		Ar.SerializeInt( PoseValue, 8 );
+		Ar << Health;
+
+		if ( Ar.IsLoading( ) )
+		{
+			State = static_cast<EEnemyState>( FMath::Min<uint32>( StateValue, static_cast<uint32>( EEnemyState::EES_Engaged ) ) );
+			DeathPose = static_cast<EDeathPose>( FMath::Min<uint32>( PoseValue, static_cast<uint32>( EDeathPose::EDP_Death6 ) ) );
+		}
+		bOutSuccess = true;
+		return true;
+	}
+
+	bool operator==( const FEnemyNetState& Other ) const
+	{
+		return State == Other.State && DeathPose == Other.DeathPose && Health == Other.Health;
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FEnemyNetState> : public TStructOpsTypeTraitsBase2<FEnemyNetState>
+{
+	enum
+	{
+		WithNetSerializer = true,
+		WithIdenticalViaEquality = true
+	};
+};
@@ -0,0 +1,86 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Info.h"
+#include "Net/Serialization/FastArraySerializer.h"
+#include "Enemy/EnemyNetState.h"
+#include "Containers/SlashKeyIndex.h"
+#include "UObject/ObjectKey.h"
+#include "EnemyRoster.generated.h"
+
+class AEnemy;
+
+USTRUCT( )
+struct FEnemyRosterEntry : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+	/** Null on clients the enemy isn't currently relevant to */
+	UPROPERTY( )
+	AEnemy* Enemy = nullptr;
+
+	UPROPERTY( )
+	FVector_NetQuantize Location;
+
+	UPROPERTY( )
+	FEnemyNetState State;
+};
+
+USTRUCT( )
+struct FEnemyRosterArray : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	UPROPERTY( )
+	TArray<FEnemyRosterEntry> Entries;
+
+	bool NetDeltaSerialize( FNetDeltaSerializeInfo& DeltaParms )
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FEnemyRosterEntry, FEnemyRosterArray>( Entries, DeltaParms, *this );
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FEnemyRosterArray> : public TStructOpsTypeTraitsBase2<FEnemyRosterArray>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true
+	};
+};
+
+/**
+ * Server-owned list of every active enemy with its last combat state.
+ * Always relevant and sent as deltas, so clients know about enemies outside their relevancy range without the full actors.
+ */
+UCLASS( )
+class SLASH_API AEnemyRoster : public AInfo
+{
+	GENERATED_BODY()
+
+public:
+
+	AEnemyRoster( );
+
+	void AddEnemy( AEnemy* Enemy, const FEnemyNetState& State );
+	void UpdateEnemy( AEnemy* Enemy, const FEnemyNetState& State );
+	void RemoveEnemy( AEnemy* Enemy );
+
+	virtual void GetLifetimeReplicatedProps( TArray<FLifetimeProperty>& OutLifetimeProps ) const override;
+
+private:
+
+	void MarkRosterDirty( );
+
+	UPROPERTY( Replicated )
+	FEnemyRosterArray Roster;
+
+	/* server only, one key per entry of Roster.Entries */
+	TSlashKeyIndex<TObjectKey<AEnemy>> EntryIndices;
+
+public:
+
+	FORCEINLINE const TArray<FEnemyRosterEntry>& GetEntries( ) const { return Roster.Entries; }
+};
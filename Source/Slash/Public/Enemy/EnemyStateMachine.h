@@ -0,0 +1,157 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Characters/CharacterTypes.h"
+
+/*
+* Things that can happen to an enemy. Fed into the transition table together with the current EEnemyState.
+*/
+enum class EEnemyEvent : uint8
+{
+	EEE_PawnSeen,
+	EEE_Damaged,
+	EEE_TargetLost,			// target left the combat radius
+	EEE_TargetOutOfReach,	// target inside combat radius, but no attack possible yet
+	EEE_TargetInReach,		// inside attack radius and holding an attack slot
+	EEE_AttackStarted,
+	EEE_AttackEnded,
+	EEE_Died,
+
+	EEE_MAX
+};
+
+/*
+* What the enemy does in response to a transition, on top of the enter/exit hooks of the states involved
+*/
+enum class EEnemyAction : uint8
+{
+	EEA_None,
+	EEA_Chase,
+	EEA_LoseInterest,
+	EEA_Attack,
+	EEA_Die
+};
+
+struct FEnemyTransition
+{
+	EEnemyState NextState;
+	EEnemyAction Action;
+};
+
+struct FEnemyTransitionRecord
+{
+	double Time = 0.0;
+	uint32 EnemyId = 0;
+	EEnemyState FromState = EEnemyState::EES_Dead;
+	EEnemyState ToState = EEnemyState::EES_Dead;
+	EEnemyEvent Event = EEnemyEvent::EEE_MAX;
+	EEnemyAction Action = EEnemyAction::EEA_None;
+};
+
+namespace EnemyStateMachine
+{
+	inline constexpr int32 NumStates = static_cast<int32>( EEnemyState::EES_Engaged ) + 1;
+	inline constexpr int32 NumEvents = static_cast<int32>( EEnemyEvent::EEE_MAX );
+
+	constexpr FEnemyTransition To( EEnemyState NextState, EEnemyAction Action = EEnemyAction::EEA_None )
+	{
+		return FEnemyTransition{ NextState, Action };
+	}
+
+	using S = EEnemyState;
+	using A = EEnemyAction;
+
+	/*
+	* Rows follow EEnemyState, columns follow EEnemyEvent.
+	* A cell that points back at its own row with EEA_None is ignored.
+	*/
+	inline constexpr FEnemyTransition TransitionTable[NumStates][NumEvents] =
+	{
+		// EES_Dead
+		{
+			/* PawnSeen */          To( S::EES_Dead ),
+			/* Damaged */           To( S::EES_Dead ),
+			/* TargetLost */        To( S::EES_Dead ),
+			/* TargetOutOfReach */  To( S::EES_Dead ),
+			/* TargetInReach */     To( S::EES_Dead ),
+			/* AttackStarted */     To( S::EES_Dead ),
+			/* AttackEnded */       To( S::EES_Dead ),
+			/* Died */              To( S::EES_Dead )
+		},
+		// EES_Patrolling
+		{
+			/* PawnSeen */          To( S::EES_Chasing, A::EEA_Chase ),
+			/* Damaged */           To( S::EES_Chasing, A::EEA_Chase ),
+			/* TargetLost */        To( S::EES_Patrolling ),
+			/* TargetOutOfReach */  To( S::EES_Patrolling ),
+			/* TargetInReach */     To( S::EES_Patrolling ),
+			/* AttackStarted */     To( S::EES_Patrolling ),
+			/* AttackEnded */       To( S::EES_Patrolling ),
+			/* Died */              To( S::EES_Dead, A::EEA_Die )
+		},
+		// EES_Chasing
+		{
+			/* PawnSeen */          To( S::EES_Chasing ),
+			/* Damaged */           To( S::EES_Chasing, A::EEA_Chase ),
+			/* TargetLost */        To( S::EES_Patrolling, A::EEA_LoseInterest ),
+			/* TargetOutOfReach */  To( S::EES_Chasing ),
+			/* TargetInReach */     To( S::EES_Attacking ),
+			/* AttackStarted */     To( S::EES_Chasing ),
+			/* AttackEnded */       To( S::EES_Chasing ),
+			/* Died */              To( S::EES_Dead, A::EEA_Die )
+		},
+		// EES_Attacking
+		{
+			/* PawnSeen */          To( S::EES_Attacking ),
+			/* Damaged */           To( S::EES_Attacking ),
+			/* TargetLost */        To( S::EES_Patrolling, A::EEA_LoseInterest ),
+			/* TargetOutOfReach */  To( S::EES_Chasing, A::EEA_Chase ),
+			/* TargetInReach */     To( S::EES_Attacking ),
+			/* AttackStarted */     To( S::EES_Engaged, A::EEA_Attack ),
+			/* AttackEnded */       To( S::EES_Attacking ),
+			/* Died */              To( S::EES_Dead, A::EEA_Die )
+		},
+		// EES_Engaged
+		{
+			/* PawnSeen */          To( S::EES_Engaged ),
+			/* Damaged */           To( S::EES_Engaged ),
+			/* TargetLost */        To( S::EES_Engaged ),	// picked up again from Chasing once the swing ends
+			/* TargetOutOfReach */  To( S::EES_Engaged ),
+			/* TargetInReach */     To( S::EES_Engaged ),
+			/* AttackStarted */     To( S::EES_Engaged ),
+			/* AttackEnded */       To( S::EES_Chasing, A::EEA_Chase ),
+			/* Died */              To( S::EES_Dead, A::EEA_Die )
+		}
+	};
+
+	/** States that run CheckCombatTarget instead of CheckPatrolTarget */
+	inline constexpr bool CombatStates[NumStates] = { false, false, true, true, true };
+
+	constexpr const FEnemyTransition& GetTransition( EEnemyState State, EEnemyEvent Event )
+	{
+		return TransitionTable[static_cast<int32>( State )][static_cast<int32>( Event )];
+	}
+
+	constexpr bool IsInCombat( EEnemyState State )
+	{
+		return CombatStates[static_cast<int32>( State )];
+	}
+
+	static_assert( GetTransition( S::EES_Patrolling, EEnemyEvent::EEE_PawnSeen ).NextState == S::EES_Chasing, "Patrolling enemies chase what they see" );
+	static_assert( GetTransition( S::EES_Dead, EEnemyEvent::EEE_Damaged ).Action == A::EEA_None, "Dead enemies never react" );
+	static_assert( !IsInCombat( S::EES_Patrolling ) && IsInCombat( S::EES_Engaged ), "Combat states out of sync with EEnemyState" );
+	static_assert( GetTransition( S::EES_Engaged, EEnemyEvent::EEE_TargetLost ).Action == A::EEA_None, "Losing the target mid-swing would leave AttackEnded chasing nothing" );
+
+	/** Appends a transition to the trace ring buffer, when Slash.Enemy.TraceTransitions is on */
+	void RecordTransition( const FEnemyTransitionRecord& Record );
+
+	bool IsTracingTransitions( );
+
+	/** Copies the buffered transitions out in chronological order */
+	void GetRecordedTransitions( TArray<FEnemyTransitionRecord>& OutRecords );
+
+	/** Drops everything buffered so far, e.g. so a test only sees its own enemies */
+	void ResetRecordedTransitions( );
+}
@@ -0,0 +1,45 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Enemy/EnemyArchetype.h"
+#include "Enemy/EnemyTuningTable.h"
+#include "EnemyTuningSubsystem.generated.h"
+
+/**
+ * Loads the project's enemy tuning table once per game or PIE world. Enemies keep a row index into it
+ * instead of their own copies of every tuning value, and rows are read straight out of the table.
+ */
+UCLASS( Config = Game )
+class SLASH_API UEnemyTuningSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual bool DoesSupportWorldType( const EWorldType::Type WorldType ) const override;
+	virtual void Initialize( FSubsystemCollectionBase& Collection ) override;
+
+	static constexpr uint16 DefaultRow = MAX_uint16;
+
+	/** DefaultRow if the archetype isn't in the table */
+	uint16 FindRow( const FSoftObjectPath& ArchetypePath ) const;
+
+	FORCEINLINE const FEnemyTuning& GetRow( uint16 Row ) const
+	{
+		return Table && Table->GetRows( ).IsValidIndex( Row ) ? Table->GetRows( )[Row] : DefaultTuning;
+	}
+
+private:
+
+	UPROPERTY( )
+	UEnemyTuningTable* Table;
+
+	/** Used for enemies without an archetype, matches the old per-instance defaults */
+	FEnemyTuning DefaultTuning;
+
+	UPROPERTY( Config )
+	FSoftObjectPath TablePath;
+};
@@ -0,0 +1,45 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "Enemy/EnemyArchetype.h"
+#include "EnemyTuningTable.generated.h"
+
+/**
+ * Every enemy archetype packed into one array. Rows are rebuilt from the archetype assets
+ * whenever the table is saved or cooked, so cooked builds only load this one asset.
+ */
+UCLASS( )
+class SLASH_API UEnemyTuningTable : public UPrimaryDataAsset
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Looked up by path, so the archetype doesn't have to be loaded */
+	int32 FindRow( const FSoftObjectPath& ArchetypePath ) const;
+
+	FORCEINLINE const TArray<FEnemyTuning>& GetRows( ) const { return Rows; }
+
+#if WITH_EDITOR
+	void Bake( );
+
+	virtual void PreSave( FObjectPreSaveContext ObjectSaveContext ) override;
+#endif
+
+private:
+
+#if WITH_EDITORONLY_DATA
+	UPROPERTY( EditAnywhere, Category = Tuning )
+	TArray<TSoftObjectPtr<UEnemyArchetype>> Archetypes;
+#endif
+
+	/* parallel arrays, one entry per row */
+	UPROPERTY( VisibleAnywhere, Category = Tuning )
+	TArray<FSoftObjectPath> RowArchetypes;
+
+	UPROPERTY( VisibleAnywhere, Category = Tuning )
+	TArray<FEnemyTuning> Rows;
+};
@@ -0,0 +1,63 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "EngagementSubsystem.generated.h"
+
+class AEnemy;
+
+/**
+ * Hands out a limited number of attack slots around each combat target.
+ * Enemies without a slot are parked on rings around the target until one frees up.
+ */
+UCLASS( Config = Game )
+class SLASH_API UEngagementSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	bool TryAcquireAttackSlot( AEnemy* Enemy, AActor* Target );
+	bool HasAttackSlot( const AEnemy* Enemy, AActor* Target ) const;
+	bool HasFreeAttackSlot( AActor* Target ) const;
+	void ReleaseEnemy( AEnemy* Enemy );
+
+	/** Where an enemy without an attack slot should wait around Target */
+	FVector GetRingLocation( AEnemy* Enemy, AActor* Target );
+
+	virtual void Deinitialize( ) override;
+
+private:
+
+	struct FWaitingEnemy
+	{
+		TWeakObjectPtr<AEnemy> Enemy;
+		int32 RingSlot = 0;
+	};
+
+	struct FEngagement
+	{
+		TArray<TWeakObjectPtr<AEnemy>, TInlineAllocator<4>> Attackers;
+		TArray<FWaitingEnemy> Waiting;
+	};
+
+	void RemoveFromEngagement( AEnemy* Enemy, FEngagement& Engagement );
+	int32 ChooseRingSlot( const FEngagement& Engagement, const FVector& ToEnemy ) const;
+
+	TMap<TWeakObjectPtr<AActor>, FEngagement> Engagements;
+	TMap<TWeakObjectPtr<AEnemy>, TWeakObjectPtr<AActor>> EnemyTargets;
+
+	UPROPERTY( Config )
+	int32 MaxAttackersPerTarget = 2;
+
+	UPROPERTY( Config )
+	int32 SlotsPerRing = 6;
+
+	UPROPERTY( Config )
+	float InnerRingRadius = 300.f;
+
+	UPROPERTY( Config )
+	float RingSpacing = 150.f;
+};
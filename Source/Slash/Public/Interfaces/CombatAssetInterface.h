@@ -0,0 +1,48 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Interface.h"
+#include "CombatAssetInterface.generated.h"
+
+// This class does not need to be modified.
+UINTERFACE(MinimalAPI)
+class UCombatAssetInterface : public UInterface
+{
+	GENERATED_BODY()
+};
+
+/**
+ * Actors whose montages, sounds and effects are soft references list them here,
+ * so UCombatAssetSubsystem can stream them in as one bundle per class.
+ */
+class SLASH_API ICombatAssetInterface
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Called on the class default object; append every soft asset the class can play */
+	virtual void GatherCombatAssets( TArray<FSoftObjectPath>& OutAssets ) const = 0;
+
+protected:
+
+	static void AddCombatAsset( TArray<FSoftObjectPath>& OutAssets, const FSoftObjectPath& Asset )
+	{
+		if ( Asset.IsValid( ) )
+		{
+			OutAssets.AddUnique( Asset );
+		}
+	}
+
+	/** Pulls in the bundle of another class this one spawns or equips */
+	static void AddCombatAssetsOf( TArray<FSoftObjectPath>& OutAssets, const UClass* Class )
+	{
+		const ICombatAssetInterface* Source = Class ? Cast<ICombatAssetInterface>( Class->GetDefaultObject( ) ) : nullptr;
+		if ( Source )
+		{
+			Source->GatherCombatAssets( OutAssets );
+		}
+	}
+};
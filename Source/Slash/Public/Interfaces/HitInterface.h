@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "UObject/Interface.h"
+#include "Characters/CharacterTypes.h"
 #include "HitInterface.generated.h"
 
 // This class does not need to be modified.
@@ -25,4 +26,13 @@ public:
 
 	UFUNCTION( BlueprintNativeEvent )
 	void GetHit( const FVector& ImpactPoint ); // this is a pure virtual function which cannot be implemented in the class it was declared 
+
+	/** Particles and hit reacts; runs after every hit of the frame has had its GetHit. Direction is the side of the actor that was hit */
+	virtual void PlayHitEffects( const FVector& ImpactPoint, EHitDirection Direction ) { }
+
+	/** Hit sound; runs after every hit of the frame has played its effects */
+	virtual void PlayHitAudio( const FVector& ImpactPoint ) { }
+
+	/** Checked by the damage bus before each hit; invulnerable actors get no damage, reaction or effects */
+	virtual bool IsInvulnerable( ) const { return false; }
 };
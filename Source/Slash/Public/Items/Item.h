@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "Interfaces/CombatAssetInterface.h"
 #include "Item.generated.h"
 
 class USphereComponent;
@@ -15,7 +16,7 @@ enum class EItemState : uint8
 };
 
 UCLASS()
-class SLASH_API AItem : public AActor
+class SLASH_API AItem : public AActor, public ICombatAssetInterface
 {
 	GENERATED_BODY()
 	
@@ -25,11 +26,14 @@ public:
 
 	virtual void Tick( float DeltaTime ) override;
 
+	virtual void GatherCombatAssets( TArray<FSoftObjectPath>& OutAssets ) const override { }
 
 protected:
 
 	virtual void BeginPlay( ) override;
 
+	virtual void EndPlay( const EEndPlayReason::Type EndPlayReason ) override;
+
 	UPROPERTY( EditAnywhere, BlueprintReadWrite, Category = SineParameters )
 	float TimeConstant = 5.f;
 
@@ -66,7 +70,9 @@ private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, meta = (AllowPrivateAccess = "true" ))
 	float RunningTime = 10.f;
 
-	
+public:
+
+	FORCEINLINE UStaticMeshComponent* GetItemMesh( ) const { return ItemMesh; }
 };
 
 template<typename T>
@@ -13,13 +13,19 @@ UCLASS()
 class SLASH_API ATreasure : public AItem
 {
 	GENERATED_BODY()
+
+public:
+
+	ATreasure( );
+
+	virtual void GatherCombatAssets( TArray<FSoftObjectPath>& OutAssets ) const override;
 	
 protected:
 	virtual void OnSphereOverlap( UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult ) override;
 
 private:
 	UPROPERTY( EditAnywhere, Category = Sounds )
-	USoundBase* PickupSound;
+	TSoftObjectPtr<USoundBase> PickupSound;
 
 	UPROPERTY( EditAnywhere, Category = TreasureProperties )
 	int32 Gold;
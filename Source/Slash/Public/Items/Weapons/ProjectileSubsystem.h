@@ -0,0 +1,108 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WorldCollision.h"
+#include "World/SlashInstancedBatches.h"
+#include "ProjectileSubsystem.generated.h"
+
+class UStaticMesh;
+
+/**
+ * One kind of arrow, bolt or spell. Every projectile of a type is drawn by the same instanced mesh.
+ */
+UCLASS( )
+class SLASH_API UProjectileType : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+
+	UPROPERTY( EditDefaultsOnly, Category = Visuals )
+	UStaticMesh* Mesh;
+
+	UPROPERTY( EditDefaultsOnly, Category = Flight )
+	float Speed = 3000.f;
+
+	/** 1 for a full gravity arc, 0 for spells that fly straight */
+	UPROPERTY( EditDefaultsOnly, Category = Flight )
+	float GravityScale = 1.f;
+
+	UPROPERTY( EditDefaultsOnly, Category = Flight )
+	float Lifetime = 5.f;
+
+	UPROPERTY( EditDefaultsOnly, Category = Collision )
+	float Radius = 5.f;
+
+	UPROPERTY( EditDefaultsOnly, Category = Collision )
+	TEnumAsByte<ECollisionChannel> CollisionChannel = ECollisionChannel::ECC_Visibility;
+
+	UPROPERTY( EditDefaultsOnly, Category = Combat )
+	float Damage = 15.f;
+};
+
+/**
+ * Every projectile in flight, kept in packed arrays rather than as actors.
+ * Each frame the previous frame's async sweeps are resolved (hits go through the damage bus),
+ * the survivors are integrated in a ParallelFor, the next batch of sweeps is issued and the
+ * instanced meshes are refreshed. Projectiles fired on clients are cosmetic and never deal damage.
+ */
+UCLASS( Config = Game )
+class SLASH_API UProjectileSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Launches along Direction at the type's speed. Causer and its owner are never hit. Returns false when the budget is full */
+	UFUNCTION( BlueprintCallable, Category = Combat )
+	bool Fire( UProjectileType* Type, const FVector& Origin, const FVector& Direction, AActor* Causer, AController* Instigator );
+
+	FORCEINLINE int32 GetNumProjectiles( ) const { return Projectiles.Num( ); }
+
+	virtual void Tick( float DeltaTime ) override;
+	virtual TStatId GetStatId( ) const override;
+	virtual void Deinitialize( ) override;
+
+private:
+
+	/* structure of arrays, one entry per projectile, removed with swaps; the type of each is its batch in Instances */
+	struct FProjectiles
+	{
+		TArray<FVector> Locations;
+		TArray<FVector> PreviousLocations;
+		TArray<FVector> Velocities;
+		TArray<float> Ages;
+		TArray<FTraceHandle> Sweeps;
+		TArray<TWeakObjectPtr<AActor>> Causers;
+		TArray<TWeakObjectPtr<AController>> Instigators;
+
+		int32 Num( ) const { return Locations.Num( ); }
+		void RemoveAtSwap( int32 Index );
+	};
+
+	int32 FindOrAddBatch( UProjectileType* Type );
+	const UProjectileType* GetType( int32 Index ) const;
+	void RemoveProjectile( int32 Index );
+
+	void ResolveSweeps( );
+	void Integrate( float DeltaTime );
+	void IssueSweeps( );
+	void UpdateInstances( );
+
+	FProjectiles Projectiles;
+	FSlashInstancedBatches Instances;
+
+	/** One per batch, in batch order */
+	UPROPERTY( )
+	TArray<UProjectileType*> Types;
+
+	UPROPERTY( Config )
+	int32 MaxProjectiles = 4096;
+
+	UPROPERTY( Config )
+	int32 ProjectilesPerTask = 256;
+};
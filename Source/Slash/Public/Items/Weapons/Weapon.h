@@ -21,6 +21,21 @@ public:
 
 	void AttachMeshToSocket( USceneComponent* InParent, FName SocketName );
 
+	/** Call between SpawnActorDeferred and FinishSpawning for weapons that go straight into a hand */
+	void PrepareForEquippedSpawn( );
+
+	virtual void GatherCombatAssets( TArray<FSoftObjectPath>& OutAssets ) const override;
+
+	void ReturnToPool( );
+	void TakeFromPool( );
+
+	/** Server only: queues damage to HitActor once per swing; the damage bus confirms it on every machine */
+	void ApplyHit( AActor* HitActor, const FVector& ImpactPoint );
+
+	/** Breaks anything near the impact and hitstops the wielder and the victim */
+	UFUNCTION( NetMulticast, Unreliable )
+	void MulticastHitConfirmed( const FVector_NetQuantize& FieldLocation, AActor* Victim );
+
 	TArray<AActor*> IgnoreActors;
 
 protected:
@@ -38,7 +53,7 @@ protected:
 
 private:
 	UPROPERTY( EditAnywhere, Category = "Weapon Properties" )
-	USoundBase* EquipSound;
+	TSoftObjectPtr<USoundBase> EquipSound;
 
 	UPROPERTY( VisibleAnywhere, Category = "Weapon Properties" )
 	UBoxComponent* WeaponBox;
@@ -52,6 +67,14 @@ private:
 	UPROPERTY(EditAnywhere, Category = "Weapon Properties" )
 	float Damage = 20.f;
 
+	/** Seconds the wielder and the victim are slowed on a confirmed hit; heavier weapons want more */
+	UPROPERTY( EditAnywhere, Category = "Weapon Properties" )
+	float HitstopDuration = 0.08f;
+
+	/** Time dilation during the hitstop, 0 freezes the pair */
+	UPROPERTY( EditAnywhere, Category = "Weapon Properties" )
+	float HitstopDilation = 0.05f;
+
 public:
 	FORCEINLINE UBoxComponent* GetWeaponBox( ) const { return WeaponBox; }
 };
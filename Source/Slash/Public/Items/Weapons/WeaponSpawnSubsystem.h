@@ -0,0 +1,65 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WeaponSpawnSubsystem.generated.h"
+
+class AEnemy;
+class AWeapon;
+class USkeletalMeshComponent;
+class UStaticMeshComponent;
+
+/**
+ * Spawns and attaches enemy weapons a few per frame instead of all at once in BeginPlay.
+ * Weapons of dead or unloaded enemies go back into a per-class pool and are reused.
+ */
+UCLASS( Config = Game )
+class SLASH_API UWeaponSpawnSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Queues a weapon for Enemy; urgent requests (enemy entering combat) jump the queue */
+	void RequestWeapon( AEnemy* Enemy, TSubclassOf<AWeapon> WeaponClass, FName SocketName, bool bUrgent = false );
+	void CancelRequests( AEnemy* Enemy );
+
+	/** Static mesh stand-in for WeaponClass, used until the enemy actually needs the weapon actor */
+	UStaticMeshComponent* AttachLightweightWeapon( USkeletalMeshComponent* Parent, TSubclassOf<AWeapon> WeaponClass, FName SocketName );
+
+	/** Returns a weapon to the pool instead of destroying it */
+	void ReleaseWeapon( AWeapon* Weapon );
+
+	FORCEINLINE bool UseLightweightWeapons( ) const { return bUseLightweightWeapons; }
+
+	virtual void Tick( float DeltaTime ) override;
+	virtual TStatId GetStatId( ) const override;
+	virtual void Deinitialize( ) override;
+
+private:
+
+	struct FWeaponRequest
+	{
+		TWeakObjectPtr<AEnemy> Enemy;
+		TSubclassOf<AWeapon> WeaponClass;
+		FName SocketName;
+	};
+
+	AWeapon* AcquireWeapon( TSubclassOf<AWeapon> WeaponClass, AEnemy* Enemy );
+
+	TArray<FWeaponRequest> Requests;
+
+	TMap<TSubclassOf<AWeapon>, TArray<TWeakObjectPtr<AWeapon>>> Pool;
+
+	UPROPERTY( Config )
+	int32 MaxSpawnsPerFrame = 2;
+
+	UPROPERTY( Config )
+	int32 MaxPooledPerClass = 16;
+
+	/** Patrolling enemies carry a static mesh and only get the weapon actor once they enter combat */
+	UPROPERTY( Config )
+	bool bUseLightweightWeapons = false;
+};
@@ -0,0 +1,115 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ReplicationGraph.h"
+#include "SlashReplicationGraph.generated.h"
+
+class USlashReplicationGraphNode_AlwaysRelevant_ForConnection;
+
+enum class ESlashClassRepNodeMapping : uint8
+{
+	ESCRNM_NotRouted,
+	ESCRNM_RelevantAllConnections,
+	ESCRNM_RelevantOwnerConnection,
+
+	/* grid cells: placed once and never move, move every frame, or sit still while dormant */
+	ESCRNM_Spatialize_Static,
+	ESCRNM_Spatialize_Dynamic,
+	ESCRNM_Spatialize_Dormancy
+};
+
+/**
+ * Replaces the per-actor, per-connection relevancy checks with a spatial grid.
+ * Enemies, weapons and characters are gathered from the grid cells around each viewer, breakables sit in
+ * static cells, treasure is routed by dormancy, and a player's own equipped weapon is always relevant to them.
+ */
+UCLASS( Transient, Config = Game )
+class SLASH_API USlashReplicationGraph : public UReplicationGraph
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void InitGlobalActorClassSettings( ) override;
+	virtual void InitGlobalGraphNodes( ) override;
+	virtual void InitConnectionGraphNodes( UNetReplicationGraphConnection* RepGraphConnection ) override;
+	virtual void RemoveClientConnection( UNetConnection* NetConnection ) override;
+
+	virtual void RouteAddNetworkActorToNodes( const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo ) override;
+	virtual void RouteRemoveNetworkActorToNodes( const FNewReplicatedActorInfo& ActorInfo ) override;
+
+	virtual int32 ServerReplicateActors( float DeltaSeconds ) override;
+
+	/** The graph sends at class rates; actors that retune their NetUpdateFrequency at runtime call this */
+	static void NotifyUpdateFrequencyChanged( AActor* Actor );
+
+private:
+
+	ESlashClassRepNodeMapping GetMappingPolicy( UClass* Class );
+	void SetClassCullDistance( UClass* Class, float CullDistance );
+
+	/** Owner-only actors are spawned before their connection exists, so they wait here until it does */
+	void FlushActorsWithoutNetConnection( );
+
+	USlashReplicationGraphNode_AlwaysRelevant_ForConnection* GetAlwaysRelevantNodeForConnection( UNetConnection* Connection ) const;
+
+	void AccumulateSoakStats( double ReplicateSeconds, float DeltaSeconds );
+
+	TClassMap<ESlashClassRepNodeMapping> ClassRepNodePolicies;
+
+	UPROPERTY( )
+	UReplicationGraphNode_GridSpatialization2D* GridNode;
+
+	UPROPERTY( )
+	UReplicationGraphNode_ActorList* AlwaysRelevantNode;
+
+	UPROPERTY( )
+	TMap<UNetConnection*, USlashReplicationGraphNode_AlwaysRelevant_ForConnection*> AlwaysRelevantForConnection;
+
+	UPROPERTY( )
+	TArray<AActor*> ActorsWithoutNetConnection;
+
+	int32 SoakFrames = 0;
+	double SoakReplicateSeconds = 0.0;
+	double SoakElapsedSeconds = 0.0;
+
+	UPROPERTY( Config )
+	float GridCellSize = 10000.f;
+
+	/** Lower left corner of the grid; anything below it is clamped into the edge cells */
+	UPROPERTY( Config )
+	FVector2D SpatialBias = FVector2D( -200000.f, -200000.f );
+
+	UPROPERTY( Config )
+	float EnemyCullDistance = 15000.f;
+
+	UPROPERTY( Config )
+	float BreakableCullDistance = 8000.f;
+
+	UPROPERTY( Config )
+	float TreasureCullDistance = 5000.f;
+
+	/** Seconds between soak reports (log line plus a row in Saved/Profiling/SlashNetSoak.csv); 0 turns them off. -SlashNetSoak=<seconds> overrides it */
+	UPROPERTY( Config )
+	float SoakReportInterval = 0.f;
+};
+
+/**
+ * Everything the connection owns (controller, player state) plus the equipped weapon of the pawn it is viewing,
+ * so a player's own weapon never depends on which grid cell it happens to be in.
+ */
+UCLASS( )
+class SLASH_API USlashReplicationGraphNode_AlwaysRelevant_ForConnection : public UReplicationGraphNode_AlwaysRelevant_ForConnection
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void GatherActorListsForConnection( const FConnectionGatherActorListParameters& Params ) override;
+
+private:
+
+	FActorRepListRefView EquippedWeapons;
+};
@@ -13,6 +13,7 @@ class UInputMappingContext;
 class UInputAction;
 class USpringArmComponent;
 class UCameraComponent;
+class UBirdMovementComponent;
 
 UCLASS()
 class SLASH_API ABird : public APawn
@@ -28,6 +29,8 @@ public:
 	// Called to bind functionality to input
 	virtual void SetupPlayerInputComponent( class UInputComponent* PlayerInputComponent ) override;
 
+	virtual UPawnMovementComponent* GetMovementComponent( ) const override;
+
 protected:
 
 	virtual void BeginPlay() override;
@@ -58,4 +61,7 @@ private:
 	UPROPERTY( VisibleAnywhere )
 	UCameraComponent* ViewCamera;
 
+	UPROPERTY( VisibleAnywhere )
+	UBirdMovementComponent* FlightMovement;
+
 };
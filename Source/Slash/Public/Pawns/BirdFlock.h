@@ -0,0 +1,104 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "BirdFlock.generated.h"
+
+class UInstancedStaticMeshComponent;
+
+/**
+ * Ambient flock of boids around the actor, drawn as one instanced mesh. A vertex animated bird mesh
+ * offsets its wingbeat by PerInstanceRandom, so animating costs nothing on the CPU. The birds live in
+ * packed float arrays in actor space; neighbours come from a hashed grid rebuilt with a counting sort,
+ * and steering and integration run in a ParallelFor. Nothing is simulated while the flock is off screen.
+ */
+UCLASS( )
+class SLASH_API ABirdFlock : public AActor
+{
+	GENERATED_BODY()
+
+public:
+
+	ABirdFlock( );
+
+	virtual void Tick( float DeltaTime ) override;
+
+protected:
+
+	virtual void BeginPlay( ) override;
+
+private:
+
+	/* structure of arrays in actor space, one entry per bird */
+	struct FBoids
+	{
+		TArray<FVector3f> Positions;
+		TArray<FVector3f> Velocities;
+		TArray<FVector3f> Steering;
+
+		int32 Num( ) const { return Positions.Num( ); }
+	};
+
+	void BuildGrid( );
+	void Steer( );
+	void Integrate( float DeltaTime );
+
+	FIntVector GetCell( const FVector3f& Position ) const;
+	static uint32 GetBucket( const FIntVector& Cell );
+
+	UPROPERTY( VisibleAnywhere )
+	UInstancedStaticMeshComponent* Instances;
+
+	FBoids Boids;
+
+	/* neighbour grid: birds sorted by bucket, and where each bucket starts */
+	TArray<int32> BucketStarts;
+	TArray<int32> SortedBoids;
+	TArray<uint32> BoidBuckets;
+
+	TArray<FTransform> InstanceTransforms;
+
+	UPROPERTY( EditAnywhere, Category = Flock )
+	int32 NumBirds = 300;
+
+	UPROPERTY( EditAnywhere, Category = Flock )
+	int32 Seed = 0;
+
+	/** Birds that stray farther than this from the actor are steered back */
+	UPROPERTY( EditAnywhere, Category = Flock )
+	float Radius = 3000.f;
+
+	/** Also the size of the neighbour grid's cells */
+	UPROPERTY( EditAnywhere, Category = Flock, meta = (ClampMin = "1.0") )
+	float NeighbourRadius = 300.f;
+
+	UPROPERTY( EditAnywhere, Category = Flock )
+	float SeparationRadius = 100.f;
+
+	UPROPERTY( EditAnywhere, Category = Flock )
+	float MinSpeed = 300.f;
+
+	UPROPERTY( EditAnywhere, Category = Flock )
+	float MaxSpeed = 700.f;
+
+	/** Cap on steering acceleration, cm/s^2 */
+	UPROPERTY( EditAnywhere, Category = Flock )
+	float MaxSteering = 800.f;
+
+	UPROPERTY( EditAnywhere, Category = Flock )
+	float SeparationWeight = 1.5f;
+
+	UPROPERTY( EditAnywhere, Category = Flock )
+	float AlignmentWeight = 1.f;
+
+	UPROPERTY( EditAnywhere, Category = Flock )
+	float CohesionWeight = 1.f;
+
+	UPROPERTY( EditAnywhere, Category = Flock )
+	float HomeWeight = 1.f;
+
+	UPROPERTY( EditAnywhere, Category = Flock )
+	int32 BirdsPerTask = 64;
+};
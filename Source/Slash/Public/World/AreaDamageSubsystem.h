@@ -0,0 +1,104 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "AreaDamageSubsystem.generated.h"
+
+UENUM( BlueprintType )
+enum class EAreaDamageShape : uint8
+{
+	EADS_Sphere UMETA( DisplayName = "Sphere" ),
+	EADS_Cone UMETA( DisplayName = "Cone" ),
+	EADS_CapsuleSweep UMETA( DisplayName = "CapsuleSweep" )
+};
+
+USTRUCT( BlueprintType )
+struct FSlashAreaDamage
+{
+	GENERATED_BODY()
+
+	UPROPERTY( EditAnywhere, BlueprintReadWrite )
+	EAreaDamageShape Shape = EAreaDamageShape::EADS_Sphere;
+
+	/** Sphere center, cone apex or sweep start */
+	UPROPERTY( EditAnywhere, BlueprintReadWrite )
+	FVector Origin = FVector::ZeroVector;
+
+	/** Cone axis, only used by cones */
+	UPROPERTY( EditAnywhere, BlueprintReadWrite )
+	FVector Direction = FVector::ForwardVector;
+
+	/** Where a capsule sweep ends, only used by sweeps */
+	UPROPERTY( EditAnywhere, BlueprintReadWrite )
+	FVector SweepEnd = FVector::ZeroVector;
+
+	UPROPERTY( EditAnywhere, BlueprintReadWrite )
+	float Radius = 300.f;
+
+	UPROPERTY( EditAnywhere, BlueprintReadWrite )
+	float ConeHalfAngle = 45.f;
+
+	/** Damage at the center; falls off linearly to Damage * MinDamageScale at the edge */
+	UPROPERTY( EditAnywhere, BlueprintReadWrite )
+	float Damage = 20.f;
+
+	UPROPERTY( EditAnywhere, BlueprintReadWrite )
+	float MinDamageScale = 0.25f;
+};
+
+/**
+ * Hash grid of every hittable actor, rebuilt at most once a frame on the first query, so an AoE
+ * attack or a lock-on scan is one lookup over the cells it touches instead of a physics overlap per target.
+ * Results go through the damage bus, which applies health, GetHit and effects to them as one batch.
+ */
+UCLASS( Config = Game )
+class SLASH_API UAreaDamageSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	void RegisterTarget( AActor* Target );
+	void UnregisterTarget( AActor* Target );
+
+	/** Server only, does nothing on clients. Causer, its owner and the instigator's pawn are never hit. Returns the number of actors hit */
+	UFUNCTION( BlueprintCallable, Category = Combat )
+	int32 ApplyAreaDamage( const FSlashAreaDamage& Area, AActor* Causer, AController* Instigator );
+
+	/** Every registered actor whose center is within Radius of Center */
+	void GatherTargets( const FVector& Center, float Radius, TArray<AActor*>& OutTargets );
+
+private:
+
+	struct FTargetEntry
+	{
+		FVector Location;
+		float Radius;
+	};
+
+	void RebuildGrid( );
+	void RebuildGridIfStale( );
+	FIntPoint GetCell( const FVector& Location ) const;
+
+	/** Dead characters stay registered until they are destroyed, but are never hit or gathered again */
+	static bool IsLiveTarget( AActor* Target );
+
+	/** Damage scale for a target, 0 if it is outside the shape. OutClosest is the nearest point of the shape */
+	float GetDamageScale( const FSlashAreaDamage& Area, const FTargetEntry& Entry, double CosHalfAngle, FVector& OutClosest ) const;
+
+	TArray<TWeakObjectPtr<AActor>> Targets;
+
+	/* per frame snapshot of Targets, same order */
+	TArray<FTargetEntry> Entries;
+
+	/* only cells with someone in them; occupied cells keep their arrays across rebuilds */
+	TMap<FIntPoint, TArray<int32>> Cells;
+
+	float MaxTargetRadius = 0.f;
+	uint64 GridFrame = MAX_uint64;
+
+	UPROPERTY( Config )
+	float CellSize = 1000.f;
+};
@@ -0,0 +1,48 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/StreamableManager.h"
+#include "UObject/ObjectKey.h"
+#include "CombatAssetSubsystem.generated.h"
+
+/**
+ * Streams in the soft combat assets (montages, sounds, effects) of each actor class as a bundle.
+ * A bundle starts loading when the first actor of its class begins play, usually as its cell streams in,
+ * and is released once the last one has gone so the assets can be garbage collected.
+ */
+UCLASS( )
+class SLASH_API UCombatAssetSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Safe to call more than once per actor; OnLoaded runs once the bundle is resident, right away if it already is, and not at all if the actor releases it first */
+	void AcquireBundle( const AActor* Actor, FSimpleDelegate OnLoaded = FSimpleDelegate( ) );
+	void ReleaseBundle( const AActor* Actor );
+
+	/** Streams in one asset outside any bundle; OnLoaded runs on the game thread once it is resident */
+	void LoadAsync( const FSoftObjectPath& Asset, FStreamableDelegate OnLoaded );
+
+	virtual void Deinitialize( ) override;
+
+private:
+
+	struct FCombatAssetBundle
+	{
+		TSharedPtr<FStreamableHandle> Handle;
+		TSet<TObjectKey<AActor>> Users;
+
+		/* OnLoaded callbacks waiting for Handle, by the actor that acquired */
+		TArray<TPair<TObjectKey<AActor>, FSimpleDelegate>> PendingCallbacks;
+	};
+
+	void OnBundleLoaded( TObjectKey<UClass> ClassKey );
+
+	TMap<TObjectKey<UClass>, FCombatAssetBundle> Bundles;
+
+	FStreamableManager StreamableManager;
+};
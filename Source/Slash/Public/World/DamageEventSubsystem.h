@@ -0,0 +1,58 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Containers/MpscQueue.h"
+#include "Characters/CharacterTypes.h"
+#include "DamageEventSubsystem.generated.h"
+
+/* one resolved hit; plain data so it can be recorded from any thread */
+struct FSlashDamageEvent
+{
+	TWeakObjectPtr<AActor> Target;
+	TWeakObjectPtr<AActor> Causer;
+	TWeakObjectPtr<AController> Instigator;
+	FVector ImpactPoint = FVector::ZeroVector;
+	float Damage = 0.f;
+};
+
+/**
+ * Damage bus. Hits are queued instead of applied on the overlap's call stack, and once per frame
+ * the queue is drained and run in phases across the whole batch: health, then AI and gameplay
+ * reactions (IHitInterface::GetHit), then visual effects (IHitInterface::PlayHitEffects), then sound
+ * (IHitInterface::PlayHitAudio). Hits dropped by the health phase run none of the later phases.
+ * QueueDamage is safe to call from async trace callbacks and worker tasks.
+ */
+UCLASS( )
+class SLASH_API UDamageEventSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Thread safe */
+	void QueueDamage( const FSlashDamageEvent& Event );
+
+	virtual void Tick( float DeltaTime ) override;
+	virtual TStatId GetStatId( ) const override;
+
+private:
+
+	void ApplyHealthPhase( );
+	void ApplyReactionPhase( );
+	void ApplyEffectsPhase( );
+	void ApplyAudioPhase( );
+
+	TMpscQueue<FSlashDamageEvent> PendingEvents;
+
+	/* this frame's events, drained from PendingEvents; kept around so its allocation is reused */
+	TArray<FSlashDamageEvent> FrameEvents;
+
+	/* hit direction inputs and results for this frame's events, same order as FrameEvents */
+	TArray<FVector> HitForwards;
+	TArray<FVector> HitLocations;
+	TArray<FVector> HitImpactPoints;
+	TArray<EHitDirection> HitDirections;
+};
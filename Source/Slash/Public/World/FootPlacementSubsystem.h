@@ -0,0 +1,101 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WorldCollision.h"
+#include "UObject/ObjectKey.h"
+#include "Containers/SlashKeyIndex.h"
+#include "FootPlacementSubsystem.generated.h"
+
+class ACharacter;
+
+/* ground under one foot, as the foot IK control rigs want it */
+USTRUCT( BlueprintType )
+struct FSlashFootGround
+{
+	GENERATED_BODY()
+
+	/** Ground height relative to the bottom of the capsule */
+	UPROPERTY( BlueprintReadOnly )
+	float Offset = 0.f;
+
+	UPROPERTY( BlueprintReadOnly )
+	FVector Normal = FVector::UpVector;
+
+	/** False while the character isn't probed or nothing is under the foot; the IK should blend out */
+	UPROPERTY( BlueprintReadOnly )
+	bool bValid = false;
+};
+
+/**
+ * Ground probes for foot IK, for every registered character in one place. Each tick reads last frame's
+ * async traces into a per-foot cache and issues the next batch, at a cadence picked by significance:
+ * near characters every frame, farther ones every FarProbeInterval, and off screen or distant ones not at all.
+ * Anim instances copy the cache on the game thread in NativeUpdateAnimation for their thread safe graph.
+ */
+UCLASS( Config = Game )
+class SLASH_API UFootPlacementSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual bool ShouldCreateSubsystem( UObject* Outer ) const override;
+
+	void RegisterCharacter( ACharacter* Character, FName LeftFootSocket, FName RightFootSocket );
+	void UnregisterCharacter( ACharacter* Character );
+
+	/** Ground under both feet, relative to where the character stands now */
+	bool GetFootGround( const ACharacter* Character, FSlashFootGround& OutLeft, FSlashFootGround& OutRight ) const;
+
+	virtual void Tick( float DeltaTime ) override;
+	virtual TStatId GetStatId( ) const override;
+
+private:
+
+	enum EFoot { Left, Right, NumFeet };
+
+	struct FFootProbe
+	{
+		FName Socket;
+		FTraceHandle Trace;
+		float GroundZ = 0.f;
+		FVector Normal = FVector::UpVector;
+		bool bValid = false;
+	};
+
+	struct FFootPlacement
+	{
+		TWeakObjectPtr<ACharacter> Character;
+		FFootProbe Feet[NumFeet];
+		float TimeUntilProbe = 0.f;
+	};
+
+	void ReadProbes( );
+	void IssueProbes( float DeltaTime );
+	bool GetViewLocation( FVector& OutLocation ) const;
+	void RemoveAtSwap( int32 Index );
+
+	TArray<FFootPlacement> Placements;
+	TSlashKeyIndex<TObjectKey<ACharacter>> PlacementIndices;
+
+	/** Closer than this the feet are probed every frame */
+	UPROPERTY( Config )
+	float NearDistance = 1500.f;
+
+	/** Farther than this, or not rendered recently, the feet aren't probed and the IK blends out */
+	UPROPERTY( Config )
+	float MaxDistance = 5000.f;
+
+	UPROPERTY( Config )
+	float FarProbeInterval = 0.15f;
+
+	/** How far above and below the bottom of the capsule a foot looks for ground */
+	UPROPERTY( Config )
+	float TraceUp = 50.f;
+
+	UPROPERTY( Config )
+	float TraceDown = 75.f;
+};
@@ -0,0 +1,70 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "Containers/SlashKeyIndex.h"
+#include "HitstopSubsystem.generated.h"
+
+/* one actor under hitstop; pulses landing on it while it lasts stack into this */
+struct FHitstop
+{
+	TWeakObjectPtr<AActor> Actor;
+
+	/** Deepest dilation among the stacked pulses, as a multiplier on BaseDilation */
+	float Dilation = 1.f;
+
+	/** Seconds of world time left */
+	float Remaining = 0.f;
+
+	/** CustomTimeDilation the actor had before the first pulse, restored when the stack runs out */
+	float BaseDilation = 1.f;
+};
+
+/**
+ * Hitstop without freezing the world: short CustomTimeDilation pulses on just the actors in a hit.
+ * Every pulse in the world is advanced from this one Tick instead of a timer per actor. Pulses on an
+ * actor already stopped extend its time (up to MaxDuration) and keep the deeper dilation, and the
+ * last DecayTime seconds ease it back to normal speed. Anything driven by the actor's own tick
+ * (montages, movement, AEnemy's wait timers) slows with it.
+ * It is purely presentation: in networked games only hits involving the local player are stopped, and
+ * actors the server simulates for everyone are never slowed there.
+ */
+UCLASS( Config = Game )
+class SLASH_API UHitstopSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Deinitialize( ) override;
+
+	void AddPulse( AActor* Actor, float Duration, float Dilation );
+
+	/** Pulses both sides of a hit, if this machine's player is one of them */
+	void AddHitPulse( AActor* Attacker, AActor* Victim, float Duration, float Dilation );
+
+	virtual void Tick( float DeltaTime ) override;
+	virtual TStatId GetStatId( ) const override;
+
+private:
+
+	void RemoveAtSwap( int32 Index );
+
+	static bool IsLocallyControlled( const AActor* Actor );
+
+	/** False for actors this machine simulates on everyone's behalf in a networked game */
+	static bool CanDilate( const AActor* Actor );
+
+	TArray<FHitstop> Hitstops;
+	TSlashKeyIndex<TObjectKey<AActor>> HitstopIndices;
+
+	/** Cap on how long stacked pulses may keep one actor slowed */
+	UPROPERTY( Config )
+	float MaxDuration = 0.3f;
+
+	UPROPERTY( Config )
+	float DecayTime = 0.05f;
+};
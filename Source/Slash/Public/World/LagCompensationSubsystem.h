@@ -0,0 +1,63 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "LagCompensationSubsystem.generated.h"
+
+/**
+ * Server-side location history for hittable actors, so a client's hit can be checked
+ * against where the target was on that client's screen rather than where it is now.
+ */
+UCLASS( Config = Game )
+class SLASH_API ULagCompensationSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	void RegisterActor( AActor* Actor );
+	void UnregisterActor( AActor* Actor );
+
+	/** Interpolated location of Actor at server time Time, clamped to the recorded window */
+	FVector GetLocationAtTime( const AActor* Actor, double Time ) const;
+
+	/** Client side: the server time of what this client is showing, its estimate of the server clock minus the interpolation delay */
+	double GetClientViewTime( ) const;
+
+	virtual void Tick( float DeltaTime ) override;
+	virtual TStatId GetStatId( ) const override;
+	virtual void Deinitialize( ) override;
+
+private:
+
+	struct FLocationSample
+	{
+		double Time = 0.0;
+		FVector Location = FVector::ZeroVector;
+	};
+
+	/** Fixed size ring of samples, oldest at Head */
+	struct FLocationHistory
+	{
+		TArray<FLocationSample> Samples;
+		int32 Head = 0;
+	};
+
+	int32 GetHistoryLength( ) const;
+
+	TMap<TWeakObjectPtr<AActor>, FLocationHistory> Histories;
+
+	double TimeSinceSample = 0.0;
+
+	UPROPERTY( Config )
+	float MaxRewindTime = 0.4f;
+
+	UPROPERTY( Config )
+	float SampleRate = 30.f;
+
+	/** How far behind the replicated state other actors are drawn on clients */
+	UPROPERTY( Config )
+	float InterpolationDelay = 0.1f;
+};
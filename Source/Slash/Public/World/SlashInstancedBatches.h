@@ -0,0 +1,72 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UInstancedStaticMeshComponent;
+class UStaticMesh;
+
+/*
+* Instanced meshes drawing the entries of a packed array owned elsewhere, one batch per mesh.
+* Every entry keeps its own instance, so entries coming and going add or remove single instances instead of
+* clearing and refilling the component, and a frame's update is one ranged transform write per batch.
+* The owner calls AddEntry and RemoveAtSwap in step with its own swap-removed arrays.
+*/
+class SLASH_API FSlashInstancedBatches
+{
+public:
+
+	/** New batch drawing Mesh, on a transient actor spawned into World the first time round */
+	int32 AddBatch( UWorld* World, UStaticMesh* Mesh );
+
+	/** Call when appending an entry to the owner's arrays */
+	void AddEntry( int32 Batch, const FTransform& Transform );
+
+	/** Call when swap-removing entry Index from the owner's arrays */
+	void RemoveAtSwap( int32 Index );
+
+	/** Writes GetTransform( Entry ) into every live instance */
+	template <typename FuncType>
+	void UpdateTransforms( FuncType&& GetTransform )
+	{
+		for ( FBatch& Batch : Batches )
+		{
+			Transforms.Reset( Batch.Entries.Num( ) );
+			for ( const int32 Entry : Batch.Entries )
+			{
+				Transforms.Add( GetTransform( Entry ) );
+			}
+			FlushTransforms( Batch );
+		}
+	}
+
+	void Reset( );
+
+	FORCEINLINE int32 GetBatch( int32 Entry ) const { return EntryBatches[Entry]; }
+	FORCEINLINE int32 NumBatches( ) const { return Batches.Num( ); }
+	FORCEINLINE int32 NumEntries( ) const { return EntryBatches.Num( ); }
+	UInstancedStaticMeshComponent* GetInstances( int32 Batch ) const;
+
+private:
+
+	struct FBatch
+	{
+		TWeakObjectPtr<UInstancedStaticMeshComponent> Instances;
+
+		/** Owner entry behind each instance */
+		TArray<int32> Entries;
+	};
+
+	void FlushTransforms( FBatch& Batch );
+
+	TArray<FBatch> Batches;
+
+	/* one per owner entry */
+	TArray<uint16> EntryBatches;
+	TArray<int32> EntryInstances;
+
+	TArray<FTransform> Transforms;
+
+	TWeakObjectPtr<AActor> InstanceOwner;
+};
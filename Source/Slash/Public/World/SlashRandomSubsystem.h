@@ -0,0 +1,54 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SlashRandomSubsystem.generated.h"
+
+/** One stream per consumer, so an extra roll in one system doesn't shift every other system's results */
+enum class ESlashRandomStream : uint8
+{
+	ESRS_EnemyCombat,
+	ESRS_EnemyPatrol,
+	ESRS_Animation,
+	ESRS_Loot,
+
+	ESRS_MAX
+};
+
+/**
+ * Seeded gameplay randomness. Every stream is derived from a single master seed,
+ * which comes from -SlashSeed=, DefaultSeed in config, or the clock, and is logged at startup.
+ */
+UCLASS( Config = Game )
+class SLASH_API USlashRandomSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Initialize( FSubsystemCollectionBase& Collection ) override;
+
+	/** Reseeds every stream, e.g. from a replay header */
+	void SetMasterSeed( int32 Seed );
+
+	FRandomStream& GetStream( ESlashRandomStream Stream );
+
+	/** Stream for WorldContextObject's world; falls back to an unseeded stream outside a world */
+	static FRandomStream& GetStream( const UObject* WorldContextObject, ESlashRandomStream Stream );
+
+private:
+
+	FRandomStream Streams[static_cast<int32>( ESlashRandomStream::ESRS_MAX )];
+
+	int32 MasterSeed = 0;
+
+	/** 0 picks a new seed every session */
+	UPROPERTY( Config )
+	int32 DefaultSeed = 0;
+
+public:
+
+	FORCEINLINE int32 GetMasterSeed( ) const { return MasterSeed; }
+};
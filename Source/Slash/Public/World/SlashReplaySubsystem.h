@@ -0,0 +1,84 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SlashReplaySubsystem.generated.h"
+
+enum class ESlashInputAction : uint8
+{
+	ESIA_Move,
+	ESIA_Look,
+	ESIA_Jump,
+	ESIA_Equip,
+	ESIA_Attack,
+	ESIA_LockOn,
+	ESIA_SwitchTarget,
+	ESIA_Dodge,
+
+	ESIA_MAX
+};
+
+/**
+ * Fixed-step simulation plus a compact recorder for player input and the random seed.
+ * -SlashRecord=Name writes Saved/Replays/Name_Map.slashreplay when a game world shuts down, one file per map
+ * (and per PIE window past the first); -SlashReplay=Name feeds each map's file back frame by frame
+ * (add -nullrhi -SlashReplayExit to run it headless). Editor and preview worlds never record.
+ */
+UCLASS( Config = Game )
+class SLASH_API USlashReplaySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual bool DoesSupportWorldType( const EWorldType::Type WorldType ) const override;
+	virtual void Initialize( FSubsystemCollectionBase& Collection ) override;
+	virtual void Deinitialize( ) override;
+
+	/** Input handlers ask before acting. Recorded while recording; during playback only the replay's own input gets through */
+	bool AcceptInput( ESlashInputAction Action, const FVector2D& Value = FVector2D::ZeroVector );
+
+private:
+
+	struct FInputRecord
+	{
+		uint32 Frame = 0;
+		ESlashInputAction Action = ESlashInputAction::ESIA_MAX;
+		FVector2f Value = FVector2f::ZeroVector;
+	};
+
+	void OnWorldTickStart( UWorld* World, ELevelTick TickType, float DeltaSeconds );
+	void DispatchFrame( );
+	void SerializeReplay( FArchive& Ar );
+	/** ReplayName keyed by this world's map and PIE instance, so worlds sharing a command line don't overwrite each other */
+	FString GetReplayPath( ) const;
+
+	TArray<FInputRecord> Records;
+	int32 PlaybackIndex = 0;
+	uint32 Frame = 0;
+
+	int32 Seed = 0;
+	float FixedDeltaTime = 1.f / 60.f;
+
+	FString ReplayName;
+	bool bRecording = false;
+	bool bPlayingBack = false;
+	bool bDispatching = false;
+	bool bExitWhenFinished = false;
+
+	FDelegateHandle TickStartHandle;
+
+	/** Also switched on by -SlashFixedStep, and always on while recording or replaying */
+	UPROPERTY( Config )
+	bool bFixedStep = false;
+
+	UPROPERTY( Config )
+	float FixedStepRate = 60.f;
+
+public:
+
+	FORCEINLINE bool IsRecording( ) const { return bRecording; }
+	FORCEINLINE bool IsPlayingBack( ) const { return bPlayingBack; }
+};
@@ -0,0 +1,128 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Containers/Ticker.h"
+#include "Async/Future.h"
+#include "Enemy/EnemyCompactState.h"
+#include "SlashSaveSubsystem.generated.h"
+
+class ASlashCharacter;
+
+/* everything persisted for one streaming cell (or level), keyed by the actors' persistent ids */
+struct FSlashCellSaveData
+{
+	TMap<FGuid, FEnemyCompactState> Enemies;
+
+	/** Placed actors that must not come back: broken breakables, collected treasure and weapons */
+	TSet<FGuid> RemovedActors;
+
+	friend FArchive& operator<<( FArchive& Ar, FSlashCellSaveData& CellData )
+	{
+		if ( Ar.IsLoading( ) )
+		{
+			CellData.Load( Ar );
+			return Ar;
+		}
+		Ar << CellData.Enemies;
+		Ar << CellData.RemovedActors;
+		return Ar;
+	}
+
+	/** Reads back what operator<< wrote, refusing element counts the remaining bytes can't hold */
+	void Load( FArchive& Ar );
+};
+
+struct FSlashPlayerSaveData
+{
+	float Health = 0.f;
+	FString WeaponClass;
+
+	friend FArchive& operator<<( FArchive& Ar, FSlashPlayerSaveData& PlayerData )
+	{
+		Ar << PlayerData.Health;
+		Ar << PlayerData.WeaponClass;
+		return Ar;
+	}
+};
+
+/**
+ * Persistent world combat state that survives level reloads and is written to Saved/SaveGames/<SlotName>.slashsave.
+ * The file is a versioned list of binary chunks, one per World Partition cell plus one for the player.
+ * Chunks are only decoded when their cell streams in, only re-encoded when something in them changed,
+ * and the file itself is read and written on a worker thread.
+ */
+UCLASS( Config = Game )
+class SLASH_API USlashSaveSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Initialize( FSubsystemCollectionBase& Collection ) override;
+	virtual void Deinitialize( ) override;
+
+	static USlashSaveSubsystem* Get( const UObject* WorldContextObject );
+
+	void RecordEnemy( const AActor* Enemy, const FEnemyCompactState& State );
+
+	/** For enemies that only exist as crowd proxies, with the id and level of the actor they came from */
+	void RecordEnemy( const ULevel* Level, const FGuid& PersistentId, const FEnemyCompactState& State );
+
+	/** Hands out the state an enemy left behind. Only deaths are remembered past this. */
+	bool ConsumeEnemyState( const AActor* Enemy, FEnemyCompactState& OutState );
+
+	void RecordRemoved( const AActor* Actor );
+	bool WasRemoved( const AActor* Actor );
+
+	void CapturePlayer( const ASlashCharacter* Character );
+	const FSlashPlayerSaveData* GetPlayerData( );
+
+	/** Records the live enemies and crowd proxies, encodes dirty cells on the game thread, then writes the file on a worker */
+	void SaveGameAsync( );
+
+	bool IsSaving( ) const;
+
+private:
+
+	FSlashCellSaveData* FindCell( const AActor* Actor, FGuid& OutId, bool bCreate );
+	FSlashCellSaveData* FindCell( FName CellName, bool bCreate );
+	static FName GetCellName( const ULevel* Level );
+
+	/** Blocks only if the file read started in Initialize hasn't finished yet */
+	void WaitForLoad( );
+	void ParseSaveFile( const TArray<uint8>& Bytes );
+
+	bool Tick( float DeltaTime );
+
+	FString GetSavePath( ) const;
+
+	/* cells that have streamed in at least once since the file was read */
+	TMap<FName, FSlashCellSaveData> Cells;
+
+	/** Encoded chunk per cell: read from the file and not decoded yet, or the last encoding of a clean cell */
+	TMap<FName, TArray<uint8>> ChunkBlobs;
+
+	TSet<FName> DirtyCells;
+
+	FSlashPlayerSaveData PlayerData;
+	bool bHasPlayerData = false;
+
+	TFuture<TArray<uint8>> PendingLoad;
+	TFuture<bool> PendingWrite;
+
+	FTSTicker::FDelegateHandle TickerHandle;
+	float TimeSinceAutosave = 0.f;
+
+	UPROPERTY( Config )
+	FString SlotName = TEXT( "Slash" );
+
+	/** Seconds between autosaves, 0 turns them off */
+	UPROPERTY( Config )
+	float AutosaveInterval = 0.f;
+
+	UPROPERTY( Config )
+	bool bLoadOnStart = true;
+};
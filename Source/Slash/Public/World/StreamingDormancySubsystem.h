@@ -0,0 +1,65 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Enemy/EnemyCompactState.h"
+#include "StreamingDormancySubsystem.generated.h"
+
+class AEnemy;
+class ABreakableActor;
+class USlashSaveSubsystem;
+
+/**
+ * Enemies and breakables register here when their World Partition cell streams in.
+ * They stay dormant until a player first gets within WakeRadius, go back to sleep past SleepRadius,
+ * and leave their compact state with USlashSaveSubsystem when the cell unloads so it can be restored on the next load.
+ */
+UCLASS( Config = Game )
+class SLASH_API UStreamingDormancySubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	void RegisterEnemy( AEnemy* Enemy );
+	void UnregisterEnemy( AEnemy* Enemy, const FEnemyCompactState& FinalState, EEndPlayReason::Type EndPlayReason );
+
+	/** Stops tracking an enemy parked in the crowd pool without recording anything; its proxy holds the state */
+	void ReleaseEnemy( AEnemy* Enemy );
+
+	/** Hands the current state of every registered enemy to the save, for saves taken while their cell is loaded */
+	void RecordLiveEnemies( USlashSaveSubsystem& Save ) const;
+
+	void RegisterBreakable( ABreakableActor* Breakable );
+	void UnregisterBreakable( ABreakableActor* Breakable );
+
+	/** Stable id for actors placed in a level, or enemies respawned for one; invalid for anything else spawned at runtime */
+	static FGuid GetPersistentId( const AActor* Actor );
+
+	virtual void Tick( float DeltaTime ) override;
+	virtual TStatId GetStatId( ) const override;
+	virtual void Deinitialize( ) override;
+
+private:
+
+	void GatherViewerLocations( );
+	double GetDistanceSquaredToNearestViewer( const FVector& Location ) const;
+
+	TArray<TWeakObjectPtr<AEnemy>> Enemies;
+	TArray<TWeakObjectPtr<ABreakableActor>> Breakables;
+	TArray<FVector> ViewerLocations;
+
+	float TimeSinceUpdate = 0.f;
+
+	UPROPERTY( Config )
+	double WakeRadius = 8000.0;
+
+	/** Larger than WakeRadius so actors near the edge don't flip back and forth */
+	UPROPERTY( Config )
+	double SleepRadius = 10000.0;
+
+	UPROPERTY( Config )
+	float UpdateInterval = 0.5f;
+};
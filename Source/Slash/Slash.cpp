@@ -1,6 +1,46 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 
 #include "Slash.h"
+#include "SlashStats.h"
 #include "Modules/ModuleManager.h"
 
 IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, Slash, "Slash" );
+
+UE_TRACE_CHANNEL_DEFINE( SlashChannel );
+CSV_DEFINE_CATEGORY_MODULE( SLASH_API, Slash, true );
+
+DEFINE_STAT( STAT_SlashEnemyTick );
+DEFINE_STAT( STAT_SlashEnemyPawnSeen );
+DEFINE_STAT( STAT_SlashEnemyTakeDamage );
+DEFINE_STAT( STAT_SlashDirectionalHitReact );
+DEFINE_STAT( STAT_SlashSpawnHitParticles );
+DEFINE_STAT( STAT_SlashWeaponBoxOverlap );
+DEFINE_STAT( STAT_SlashBreakableGetHit );
+DEFINE_STAT( STAT_SlashCrowdTick );
+DEFINE_STAT( STAT_SlashDormancyTick );
+DEFINE_STAT( STAT_SlashWeaponSpawnTick );
+DEFINE_STAT( STAT_SlashLagCompensationTick );
+DEFINE_STAT( STAT_SlashReplicateActors );
+DEFINE_STAT( STAT_SlashSaveSnapshot );
+DEFINE_STAT( STAT_SlashDamageEvents );
+DEFINE_STAT( STAT_SlashAreaDamage );
+DEFINE_STAT( STAT_SlashProjectileTick );
+DEFINE_STAT( STAT_SlashHitstop );
+DEFINE_STAT( STAT_SlashCameraProbe );
+DEFINE_STAT( STAT_SlashCameraOcclusion );
+DEFINE_STAT( STAT_SlashFootPlacement );
+DEFINE_STAT( STAT_SlashBirdFlight );
+DEFINE_STAT( STAT_SlashBirdFlock );
+
+DEFINE_STAT( STAT_SlashEnemiesPatrolling );
+DEFINE_STAT( STAT_SlashEnemiesChasing );
+DEFINE_STAT( STAT_SlashEnemiesAttacking );
+DEFINE_STAT( STAT_SlashEnemiesEngaged );
+DEFINE_STAT( STAT_SlashEnemiesDead );
+DEFINE_STAT( STAT_SlashWeaponTraces );
+DEFINE_STAT( STAT_SlashHitsApplied );
+
+DEFINE_STAT( STAT_SlashTreasuresSpawned );
+DEFINE_STAT( STAT_SlashCrowdProxies );
+DEFINE_STAT( STAT_SlashPendingWeaponSpawns );
+DEFINE_STAT( STAT_SlashProjectilesInFlight );
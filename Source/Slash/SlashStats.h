@@ -0,0 +1,60 @@
+#pragma once
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+
+/*
+*  `stat slash` in the console, or -trace=cpu,slash for Unreal Insights
+*/
+DECLARE_STATS_GROUP( TEXT( "Slash" ), STATGROUP_Slash, STATCAT_Advanced );
+
+UE_TRACE_CHANNEL_EXTERN( SlashChannel, SLASH_API );
+CSV_DECLARE_CATEGORY_MODULE_EXTERN( SLASH_API, Slash );
+
+// CPU event on the Slash trace channel, so -trace=slash captures gameplay scopes on their own, plus a CSV profiler timing
+#define SLASH_SCOPE_TRACE( Stat ) \
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL( Stat, SlashChannel ); \
+	CSV_SCOPED_TIMING_STAT( Slash, Stat )
+
+#define SLASH_SCOPE_CYCLE_COUNTER( Stat ) \
+	SCOPE_CYCLE_COUNTER( Stat ); \
+	SLASH_SCOPE_TRACE( Stat )
+
+/* Cycle counters */
+DECLARE_CYCLE_STAT_EXTERN( TEXT( "Enemy Tick" ), STAT_SlashEnemyTick, STATGROUP_Slash, SLASH_API );
+DECLARE_CYCLE_STAT_EXTERN( TEXT( "Enemy PawnSeen" ), STAT_SlashEnemyPawnSeen, STATGROUP_Slash, SLASH_API );
+DECLARE_CYCLE_STAT_EXTERN( TEXT( "Enemy TakeDamage" ), STAT_SlashEnemyTakeDamage, STATGROUP_Slash, SLASH_API );
+DECLARE_CYCLE_STAT_EXTERN( TEXT( "Directional Hit React" ), STAT_SlashDirectionalHitReact, STATGROUP_Slash, SLASH_API );
+DECLARE_CYCLE_STAT_EXTERN( TEXT( "Spawn Hit Particles" ), STAT_SlashSpawnHitParticles, STATGROUP_Slash, SLASH_API );
+DECLARE_CYCLE_STAT_EXTERN( TEXT( "Weapon Box Overlap" ), STAT_SlashWeaponBoxOverlap, STATGROUP_Slash, SLASH_API );
+DECLARE_CYCLE_STAT_EXTERN( TEXT( "Breakable GetHit" ), STAT_SlashBreakableGetHit, STATGROUP_Slash, SLASH_API );
+DECLARE_CYCLE_STAT_EXTERN( TEXT( "Crowd Tick" ), STAT_SlashCrowdTick, STATGROUP_Slash, SLASH_API );
+DECLARE_CYCLE_STAT_EXTERN( TEXT( "Dormancy Tick" ), STAT_SlashDormancyTick, STATGROUP_Slash, SLASH_API );
+DECLARE_CYCLE_STAT_EXTERN( TEXT( "Weapon Spawn Tick" ), STAT_SlashWeaponSpawnTick, STATGROUP_Slash, SLASH_API );
+DECLARE_CYCLE_STAT_EXTERN( TEXT( "Lag Compensation Tick" ), STAT_SlashLagCompensationTick, STATGROUP_Slash, SLASH_API );
+DECLARE_CYCLE_STAT_EXTERN( TEXT( "Replicate Actors" ), STAT_SlashReplicateActors, STATGROUP_Slash, SLASH_API );
+DECLARE_CYCLE_STAT_EXTERN( TEXT( "Save Snapshot" ), STAT_SlashSaveSnapshot, STATGROUP_Slash, SLASH_API );
+DECLARE_CYCLE_STAT_EXTERN( TEXT( "Damage Events" ), STAT_SlashDamageEvents, STATGROUP_Slash, SLASH_API );
+DECLARE_CYCLE_STAT_EXTERN( TEXT( "Area Damage" ), STAT_SlashAreaDamage, STATGROUP_Slash, SLASH_API );
+DECLARE_CYCLE_STAT_EXTERN( TEXT( "Projectile Tick" ), STAT_SlashProjectileTick, STATGROUP_Slash, SLASH_API );
+DECLARE_CYCLE_STAT_EXTERN( TEXT( "Hitstop" ), STAT_SlashHitstop, STATGROUP_Slash, SLASH_API );
+DECLARE_CYCLE_STAT_EXTERN( TEXT( "Camera Probe" ), STAT_SlashCameraProbe, STATGROUP_Slash, SLASH_API );
+DECLARE_CYCLE_STAT_EXTERN( TEXT( "Camera Occlusion" ), STAT_SlashCameraOcclusion, STATGROUP_Slash, SLASH_API );
+DECLARE_CYCLE_STAT_EXTERN( TEXT( "Foot Placement" ), STAT_SlashFootPlacement, STATGROUP_Slash, SLASH_API );
+DECLARE_CYCLE_STAT_EXTERN( TEXT( "Bird Flight" ), STAT_SlashBirdFlight, STATGROUP_Slash, SLASH_API );
+DECLARE_CYCLE_STAT_EXTERN( TEXT( "Bird Flock" ), STAT_SlashBirdFlock, STATGROUP_Slash, SLASH_API );
+
+/* Per frame counters */
+DECLARE_DWORD_COUNTER_STAT_EXTERN( TEXT( "Enemies Patrolling" ), STAT_SlashEnemiesPatrolling, STATGROUP_Slash, SLASH_API );
+DECLARE_DWORD_COUNTER_STAT_EXTERN( TEXT( "Enemies Chasing" ), STAT_SlashEnemiesChasing, STATGROUP_Slash, SLASH_API );
+DECLARE_DWORD_COUNTER_STAT_EXTERN( TEXT( "Enemies Attacking" ), STAT_SlashEnemiesAttacking, STATGROUP_Slash, SLASH_API );
+DECLARE_DWORD_COUNTER_STAT_EXTERN( TEXT( "Enemies Engaged" ), STAT_SlashEnemiesEngaged, STATGROUP_Slash, SLASH_API );
+DECLARE_DWORD_COUNTER_STAT_EXTERN( TEXT( "Enemies Dead" ), STAT_SlashEnemiesDead, STATGROUP_Slash, SLASH_API );
+DECLARE_DWORD_COUNTER_STAT_EXTERN( TEXT( "Weapon Traces" ), STAT_SlashWeaponTraces, STATGROUP_Slash, SLASH_API );
+DECLARE_DWORD_COUNTER_STAT_EXTERN( TEXT( "Hits Applied" ), STAT_SlashHitsApplied, STATGROUP_Slash, SLASH_API );
+
+/* Running totals */
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN( TEXT( "Treasures Spawned" ), STAT_SlashTreasuresSpawned, STATGROUP_Slash, SLASH_API );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN( TEXT( "Crowd Proxies" ), STAT_SlashCrowdProxies, STATGROUP_Slash, SLASH_API );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN( TEXT( "Pending Weapon Spawns" ), STAT_SlashPendingWeaponSpawns, STATGROUP_Slash, SLASH_API );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN( TEXT( "Projectiles In Flight" ), STAT_SlashProjectilesInFlight, STATGROUP_Slash, SLASH_API );
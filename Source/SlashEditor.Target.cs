@@ -10,6 +10,8 @@ public class SlashEditorTarget : TargetRules
 		Type = TargetType.Editor;
 		DefaultBuildSettings = BuildSettingsVersion.V2;
 
+		bWithPushModel = true;
+
 		ExtraModuleNames.AddRange( new string[] { "Slash" } );
 	}
 }